@@ -67,14 +67,12 @@ void Core::addData(const VectorXd& x, double y)
     const unsigned D = X.rows();
     const unsigned N = X.cols();
 
-    MatrixXd newX(D, N + 1);
-    newX.block(0, 0, D, N) = X;
-    newX.col(N)            = x;
-    this->X                = newX;
-
-    VectorXd newY(this->y.rows() + 1);
-    newY << this->y, y;
-    this->y = newY;
+    // Each addition reallocates and copies the data (O(ND)), which is fine for the few points of this demo
+    this->X.conservativeResize(D, N + 1);
+    this->X.col(N) = x;
+
+    this->y.conservativeResize(N + 1);
+    this->y(N) = y;
 }
 
 double Core::evaluateObjectiveFunction(Eigen::VectorXd x) const
@@ -6,6 +6,7 @@
 #include <QFileDialog>
 #include <QFutureWatcher>
 #include <QLabel>
+#include <QMessageBox>
 #include <QProgressDialog>
 #include <QtConcurrent>
 #include <fstream>
@@ -201,8 +202,33 @@ void MainWindow::on_actionClear_all_data_triggered()
 
 void MainWindow::on_actionProceed_optimization_triggered()
 {
-    core.optimizer->SubmitFeedbackData(obtainSliderPosition());
+    // Proceed optimization step in the background; the current slider stays interactive until the next one is ready
+    ui->pushButton->setEnabled(false);
+    ui->actionProceed_optimization->setEnabled(false);
 
+    // The callback runs on the worker thread, so the widgets are updated on the main thread
+    const auto on_completed = [this]()
+    { QMetaObject::invokeMethod(this, "handleOptimizationStepFinished", Qt::QueuedConnection); };
+
+    m_pending_update = core.optimizer->SubmitFeedbackDataAsync(obtainSliderPosition(), 0, 0, 0, on_completed);
+}
+
+void MainWindow::handleOptimizationStepFinished()
+{
+    ui->pushButton->setEnabled(true);
+    ui->actionProceed_optimization->setEnabled(true);
+
+    // The callback is also called when the update has failed, in which case the previous slider is kept
+    try
+    {
+        m_pending_update.get();
+    }
+    catch (const std::exception& exception)
+    {
+        QMessageBox::warning(this, "Optimization failed", exception.what());
+    }
+
+    ui->horizontalSlider->setValue((ui->horizontalSlider->maximum() + ui->horizontalSlider->minimum()) / 2);
     for (auto widget : m_widgets)
     {
         widget->update();
@@ -217,13 +243,7 @@ void MainWindow::on_horizontalSlider_valueChanged(int /*value*/)
 
 void MainWindow::on_pushButton_clicked()
 {
-    core.optimizer->SubmitFeedbackData(obtainSliderPosition());
-
-    ui->horizontalSlider->setValue((ui->horizontalSlider->maximum() + ui->horizontalSlider->minimum()) / 2);
-    for (auto widget : m_widgets)
-    {
-        widget->update();
-    }
+    on_actionProceed_optimization_triggered();
 }
 
 void MainWindow::on_actionPrint_current_best_triggered()
@@ -3,6 +3,7 @@
 
 #include <QMainWindow>
 #include <array>
+#include <future>
 
 namespace Ui
 {
@@ -34,10 +35,15 @@ private slots:
 
     void on_actionPrint_current_best_triggered();
 
+    void handleOptimizationStepFinished();
+
 private:
     Ui::MainWindow* ui;
 
     std::array<MainWidget*, 4> m_widgets;
+
+    /// \brief The update submitted by `on_actionProceed_optimization_triggered`.
+    std::shared_future<void> m_pending_update;
 };
 
 #endif // MAINWINDOW_H
@@ -1,9 +1,7 @@
 #include <iostream>
+#include <sequential-line-search/executor.hpp>
 #include <sequential-line-search/sequential-line-search.hpp>
 #include <sequential-line-search/utils.hpp>
-#ifdef PARALLEL
-#include <parallel-util.hpp>
-#endif
 #include <timer.hpp>
 
 namespace
@@ -60,18 +58,20 @@ int main(int argc, char* argv[])
         {
             std::cout << "---- Iteration " << i + 1 << " ----" << std::endl;
 
-            constexpr double search_epsilon = 1e-05;
+            constexpr int num_slider_samples = 100001;
 
             // Search the best position in the current slider space
+            const Eigen::MatrixXd slider_samples = optimizer.SampleSlider(num_slider_samples);
+
             double max_slider_position = 0.0;
             double max_y               = -1e+10;
-            for (double slider_position = 0.0; slider_position <= 1.0; slider_position += search_epsilon)
+            for (int sample_index = 0; sample_index < num_slider_samples; ++sample_index)
             {
-                const double y = evaluateObjectiveFunction(optimizer.CalcPointFromSliderPosition(slider_position));
+                const double y = evaluateObjectiveFunction(slider_samples.col(sample_index));
                 if (y > max_y)
                 {
                     max_y               = y;
-                    max_slider_position = slider_position;
+                    max_slider_position = static_cast<double>(sample_index) / (num_slider_samples - 1);
                 }
             }
 
@@ -100,7 +100,7 @@ int main(int argc, char* argv[])
     };
 
 #ifdef PARALLEL
-    parallelutil::queue_based_parallel_for(n_trials, perform_test);
+    sequential_line_search::ParallelFor(sequential_line_search::GetDefaultExecutor().get(), n_trials, perform_test);
 #else
     for (unsigned trial_index = 0; trial_index < n_trials; ++trial_index)
     {
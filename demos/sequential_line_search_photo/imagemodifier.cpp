@@ -2,7 +2,7 @@
 #include <cassert>
 #include <cmath>
 #include <enhancer/enhancer.hpp>
-#include <parallel-util.hpp>
+#include <sequential-line-search/executor.hpp>
 
 namespace ImageModifier
 {
@@ -48,7 +48,16 @@ namespace ImageModifier
             newImg.setPixel(x, y, new_rgb);
         };
 
-        parallelutil::parallel_for_2d(w, h, changePixelColor);
+        // Rows are processed in parallel on the persistent pool shared with the optimizer
+        auto changeRowColors = [&](const int y)
+        {
+            for (int x = 0; x < w; ++x)
+            {
+                changePixelColor(x, y);
+            }
+        };
+
+        sequential_line_search::ParallelFor(sequential_line_search::GetDefaultExecutor().get(), h, changeRowColors);
 
         return newImg;
     }
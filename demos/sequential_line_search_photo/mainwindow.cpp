@@ -7,6 +7,7 @@
 #include <QDir>
 #include <QImage>
 #include <QLabel>
+#include <QMessageBox>
 #include <QTimer>
 #include <enhancer/enhancerwidget.hpp>
 #include <iostream>
@@ -164,8 +165,31 @@ void MainWindow::on_actionClear_all_data_triggered()
 
 void MainWindow::on_actionProceed_optimization_triggered()
 {
-    // Proceed optimization step
-    core.optimizer->SubmitFeedbackData(obtainSliderPosition());
+    // Proceed optimization step in the background; the current slider stays interactive until the next one is ready
+    ui->pushButton->setEnabled(false);
+    ui->actionProceed_optimization->setEnabled(false);
+
+    // The callback runs on the worker thread, so the widgets are updated on the main thread
+    const auto on_completed = [this]()
+    { QMetaObject::invokeMethod(this, "handleOptimizationStepFinished", Qt::QueuedConnection); };
+
+    m_pending_update = core.optimizer->SubmitFeedbackDataAsync(obtainSliderPosition(), 0, 0, 0, on_completed);
+}
+
+void MainWindow::handleOptimizationStepFinished()
+{
+    ui->pushButton->setEnabled(true);
+    ui->actionProceed_optimization->setEnabled(true);
+
+    // The callback is also called when the update has failed, in which case the previous slider is kept
+    try
+    {
+        m_pending_update.get();
+    }
+    catch (const std::exception& exception)
+    {
+        QMessageBox::warning(this, "Optimization failed", exception.what());
+    }
 
     // Damp data
     core.optimizer->DampData(DirectoryUtility::getTemporaryDirectory());
@@ -3,6 +3,7 @@
 
 #include <QMainWindow>
 #include <array>
+#include <future>
 
 class QSlider;
 class MainWidget;
@@ -35,6 +36,7 @@ private slots:
     void on_pushButton_clicked();
     void on_actionPrint_current_best_triggered();
     void on_actionExport_photos_on_slider_triggered();
+    void handleOptimizationStepFinished();
 
 private:
     Ui::MainWindow*           ui;
@@ -45,6 +47,9 @@ private:
     // 2: m (mean)
     // 3: s (stdev)
     std::array<MainWidget*, 4> m_widgets;
+
+    /// \brief The update submitted by `on_actionProceed_optimization_triggered`.
+    std::shared_future<void> m_pending_update;
 };
 
 #endif // MAINWINDOW_H
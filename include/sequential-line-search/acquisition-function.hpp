@@ -3,6 +3,9 @@
 
 #include <Eigen/Core>
 #include <memory>
+#include <random>
+#include <sequential-line-search/cancellation-token.hpp>
+#include <sequential-line-search/executor.hpp>
 #include <sequential-line-search/regressor.hpp>
 #include <vector>
 
@@ -12,14 +15,37 @@ namespace sequential_line_search
     {
         ExpectedImprovement,
         GaussianProcessUpperConfidenceBound,
+        ThompsonSampling,
     };
 
     namespace acquisition_func
     {
+        /// \brief State carried over between successive acquisition searches for warm-starting them.
+        ///
+        /// \details The posterior changes only slightly between iterations, so the local maxima found in the previous
+        /// search, the incumbent, and the data points are good starting points for the next search. This is used only
+        /// by the multi-start search (i.e., when `SEQUENTIAL_LINE_SEARCH_USE_PARALLELIZED_MULTI_START_SEARCH` is
+        /// enabled); the DIRECT-based search does not take starting points.
+        struct WarmStartState
+        {
+            /// \brief The local maxima found in the previous search, sorted by their values in descending order.
+            std::vector<Eigen::VectorXd> local_maxima;
+
+            /// \brief The fraction of starts that are initialized randomly for exploration.
+            double random_start_fraction = 0.25;
+
+            /// \brief The maximum number of local maxima kept for the next search.
+            unsigned num_kept_local_maxima = 10;
+        };
+
         /// \brief Calculate the value of the acquisition function value.
         ///
         /// \param function_type Type of the acquisition function.
         ///
+        /// \details Thompson sampling maximizes a randomly drawn posterior function, which is not reproducible from a
+        /// single point. For `AcquisitionFuncType::ThompsonSampling`, this function returns the expectation of the
+        /// sampled function (i.e., the predictive mean) instead.
+        ///
         /// \param gaussian_process_upper_confidence_bound_hyperparam The hyperparameter in the GP-UCB algorithm, which
         /// controls the trade-off of exploration and exploitation. If the acquisition function is not GP-UCB, this
         /// value will not be used.
@@ -37,6 +63,29 @@ namespace sequential_line_search
                                        const AcquisitionFuncType func_type,
                                        const double gaussian_process_upper_confidence_bound_hyperparam = 1.0);
 
+        /// \brief Calculate the acquisition values of multiple points (stored as columns) at once.
+        ///
+        /// \details The kernel vectors of all the points are solved against the kernel matrix in a single call, which
+        /// is considerably cheaper than calling `CalcAcquisitionValue` for each point. If `derivatives` is not null,
+        /// the derivatives at the points are also calculated and stored as columns.
+        Eigen::VectorXd
+        CalcAcquisitionValuesInBatch(const Regressor&          regressor,
+                                     const Eigen::MatrixXd&    X,
+                                     const AcquisitionFuncType func_type,
+                                     const double              gaussian_process_upper_confidence_bound_hyperparam = 1.0,
+                                     Eigen::MatrixXd*          derivatives = nullptr);
+
+        /// \brief Calculate the acquisition values of multiple points from their predictive means and standard
+        /// deviations, which are calculated by, e.g., `Regressor::PredictFromLargeKStar`.
+        ///
+        /// \details The regressor is used only for determining the current best value in the expected improvement.
+        Eigen::VectorXd
+        CalcAcquisitionValuesFromPredictions(const Regressor&          regressor,
+                                             const Eigen::VectorXd&    mu,
+                                             const Eigen::VectorXd&    sigma,
+                                             const AcquisitionFuncType func_type,
+                                             const double gaussian_process_upper_confidence_bound_hyperparam = 1.0);
+
         /// \param num_global_search_iters The number of trials of acquisition value maximization. Specifying a large
         /// number is helpful for finding the global maximizer while it increases the computational cost proportional to
         /// it.
@@ -44,11 +93,40 @@ namespace sequential_line_search
         /// \param gaussian_process_upper_confidence_bound_hyperparam The hyperparameter in the GP-UCB algorithm, which
         /// controls the trade-off of exploration and exploitation. If the acquisition function is not GP-UCB, this
         /// value will not be used.
+        ///
+        /// \param warm_start_state When this is not null, the search is seeded by the local maxima kept in the state
+        /// (as well as the incumbent and the data points), and the state is updated with the local maxima found in
+        /// this search. See `WarmStartState`.
+        ///
+        /// \param lower The lower bound of the search box. When this is empty, the search is performed in the whole
+        /// search space, [0, 1]^{D}. Restricting the box is useful for trust-region strategies (see `TrustRegion`).
+        ///
+        /// \param upper The upper bound of the search box. Should be specified together with `lower`.
+        ///
+        /// \param executor The executor that the evaluations of the multi-start search are split over. When this is
+        /// null, the default one (see `GetDefaultExecutor`) is used.
+        ///
+        /// \param cancellation_token If not null and set, the search stops within one evaluation of the acquisition
+        /// function and returns an unspecified point (see `CancellationToken`). The warm-start state is then left as
+        /// it is.
+        ///
+        /// \param random_engine The random number generator that the seed of the posterior function sample is drawn
+        /// from when Thompson sampling is used. When this is null, a generator local to the calling thread, seeded
+        /// nondeterministically, is used. This is not used by the other acquisition functions.
+        ///
+        /// \details When Thompson sampling is used, a single posterior function is drawn by `PosteriorFunctionSample`
+        /// and then maximized; each evaluation in the search costs O(m d) regardless of the number of data points.
         Eigen::VectorXd FindNextPoint(const Regressor&          regressor,
                                       const unsigned            num_global_search_iters = 100,
                                       const unsigned            num_local_search_iters  = 50,
                                       const AcquisitionFuncType func_type = AcquisitionFuncType::ExpectedImprovement,
-                                      const double gaussian_process_upper_confidence_bound_hyperparam = 1.0);
+                                      const double    gaussian_process_upper_confidence_bound_hyperparam = 1.0,
+                                      WarmStartState* warm_start_state                                   = nullptr,
+                                      const Eigen::VectorXd&   lower                                     = {},
+                                      const Eigen::VectorXd&   upper                                     = {},
+                                      Executor*                executor                                  = nullptr,
+                                      const CancellationToken* cancellation_token                        = nullptr,
+                                      std::mt19937*            random_engine                             = nullptr);
 
         /// \brief Find the next n sampled points that should be observed.
         ///
@@ -61,6 +139,9 @@ namespace sequential_line_search
         /// optimization of computer models. Institute of Mathematical Statistics Lecture Notes - Monograph Series,
         /// 1998: 11-25 (1998). DOI: https://doi.org/10.1214/lnms/1215456182
         ///
+        /// When Thompson sampling is used, the points are instead determined by maximizing independent posterior
+        /// function samples, one sample per point, which does not require any variance update.
+        ///
         /// \param num_points The number of the sampled points.
         ///
         /// \param num_global_search_iters The number of trials of acquisition value maximization. Specifying a large
@@ -70,13 +151,25 @@ namespace sequential_line_search
         /// \param gaussian_process_upper_confidence_bound_hyperparam The hyperparameter in the GP-UCB algorithm, which
         /// controls the trade-off of exploration and exploitation. If the acquisition function is not GP-UCB, this
         /// value will not be used.
+        ///
+        /// \param executor The executor that the evaluations of the multi-start search are split over. When this is
+        /// null, the default one (see `GetDefaultExecutor`) is used.
+        ///
+        /// \param cancellation_token If not null and set, the search stops within one evaluation of the acquisition
+        /// function and returns unspecified points, possibly fewer than `num_points` (see `CancellationToken`).
+        ///
+        /// \param random_engine The random number generator that the seeds of the posterior function samples are drawn
+        /// from when Thompson sampling is used. When this is null, a generator local to the calling thread is used.
         std::vector<Eigen::VectorXd>
         FindNextPoints(const Regressor&          regressor,
                        const unsigned            num_points,
                        const unsigned            num_global_search_iters = 100,
                        const unsigned            num_local_search_iters  = 50,
                        const AcquisitionFuncType func_type               = AcquisitionFuncType::ExpectedImprovement,
-                       const double              gaussian_process_upper_confidence_bound_hyperparam = 1.0);
+                       const double              gaussian_process_upper_confidence_bound_hyperparam = 1.0,
+                       Executor*                 executor                                           = nullptr,
+                       const CancellationToken*  cancellation_token                                 = nullptr,
+                       std::mt19937*             random_engine                                      = nullptr);
     } // namespace acquisition_func
 } // namespace sequential_line_search
 
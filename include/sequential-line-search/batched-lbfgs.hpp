@@ -0,0 +1,56 @@
+#ifndef SEQUENTIAL_LINE_SEARCH_BATCHED_LBFGS_HPP
+#define SEQUENTIAL_LINE_SEARCH_BATCHED_LBFGS_HPP
+
+#include <Eigen/Core>
+#include <functional>
+#include <sequential-line-search/cancellation-token.hpp>
+
+namespace sequential_line_search
+{
+    /// \brief A function type for objectives that evaluate multiple points at once.
+    ///
+    /// \details The points are stored as the columns of the first argument. The function returns the values at the
+    /// points and, if the second argument is not null, writes the derivatives at the points into it as columns.
+    using BatchObjectiveFunc = std::function<Eigen::VectorXd(const Eigen::MatrixXd&, Eigen::MatrixXd*)>;
+
+    namespace batched_lbfgs
+    {
+        struct Result
+        {
+            /// \brief Found local maximizers, one column per starting point.
+            Eigen::MatrixXd X;
+
+            /// \brief Objective values at the found local maximizers.
+            Eigen::VectorXd values;
+        };
+
+        /// \brief Maximize a box-constrained objective from multiple starting points by projected L-BFGS.
+        ///
+        /// \details All the starting points are advanced in lockstep: each iteration (and each trial of the
+        /// backtracking line search) evaluates every still-active start in a single call of the objective, so that the
+        /// objective can share its expensive parts (e.g., kernel matrix solves) among the starts. Starts that have
+        /// converged are masked out from subsequent calls.
+        ///
+        /// \param X_ini Starting points, one per column.
+        ///
+        /// \param max_iters The maximum number of quasi-Newton iterations for each start.
+        ///
+        /// \param memory_size The number of correction pairs kept for approximating the inverse Hessian.
+        ///
+        /// \param tolerance The tolerance for the projected gradient and the relative changes of the objective value
+        /// and the solution.
+        ///
+        /// \param cancellation_token If not null and set, the iterations stop before the next call of the objective,
+        /// and the points reached so far are returned.
+        Result Maximize(const BatchObjectiveFunc& objective,
+                        const Eigen::MatrixXd&    X_ini,
+                        const Eigen::VectorXd&    lower,
+                        const Eigen::VectorXd&    upper,
+                        const unsigned            max_iters,
+                        const unsigned            memory_size        = 6,
+                        const double              tolerance          = 1e-06,
+                        const CancellationToken*  cancellation_token = nullptr);
+    } // namespace batched_lbfgs
+} // namespace sequential_line_search
+
+#endif // SEQUENTIAL_LINE_SEARCH_BATCHED_LBFGS_HPP
@@ -0,0 +1,53 @@
+#ifndef SEQUENTIAL_LINE_SEARCH_BINARY_IO_HPP
+#define SEQUENTIAL_LINE_SEARCH_BINARY_IO_HPP
+
+#include <Eigen/Core>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <sequential-line-search/preference.hpp>
+#include <string>
+#include <vector>
+
+namespace sequential_line_search
+{
+    /// \brief Utilities for the binary snapshot format of the optimizers.
+    ///
+    /// \details All the values are written in little-endian regardless of the host. A double is written as its raw
+    /// IEEE 754 bits, so that values are restored exactly. A vector or a matrix is written as its size(s) followed by
+    /// its elements in column-major order. The readers throw `std::runtime_error` when the stream ends prematurely or
+    /// contains an unexpected value, including a size that exceeds the rest of the stream (checked before allocating).
+    namespace binary_io
+    {
+        /// \brief Write a header consisting of a four-character magic string and a format version.
+        void WriteHeader(std::ostream& stream, const std::string& magic, const std::uint32_t version);
+
+        /// \brief Read a header and check its magic string.
+        ///
+        /// \return The format version, which is checked to be no larger than `latest_version`.
+        std::uint32_t ReadHeader(std::istream& stream, const std::string& magic, const std::uint32_t latest_version);
+
+        void WriteUInt32(std::ostream& stream, const std::uint32_t value);
+        void WriteUInt64(std::ostream& stream, const std::uint64_t value);
+        void WriteInt32(std::ostream& stream, const std::int32_t value);
+        void WriteBool(std::ostream& stream, const bool value);
+        void WriteDouble(std::ostream& stream, const double value);
+        void WriteVector(std::ostream& stream, const Eigen::VectorXd& vector);
+        void WriteMatrix(std::ostream& stream, const Eigen::MatrixXd& matrix);
+        void WritePreferences(std::ostream& stream, const std::vector<Preference>& preferences);
+
+        std::uint32_t           ReadUInt32(std::istream& stream);
+        std::uint64_t           ReadUInt64(std::istream& stream);
+        std::int32_t            ReadInt32(std::istream& stream);
+        bool                    ReadBool(std::istream& stream);
+        double                  ReadDouble(std::istream& stream);
+        Eigen::VectorXd         ReadVector(std::istream& stream);
+        Eigen::MatrixXd         ReadMatrix(std::istream& stream);
+        std::vector<Preference> ReadPreferences(std::istream& stream);
+
+        /// \brief Read an enum value written by `WriteUInt32` and check that it is less than `num_values`.
+        std::uint32_t ReadEnum(std::istream& stream, const std::uint32_t num_values);
+    } // namespace binary_io
+} // namespace sequential_line_search
+
+#endif // SEQUENTIAL_LINE_SEARCH_BINARY_IO_HPP
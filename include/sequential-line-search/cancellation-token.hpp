@@ -0,0 +1,22 @@
+#ifndef SEQUENTIAL_LINE_SEARCH_CANCELLATION_TOKEN_HPP
+#define SEQUENTIAL_LINE_SEARCH_CANCELLATION_TOKEN_HPP
+
+#include <atomic>
+
+namespace sequential_line_search
+{
+    /// \brief A flag for abandoning an in-flight computation from another thread.
+    ///
+    /// \details The MAP estimations and the acquisition function maximization take a pointer to a token (null means
+    /// that the computation cannot be cancelled) and check it in every evaluation of their objectives. Once the token
+    /// is set, they stop within one evaluation and return an unspecified (but valid) result, which the caller is
+    /// expected to discard.
+    using CancellationToken = std::atomic<bool>;
+
+    inline bool IsCancelled(const CancellationToken* cancellation_token)
+    {
+        return cancellation_token != nullptr && cancellation_token->load(std::memory_order_relaxed);
+    }
+} // namespace sequential_line_search
+
+#endif // SEQUENTIAL_LINE_SEARCH_CANCELLATION_TOKEN_HPP
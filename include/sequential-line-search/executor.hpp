@@ -0,0 +1,176 @@
+#ifndef SEQUENTIAL_LINE_SEARCH_EXECUTOR_HPP
+#define SEQUENTIAL_LINE_SEARCH_EXECUTOR_HPP
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+namespace sequential_line_search
+{
+    /// \brief Interface of the place where the library runs its background and parallel computations.
+    ///
+    /// \details The optimizers, the regressors, and the acquisition function maximization submit their tasks to an
+    /// executor instead of creating threads by themselves. By default, they share the persistent pool returned by
+    /// `GetDefaultExecutor`; an embedding application can pass its own implementation (e.g., one that forwards the
+    /// tasks to its job system) to control exactly where the library runs.
+    class Executor
+    {
+    public:
+        virtual ~Executor() {}
+
+        /// \brief Run a task at some point. The task must not throw. Tasks may be submitted from within tasks.
+        virtual void Submit(std::function<void()> task) = 0;
+
+        /// \brief The number of tasks that can run in parallel, used for deciding how finely work is split.
+        virtual int GetConcurrency() const = 0;
+    };
+
+    /// \brief Get the process-wide pool of persistent worker threads (one per hardware thread), created on first use.
+    std::shared_ptr<Executor> GetDefaultExecutor();
+
+    /// \brief Call `func(i)` for i = 0, ..., num_iters - 1 in parallel and block until all the calls finish.
+    ///
+    /// \details The calling thread takes iterations as well, so this can be called from within a task of the same
+    /// executor without deadlocking. If `executor` is null, the iterations run sequentially on the calling thread. If
+    /// some calls throw, the first exception is rethrown after all the calls finish.
+    void ParallelFor(Executor* executor, const int num_iters, const std::function<void(int)>& func);
+
+    /// \brief Run a function on an executor and return its future.
+    ///
+    /// \details Unlike `ExecutorTask`, waiting for the future from within a task of the same executor can deadlock when
+    /// all the workers are waiting.
+    template <typename Func>
+    std::shared_future<typename std::result_of<Func()>::type> ExecuteAsync(Executor& executor, Func func)
+    {
+        using Result = typename std::result_of<Func()>::type;
+
+        const auto task = std::make_shared<std::packaged_task<Result()>>(std::move(func));
+
+        executor.Submit([task]() { (*task)(); });
+
+        return task->get_future().share();
+    }
+
+    /// \brief A function submitted to an executor, whose result can be waited for from any thread.
+    ///
+    /// \details If no worker has started the function when it is waited for, the waiting thread runs it instead, so
+    /// waiting from within a task of the same executor never deadlocks. Copies share the same state.
+    template <typename Result>
+    class ExecutorTask
+    {
+    public:
+        /// \brief Construct an invalid task.
+        ExecutorTask() {}
+
+        ExecutorTask(Executor& executor, std::function<Result()> func) : m_state(std::make_shared<State>())
+        {
+            m_state->func = std::move(func);
+
+            const std::shared_ptr<State> state = m_state;
+            executor.Submit([state]() { Run(*state); });
+        }
+
+        bool IsValid() const { return m_state != nullptr; }
+
+        bool IsFinished() const
+        {
+            std::lock_guard<std::mutex> lock(m_state->mutex);
+            return m_state->is_finished;
+        }
+
+        /// \brief Wait for the function to finish (running it if no one has started it) without rethrowing.
+        void Wait() const
+        {
+            Run(*m_state);
+
+            std::unique_lock<std::mutex> lock(m_state->mutex);
+            m_state->condition.wait(lock, [&]() { return m_state->is_finished; });
+        }
+
+        /// \brief Wait for the result. An exception thrown by the function is rethrown.
+        const Result& Get() const
+        {
+            Wait();
+
+            if (m_state->exception)
+            {
+                std::rethrow_exception(m_state->exception);
+            }
+            return m_state->result;
+        }
+
+        /// \brief Drop the function if it has not been started yet; a default-constructed result is then returned.
+        void Cancel() const
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_state->mutex);
+                if (m_state->is_started)
+                {
+                    return;
+                }
+                m_state->is_started  = true;
+                m_state->is_finished = true;
+                m_state->func        = nullptr;
+            }
+            m_state->condition.notify_all();
+        }
+
+    private:
+        struct State
+        {
+            std::mutex              mutex;
+            std::condition_variable condition;
+
+            std::function<Result()> func;
+
+            bool is_started  = false;
+            bool is_finished = false;
+
+            Result             result;
+            std::exception_ptr exception;
+        };
+
+        std::shared_ptr<State> m_state;
+
+        /// \brief Run the function unless someone has already started it.
+        static void Run(State& state)
+        {
+            std::function<Result()> func;
+            {
+                std::lock_guard<std::mutex> lock(state.mutex);
+                if (state.is_started)
+                {
+                    return;
+                }
+                state.is_started = true;
+                func.swap(state.func);
+            }
+
+            Result             result;
+            std::exception_ptr exception;
+            try
+            {
+                result = func();
+            }
+            catch (...)
+            {
+                exception = std::current_exception();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(state.mutex);
+                state.result      = std::move(result);
+                state.exception   = exception;
+                state.is_finished = true;
+            }
+            state.condition.notify_all();
+        }
+    };
+} // namespace sequential_line_search
+
+#endif // SEQUENTIAL_LINE_SEARCH_EXECUTOR_HPP
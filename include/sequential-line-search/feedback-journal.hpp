@@ -0,0 +1,80 @@
+#ifndef SEQUENTIAL_LINE_SEARCH_FEEDBACK_JOURNAL_HPP
+#define SEQUENTIAL_LINE_SEARCH_FEEDBACK_JOURNAL_HPP
+
+#include <Eigen/Core>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace sequential_line_search
+{
+    class PreferenceDataManager;
+
+    /// \brief Policy for flushing the journal to the storage device (i.e., calling fsync).
+    enum class JournalSyncPolicy
+    {
+        EveryRecord,   /// Sync after every record; no acknowledged feedback is lost even on a power failure.
+        EveryNRecords, /// Sync after every `sync_interval` records; at most that many records can be lost.
+        OnClose,       /// Sync only when the journal is closed; records survive a crash of the process but not
+                       /// necessarily a crash of the OS.
+    };
+
+    /// \brief A preferential observation stored in a journal.
+    struct FeedbackRecord
+    {
+        Eigen::VectorXd              x_preferable;
+        std::vector<Eigen::VectorXd> xs_other;
+    };
+
+    /// \brief Append-only binary journal of preferential observations.
+    ///
+    /// \details The file starts with a header (see `binary_io::WriteHeader`) followed by records. Each record
+    /// consists of the number of dimensions and the number of points (both uint32), the points (doubles, the
+    /// preferable one first), and the CRC-32 checksum of all the preceding bytes of the record. All the values are
+    /// little-endian. A record is written by a single write call, and a torn or corrupted record at the end of the file
+    /// (e.g., due to a crash during the write) is detected by the checksum and ignored by `Read`.
+    class FeedbackJournal
+    {
+    public:
+        /// \brief Open a journal for appending. The file is created if it does not exist.
+        ///
+        /// \param sync_interval The number of records between syncs. Used only by `JournalSyncPolicy::EveryNRecords`.
+        FeedbackJournal(const std::string&      file_path,
+                        const JournalSyncPolicy sync_policy   = JournalSyncPolicy::EveryRecord,
+                        const int               sync_interval = 1);
+
+        /// \brief Sync and close the journal.
+        ~FeedbackJournal();
+
+        FeedbackJournal(const FeedbackJournal&) = delete;
+        FeedbackJournal& operator=(const FeedbackJournal&) = delete;
+
+        void Append(const Eigen::VectorXd& x_preferable, const std::vector<Eigen::VectorXd>& xs_other);
+
+        /// \brief Flush the appended records to the storage device regardless of the policy. Throws
+        /// `std::runtime_error` on failure.
+        void Sync();
+
+        /// \brief Read all the valid records of a journal.
+        ///
+        /// \details Reading stops at the first torn or corrupted record. Throws `std::runtime_error` if the file
+        /// cannot be opened or is not a journal.
+        static std::vector<FeedbackRecord> Read(const std::string& file_path);
+
+    private:
+        std::FILE* m_file;
+
+        const JournalSyncPolicy m_sync_policy;
+        const int               m_sync_interval;
+
+        int m_num_unsynced_records;
+    };
+
+    /// \brief Add the records to the data in a single pass, reserving the storage beforehand.
+    ///
+    /// \details Close points are merged as in `SubmitFeedbackData`, so that the resulting data is the same as the one
+    /// built by submitting the records one by one.
+    void AddFeedbackRecords(const std::vector<FeedbackRecord>& records, PreferenceDataManager* data);
+} // namespace sequential_line_search
+
+#endif // SEQUENTIAL_LINE_SEARCH_FEEDBACK_JOURNAL_HPP
@@ -2,17 +2,64 @@
 #define SEQUENTIAL_LINE_SEARCH_GAUSSIAN_PROCESS_REGRESSOR_HPP
 
 #include <Eigen/Core>
+#include <cmath>
+#include <memory>
+#include <sequential-line-search/cancellation-token.hpp>
+#include <sequential-line-search/executor.hpp>
 #include <sequential-line-search/regressor.hpp>
 
 namespace sequential_line_search
 {
+    /// \brief Log-normal priors on the hyperparameters, which regularize the likelihood in the MAP estimation.
+    ///
+    /// \details Each prior is specified by the mean (`mu`) and the variance (`sigma_squared`) of the logarithm of the
+    /// hyperparameter. The medians of the priors (i.e., exp(mu)) are also used as the initial solution.
+    struct GaussianProcessHyperparamsPrior
+    {
+        /// \brief When this is false, the priors are not used for regularization (i.e., the hyperparameters are set via
+        /// maximum likelihood estimation).
+        bool use_log_normal_prior = true;
+
+        double signal_var_mu            = std::log(0.500);
+        double signal_var_sigma_squared = 0.50;
+
+        double noise_level_mu            = std::log(1e-04);
+        double noise_level_sigma_squared = 0.50;
+
+        double length_scale_mu            = std::log(0.500);
+        double length_scale_sigma_squared = 0.50;
+    };
+
+    /// \brief Statistics of a MAP estimation of the hyperparameters.
+    struct MapEstimationStats
+    {
+        /// \brief The number of objective evaluations in the global search.
+        unsigned num_global_search_evaluations = 0;
+
+        /// \brief The number of objective evaluations in the local (gradient-based) refinement.
+        unsigned num_local_search_evaluations = 0;
+    };
+
+    /// \details Instances do not share any state, so independent regressors can be constructed (i.e., fit) on different
+    /// threads concurrently.
     class GaussianProcessRegressor : public Regressor
     {
     public:
         /// \details Hyperparameters will be set via MAP estimation.
-        GaussianProcessRegressor(const Eigen::MatrixXd& X,
-                                 const Eigen::VectorXd& y,
-                                 const KernelType       kernel_type = KernelType::ArdMatern52Kernel);
+        ///
+        /// \param prior The priors on the hyperparameters used in the MAP estimation.
+        ///
+        /// \param executor The executor that the MAP estimation runs on. When this is null, the default one (see
+        /// `GetDefaultExecutor`) is used.
+        ///
+        /// \param cancellation_token If not null and set, the MAP estimation stops within one evaluation of its
+        /// objective, leaving the regressor valid but not fitted (see `CancellationToken`).
+        GaussianProcessRegressor(const Eigen::MatrixXd&                 X,
+                                 const Eigen::VectorXd&                 y,
+                                 const KernelType                       kernel_type = KernelType::ArdMatern52Kernel,
+                                 const GaussianProcessHyperparamsPrior& prior       = GaussianProcessHyperparamsPrior(),
+                                 const std::shared_ptr<Executor>&       executor    = nullptr,
+                                 const CancellationToken*               cancellation_token = nullptr);
 
         /// \details Specified hyperparameters will be used.
         GaussianProcessRegressor(const Eigen::MatrixXd& X,
@@ -27,6 +74,14 @@ namespace sequential_line_search
         Eigen::VectorXd PredictMuDerivative(const Eigen::VectorXd& x) const override;
         Eigen::VectorXd PredictSigmaDerivative(const Eigen::VectorXd& x) const override;
 
+        Eigen::MatrixXd SolveLargeKY(const Eigen::MatrixXd& B) const override { return m_K_y_inv * B; }
+
+        /// \brief Append a data point while keeping the hyperparameters.
+        ///
+        /// \details The inverse of the kernel matrix is extended by the block inversion formula using the Schur
+        /// complement of the new point, which costs O(N^2) instead of the O(N^3) of inverting the matrix again.
+        void AddDataPoint(const Eigen::VectorXd& x, const double y);
+
         // Can be derived after MAP
         Eigen::MatrixXd m_K_y;
         Eigen::MatrixXd m_K_y_inv;
@@ -38,8 +93,13 @@ namespace sequential_line_search
         const Eigen::VectorXd& GetKernelHyperparams() const override { return m_kernel_hyperparams; }
         double                 GetNoiseHyperparam() const override { return m_noise_hyperparam; }
 
+        /// \brief Get the statistics of the MAP estimation. All zero if the hyperparameters were specified directly.
+        const MapEstimationStats& GetMapEstimationStats() const { return m_map_estimation_stats; }
+
     private:
-        void PerformMapEstimation();
+        MapEstimationStats PerformMapEstimation(const GaussianProcessHyperparamsPrior& prior,
+                                                Executor*                              executor,
+                                                const CancellationToken*               cancellation_token);
 
         /// \brief Data points.
         Eigen::MatrixXd m_X;
@@ -56,6 +116,8 @@ namespace sequential_line_search
         ///
         /// \details Derived from MAP or specified directly.
         double m_noise_hyperparam;
+
+        MapEstimationStats m_map_estimation_stats;
     };
 } // namespace sequential_line_search
 
@@ -0,0 +1,44 @@
+#ifndef SEQUENTIAL_LINE_SEARCH_POSTERIOR_FUNCTION_SAMPLE_HPP
+#define SEQUENTIAL_LINE_SEARCH_POSTERIOR_FUNCTION_SAMPLE_HPP
+
+#include <Eigen/Core>
+#include <sequential-line-search/regressor.hpp>
+
+namespace sequential_line_search
+{
+    /// \brief A function drawn from the posterior distribution of a fitted regressor.
+    ///
+    /// \details The kernel is approximated by random Fourier features [Rahimi and Recht, NIPS 2007], and the sample is
+    /// drawn from the Bayesian linear regression posterior of the feature weights. Once drawn, evaluating the sample
+    /// (and its derivative) costs O(m d), where m is the number of features, regardless of the number of data points.
+    /// This is the building block of Thompson sampling [Hernandez-Lobato et al., NIPS 2014].
+    class PosteriorFunctionSample
+    {
+    public:
+        /// \param num_features The number of random Fourier features. A larger number gives a more accurate kernel
+        /// approximation while the cost of drawing a sample grows cubically in it.
+        ///
+        /// \param seed The seed of the random number generator used for drawing the features and the weights.
+        PosteriorFunctionSample(const Regressor& regressor, const unsigned num_features, const unsigned seed);
+
+        double          Evaluate(const Eigen::VectorXd& x) const;
+        Eigen::VectorXd EvaluateDerivative(const Eigen::VectorXd& x) const;
+
+        /// \brief Evaluate the sample at multiple points (stored as columns) at once.
+        ///
+        /// \details If `derivatives` is not null, the derivatives at the points are also calculated.
+        Eigen::VectorXd EvaluateInBatch(const Eigen::MatrixXd& X, Eigen::MatrixXd* derivatives = nullptr) const;
+
+    private:
+        /// \brief Spectral frequencies (m x d).
+        Eigen::MatrixXd m_Omega;
+
+        /// \brief Phase offsets (m).
+        Eigen::VectorXd m_phases;
+
+        /// \brief Sampled feature weights (m), pre-multiplied by the feature normalization constant.
+        Eigen::VectorXd m_weights;
+    };
+} // namespace sequential_line_search
+
+#endif // SEQUENTIAL_LINE_SEARCH_POSTERIOR_FUNCTION_SAMPLE_HPP
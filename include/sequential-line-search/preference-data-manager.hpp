@@ -2,42 +2,155 @@
 #define SEQUENTIAL_LINE_SEARCH_PREFERENCE_DATA_MANAGER_HPP
 
 #include <Eigen/Core>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
 #include <sequential-line-search/preference.hpp>
+#include <sequential-line-search/retention-policy.hpp>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace sequential_line_search
 {
     /// \brief Utility class for managing preferential data observed during optimization.
+    ///
+    /// \details The data points are stored as the leading columns of a buffer whose capacity grows geometrically, so
+    /// that adding new points costs amortized O(d) instead of copying the whole history.
     class PreferenceDataManager
     {
     public:
+        PreferenceDataManager();
+
         /// \brief Add a new preference observation.
         ///
         /// \details If merge_close_points is true, this method will merge data points (including both existing and new
-        /// ones) that are sufficiently close to each other with the threshold of epsilon.
+        /// ones) that are sufficiently close to each other with the threshold of epsilon. Throws
+        /// `std::invalid_argument` if epsilon is not positive in that case.
         void AddNewPoints(const Eigen::VectorXd&              x_preferable,
                           const std::vector<Eigen::VectorXd>& xs_other,
                           const bool                          merge_close_points = true,
                           const double                        epsilon            = 1e-04);
 
+        /// \brief Reserve the storage for the given numbers of data points and preferential observations.
+        ///
+        /// \details This is useful for adding many observations at once (e.g., when replaying a log), as it avoids
+        /// repeated reallocations.
+        void Reserve(const int num_data_points, const int num_preferences = 0);
+
+        /// \brief Add many preference observations at once.
+        ///
+        /// \details The data points are appended in a single pass with the storage reserved beforehand, and the
+        /// indices in `D` (which refer to the columns of `X`) are offset accordingly. Close points are merged and the
+        /// retention policy is applied only once at the end. Throws `std::runtime_error` if the number of dimensions of
+        /// `X` differs from that of the existing data points, or if `D` contains an observation with less than two
+        /// points or an index out of range, and `std::invalid_argument` if epsilon is not positive while merging.
+        void AddData(const Eigen::MatrixXd&         X,
+                     const std::vector<Preference>& D,
+                     const bool                     merge_close_points = true,
+                     const double                   epsilon            = 1e-04);
+
+        /// \brief Add the data written by `PreferenceRegressor::DampData` (i.e., `X.csv` and `D.csv`).
+        ///
+        /// \details The files are parsed line by line and the data is added by `AddData`. Throws `std::runtime_error`
+        /// if a file cannot be opened or is malformed.
+        void ImportCsv(const std::string& directory_path, const std::string& prefix = "");
+
+        /// \brief Set the policy for bounding the number of data points.
+        ///
+        /// \details After new points are added (and merged), data points are dropped according to the policy until
+        /// the number of data points does not exceed `max_num_data_points`. The number can still exceed it when the
+        /// policy cannot drop any more points (e.g., when the last observation alone has more points). Throws
+        /// `std::invalid_argument` if `max_num_data_points` is not positive for a policy other than `KeepAll`.
+        void SetRetentionPolicy(const RetentionPolicy policy, const int max_num_data_points);
+
+        /// \brief Set the point from which `RetentionPolicy::DropDominatedFar` measures the distances, typically the
+        /// current maximizer of the surrogate model. If this is not set, the last selected data point is used.
+        void SetRetentionCenter(const Eigen::VectorXd& center) { m_retention_center = center; }
+
         /// \brief Get the data point that was selected in the last preferential data observation
         const Eigen::VectorXd GetLastSelectedDataPoint() const { return m_X.col(GetLastDataSample()[0]); }
 
         /// \brief Get the number of data points
-        int GetNumDataPoints() const { return m_X.cols(); }
+        int GetNumDataPoints() const { return m_num_data_points; }
 
         /// \brief Get the raw data points in a matrix format
-        const Eigen::MatrixXd& GetX() const { return m_X; }
+        ///
+        /// \details The returned object is a view of the internal storage, which is invalidated when new points are
+        /// added.
+        Eigen::Ref<const Eigen::MatrixXd> GetX() const { return m_X.leftCols(m_num_data_points); }
 
         /// \brief Get the list of preferential observations
         const std::vector<Preference>& GetD() const { return m_D; }
 
+        /// \brief Write the data and the retention policy in the binary snapshot format.
+        ///
+        /// \details See `binary_io` for the encoding. The hash grid is not written; it is rebuilt on the next addition.
+        void Save(std::ostream& stream) const;
+
+        /// \brief Restore a data manager written by `Save`.
+        static std::shared_ptr<PreferenceDataManager> Load(std::istream& stream);
+
     private:
         /// \brief Get the last preferential feedback data sample
         const Preference& GetLastDataSample() const { return m_D.back(); }
 
-        Eigen::MatrixXd         m_X;
+        /// \brief Make sure that the storage can hold the given number of data points.
+        void EnsureCapacity(const int num_dims, const int num_data_points);
+
+        /// \brief Merge the data points that are not indexed yet with any data points closer than epsilon.
+        ///
+        /// \details Each not-yet-indexed point is checked against the indexed points by the hash grid, and a close
+        /// pair is replaced by its midpoint (stored at the index of the indexed point). Since the indexed points are
+        /// kept free of close pairs, only the newly added points need to be checked. The merged points are removed by
+        /// compacting the storage and remapping the preferences once at the end.
+        void MergeClosePoints(const double epsilon);
+
+        /// \brief Find an indexed data point closer than epsilon to the given point. Returns -1 if none exists.
+        int FindIndexedClosePoint(const Eigen::VectorXd& x, const double epsilon) const;
+
+        /// \brief Index the data point by the hash grid.
+        void AddToGrid(const int index);
+
+        /// \brief Remove the data point from the hash grid.
+        void RemoveFromGrid(const int index);
+
+        /// \brief Clear the hash grid and re-index the first num_indexed_points data points.
+        void RebuildGrid(const int num_indexed_points);
+
+        /// \brief Drop data points according to `m_retention_policy`.
+        void ApplyRetentionPolicy();
+
+        /// \brief Remove the flagged data points and their references in the preferential observations.
+        ///
+        /// \details An observation whose preferred point is removed, or which has only one point left, is also
+        /// removed.
+        void RemoveDataPoints(const std::vector<bool>& is_removed);
+
+        /// \brief Remove the data points that are not referenced by any preferential observations.
+        void RemoveUnreferencedDataPoints();
+
+        /// \brief Replace the references to a data point by another data point in the preferential observations.
+        void ReplaceReferences(const unsigned index, const unsigned new_index);
+
+        /// \brief Storage of the data points. Only the first `m_num_data_points` columns are valid.
+        Eigen::MatrixXd m_X;
+        int             m_num_data_points;
+
+        /// \brief Capacity requested by `Reserve` before the number of dimensions is known.
+        int m_reserved_capacity;
+
+        /// \brief Uniform hash grid over the leading (at most three) coordinates with the cell size of epsilon. The
+        /// first `m_num_indexed_points` data points are registered, and they are free of close pairs.
+        std::unordered_map<std::uint64_t, std::vector<int>> m_grid;
+        double                                              m_grid_cell_size;
+        int                                                 m_num_indexed_points;
+
         std::vector<Preference> m_D;
+
+        RetentionPolicy m_retention_policy;
+        int             m_max_num_data_points;
+        Eigen::VectorXd m_retention_center;
     };
 } // namespace sequential_line_search
 
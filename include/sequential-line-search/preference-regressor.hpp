@@ -3,6 +3,10 @@
 
 #include <Eigen/Cholesky>
 #include <Eigen/Core>
+#include <iosfwd>
+#include <memory>
+#include <sequential-line-search/cancellation-token.hpp>
+#include <sequential-line-search/executor.hpp>
 #include <sequential-line-search/preference.hpp>
 #include <sequential-line-search/regressor.hpp>
 #include <string>
@@ -17,16 +21,23 @@ namespace sequential_line_search
     class PreferenceRegressor : public Regressor
     {
     public:
-        PreferenceRegressor(const Eigen::MatrixXd&         X,
-                            const std::vector<Preference>& D,
-                            const bool                     use_map_hyperparams          = false,
-                            const double                   default_kernel_signal_var    = 0.500,
-                            const double                   default_kernel_length_scale  = 0.500,
-                            const double                   default_noise_level          = 0.005,
-                            const double                   kernel_hyperparams_prior_var = 0.250,
-                            const double                   btl_scale                    = 0.010,
-                            const unsigned                 num_map_estimation_iters     = 100,
-                            const KernelType               kernel_type = KernelType::ArdMatern52Kernel);
+        /// \param executor The executor that the MAP estimation runs on. When this is null, the default one (see
+        /// `GetDefaultExecutor`) is used.
+        ///
+        /// \param cancellation_token If not null and set, the MAP estimation stops within one evaluation of its
+        /// objective, leaving the regressor valid but not fitted (see `CancellationToken`).
+        PreferenceRegressor(const Eigen::MatrixXd&           X,
+                            const std::vector<Preference>&   D,
+                            const bool                       use_map_hyperparams          = false,
+                            const double                     default_kernel_signal_var    = 0.500,
+                            const double                     default_kernel_length_scale  = 0.500,
+                            const double                     default_noise_level          = 0.005,
+                            const double                     kernel_hyperparams_prior_var = 0.250,
+                            const double                     btl_scale                    = 0.010,
+                            const unsigned                   num_map_estimation_iters     = 100,
+                            const KernelType                 kernel_type        = KernelType::ArdMatern52Kernel,
+                            const std::shared_ptr<Executor>& executor           = nullptr,
+                            const CancellationToken*         cancellation_token = nullptr);
 
         double PredictMu(const Eigen::VectorXd& x) const override;
         double PredictSigma(const Eigen::VectorXd& x) const override;
@@ -34,6 +45,8 @@ namespace sequential_line_search
         Eigen::VectorXd PredictMuDerivative(const Eigen::VectorXd& x) const override;
         Eigen::VectorXd PredictSigmaDerivative(const Eigen::VectorXd& x) const override;
 
+        Eigen::MatrixXd SolveLargeKY(const Eigen::MatrixXd& B) const override { return m_K_llt.solve(B); }
+
         const bool m_use_map_hyperparams;
 
         /// \brief Find the data point that is likely to have the largest value from the so-far observed data points.
@@ -62,6 +75,16 @@ namespace sequential_line_search
         // IO
         void DampData(const std::string& dir_path, const std::string& prefix = "") const;
 
+        /// \brief Write the settings, the data, and the estimated values in the binary snapshot format.
+        ///
+        /// \details See `binary_io` for the encoding.
+        void Save(std::ostream& stream) const;
+
+        /// \brief Restore a regressor written by `Save` without performing the MAP estimation.
+        ///
+        /// \details The kernel matrix is restored as it is and only its Cholesky decomposition is recomputed.
+        static std::shared_ptr<PreferenceRegressor> Load(std::istream& stream);
+
         // Getter
         const Eigen::MatrixXd& GetLargeX() const override { return m_X; }
         const Eigen::VectorXd& GetSmallY() const override { return m_y; }
@@ -80,11 +103,29 @@ namespace sequential_line_search
         /// \brief Scale parameter in the BTL model
         const double m_btl_scale;
 
+        /// \brief The executor that the MAP estimation runs on.
+        const std::shared_ptr<Executor> m_executor;
+
     private:
         /// \brief Goodness values derived by the MAP estimation.
         Eigen::VectorXd m_y;
 
-        void PerformMapEstimation(const unsigned num_iters);
+        /// \brief Construct a regressor from already estimated values. Used by `Load`.
+        PreferenceRegressor(const Eigen::MatrixXd&         X,
+                            const std::vector<Preference>& D,
+                            const Eigen::VectorXd&         y,
+                            const Eigen::VectorXd&         kernel_hyperparams,
+                            const double                   noise_hyperparam,
+                            const Eigen::MatrixXd&         K,
+                            const bool                     use_map_hyperparams,
+                            const double                   default_kernel_signal_var,
+                            const double                   default_kernel_length_scale,
+                            const double                   default_noise_level,
+                            const double                   kernel_hyperparams_prior_var,
+                            const double                   btl_scale,
+                            const KernelType               kernel_type);
+
+        void PerformMapEstimation(const unsigned num_iters, const CancellationToken* cancellation_token);
     };
 } // namespace sequential_line_search
 
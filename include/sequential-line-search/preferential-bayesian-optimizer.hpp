@@ -2,10 +2,18 @@
 #define SEQUENTIAL_LINE_SEARCH_PREFERENTIAL_BAYESIAN_OPTIMIZER_HPP
 
 #include <Eigen/Core>
+#include <functional>
+#include <future>
+#include <iosfwd>
 #include <memory>
 #include <sequential-line-search/acquisition-function.hpp>
 #include <sequential-line-search/current-best-selection-strategy.hpp>
+#include <sequential-line-search/executor.hpp>
+#include <sequential-line-search/feedback-journal.hpp>
 #include <sequential-line-search/kernel-type.hpp>
+#include <sequential-line-search/preference.hpp>
+#include <sequential-line-search/retention-policy.hpp>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -30,6 +38,11 @@ namespace sequential_line_search
     /// \details This optimizer requests discrete choice queries. In the current implementation, the number of choices
     /// for each query is two by default (i.e., pairwise comparison). This class assumes that the search space is [0,
     /// 1]^{D}.
+    ///
+    /// The getters of the current options, the surrogate model, and the data (e.g., `GetCurrentOptions` and
+    /// `GetPreferenceValueMean`) can be called from any number of threads concurrently, even while an update is being
+    /// computed; they read an immutable snapshot, which an update replaces atomically when it finishes, and never wait
+    /// for the update. The other methods should be called from one thread at a time.
     class PreferentialBayesianOptimizer
     {
     public:
@@ -51,6 +64,9 @@ namespace sequential_line_search
                 CurrentBestSelectionStrategy::LargestExpectValue,
             const int num_options = 2);
 
+        /// \brief Wait for the pending asynchronous update (if any) before destruction.
+        ~PreferentialBayesianOptimizer();
+
         /// \brief Specify (kernel and other) hyperparameter values.
         ///
         /// \details When the MAP estimation is enabled, the specified kernel hyperparameters will be used as the median
@@ -92,11 +108,38 @@ namespace sequential_line_search
         /// \details This method is expected to be called right after `SubmitFeedbackData` is called.
         void DetermineNextQuery(const int num_global_search_iters = 0, const int num_local_search_iters = 0);
 
+        /// \brief Perform `SubmitFeedbackData` and `DetermineNextQuery` without blocking the caller.
+        ///
+        /// \details The MAP estimation and the acquisition function maximization run on an internal worker thread.
+        /// Until they finish, the getters (e.g., `GetCurrentOptions` and `GetPreferenceValueMean`) keep returning
+        /// values from the previous iteration; the new data, surrogate model, and options are then published together,
+        /// so that a getter never observes a mixture of the two iterations. Calling any of the other non-const
+        /// methods (including another submission) waits for the pending update first.
+        ///
+        /// \param on_completed If not null, this is called on the worker thread right after the update is published, or
+        /// after the update has failed (in which case nothing is published and the exception is rethrown by the `get`
+        /// of the returned future).
+        ///
+        /// \return A future that becomes ready when the update is published. An exception thrown during the update is
+        /// rethrown by its `get`.
+        std::shared_future<void> SubmitFeedbackDataAsync(const int                    option_index,
+                                                         const int                    num_map_estimation_iters = 0,
+                                                         const int                    num_global_search_iters  = 0,
+                                                         const int                    num_local_search_iters   = 0,
+                                                         const std::function<void()>& on_completed = nullptr);
+
+        /// \brief Block until the update submitted by `SubmitFeedbackDataAsync` (if any) is published or has failed.
+        ///
+        /// \details An exception thrown during the update is not rethrown here, nor by the other methods that wait for
+        /// the update; it is reported only by the future returned by `SubmitFeedbackDataAsync`. The state before the
+        /// failed update stays published.
+        void WaitForPendingUpdate() const;
+
         /// \brief Get the current options.
         ///
         /// \details This getter method returns a list of `num_options` points. The first option is always the "current
         /// best" option, and the others are the new options determined by maximizing the acquisition function.
-        const std::vector<Eigen::VectorXd>& GetCurrentOptions() const { return m_current_options; }
+        std::vector<Eigen::VectorXd> GetCurrentOptions() const;
 
         /// \brief Get the point that has the highest value among the observed points.
         ///
@@ -107,10 +150,42 @@ namespace sequential_line_search
         double GetPreferenceValueStdev(const Eigen::VectorXd& point) const;
         double GetAcquisitionFuncValue(const Eigen::VectorXd& point) const;
 
-        const Eigen::MatrixXd& GetRawDataPoints() const;
+        /// \brief Predict the means and the standard deviations of the preference values at multiple points at once.
+        ///
+        /// \details The kernel vectors of all the points are solved against the kernel matrix in a single call, which
+        /// is considerably cheaper than calling `GetPreferenceValueMean` and `GetPreferenceValueStdev` for each point.
+        ///
+        /// \param points The points stored as columns (D x num_points). Throws `std::invalid_argument` if the number of
+        /// rows is not D.
+        ///
+        /// \param mu If not null, the means are stored.
+        ///
+        /// \param sigma If not null, the standard deviations are stored.
+        void PredictPreferenceValues(const Eigen::Ref<const Eigen::MatrixXd>& points,
+                                     Eigen::VectorXd*                         mu,
+                                     Eigen::VectorXd*                         sigma) const;
+
+        Eigen::MatrixXd GetRawDataPoints() const;
 
         void DampData(const std::string& directory_path) const;
 
+        /// \brief Write the whole state of the optimizer in a versioned binary format.
+        ///
+        /// \details The snapshot contains the configuration, the hyperparameters, the data, the surrogate model
+        /// (including the estimated goodness values and the kernel matrix), and the current options. See `binary_io`
+        /// for the encoding. A pending asynchronous update is waited for first. The initial query generator is not
+        /// included; neither is the state of the global random number generator used via `Eigen::VectorXd::Random`.
+        void Save(std::ostream& stream) const;
+        void Save(const std::string& file_path) const;
+
+        /// \brief Restore an optimizer written by `Save` without refitting the surrogate model.
+        ///
+        /// \details Throws `std::runtime_error` if the snapshot is broken or of an unsupported version.
+        static std::shared_ptr<PreferentialBayesianOptimizer>
+        Load(std::istream& stream, const InitialQueryGenerator& initial_query_generator = GenerateRandomPoints);
+        static std::shared_ptr<PreferentialBayesianOptimizer>
+        Load(const std::string& file_path, const InitialQueryGenerator& initial_query_generator = GenerateRandomPoints);
+
         /// \brief Set the hyperparameter in the GP-UCB algorithm.
         ///
         /// \details This hyperparameter controls the trade-off of exploration and exploitation. Specifically, this
@@ -122,18 +197,88 @@ namespace sequential_line_search
             m_gaussian_process_upper_confidence_bound_hyperparam = hyperparam;
         }
 
+        /// \brief Set the policy for bounding the number of data points used in the surrogate model.
+        ///
+        /// \details See `RetentionPolicy`. The surrogate model is always fit to the retained data only.
+        void SetDataRetentionPolicy(const RetentionPolicy policy, const int max_num_data_points);
+
+        /// \brief Set the executor that the asynchronous updates, the MAP estimation, and the acquisition function
+        /// maximization run on.
+        ///
+        /// \details By default, the process-wide pool returned by `GetDefaultExecutor` is used, so no thread is
+        /// created per call. When null is specified, the default one is used.
+        void SetExecutor(const std::shared_ptr<Executor>& executor);
+
+        /// \brief Start appending every submitted feedback to a journal file.
+        ///
+        /// \details Each feedback from `SubmitFeedbackData`, `SubmitCustomFeedbackData`, and `SubmitFeedbackDataAsync`
+        /// is written as a record (see `FeedbackJournal`) before the surrogate model is updated, so that the session
+        /// can be recovered by `ReplayFeedbackJournal` after a crash. If the file already exists, the records are
+        /// appended to it.
+        ///
+        /// \param sync_interval The number of records between syncs. Used only by `JournalSyncPolicy::EveryNRecords`.
+        void EnableFeedbackJournal(const std::string&      file_path,
+                                   const JournalSyncPolicy sync_policy   = JournalSyncPolicy::EveryRecord,
+                                   const int               sync_interval = 1);
+
+        /// \brief Stop journaling. The journal file is synced and closed.
+        void DisableFeedbackJournal();
+
+        /// \brief Add all the valid records of a journal file to the data and update the internal surrogate model.
+        ///
+        /// \details The records are added in bulk and the MAP estimation is performed only once at the end. As with
+        /// `SubmitFeedbackData`, `DetermineNextQuery` is expected to be called afterward. The replayed records are not
+        /// written to the journal enabled by `EnableFeedbackJournal`.
+        ///
+        /// \param num_map_estimation_iters The number of iterations for the MAP estimation. When a non-positive value
+        /// (e.g., 0) is specified, this is heuristically set.
+        ///
+        /// \return The number of replayed records.
+        int ReplayFeedbackJournal(const std::string& file_path, const int num_map_estimation_iters = 0);
+
+        /// \brief Add prior preference data and update the internal surrogate model.
+        ///
+        /// \details The data is added in bulk by `PreferenceDataManager::AddData` and the MAP estimation is performed
+        /// only once. As with `SubmitFeedbackData`, `DetermineNextQuery` is expected to be called afterward.
+        /// Throws `std::runtime_error` (leaving the optimizer unchanged) if the number of dimensions of the data
+        /// differs from that of the optimizer.
+        ///
+        /// \param X The data points, one per column.
+        ///
+        /// \param D The preferential observations, which refer to the columns of `X`.
+        ///
+        /// \param num_map_estimation_iters The number of iterations for the MAP estimation. When a non-positive value
+        /// (e.g., 0) is specified, this is heuristically set.
+        void ImportData(const Eigen::MatrixXd&         X,
+                        const std::vector<Preference>& D,
+                        const int                      num_map_estimation_iters = 0);
+
+        /// \brief Add the data written by `DampData` (i.e., `X.csv` and `D.csv` in the directory) and update the
+        /// internal surrogate model.
+        void ImportData(const std::string& directory_path, const int num_map_estimation_iters = 0);
+
     private:
+        /// \brief The state that the getters read.
+        ///
+        /// \details A published snapshot and the objects it refers to are never modified; an update builds new
+        /// objects (copying the data if needed) and publishes them together by `PublishSnapshot`.
+        struct Snapshot
+        {
+            std::shared_ptr<const PreferenceDataManager> data;
+            std::shared_ptr<const PreferenceRegressor>   regressor;
+
+            /// \details The number of options is always equivalent to `m_num_options`. For example, the size of this
+            /// list is two in case of using pairwise comparison.
+            std::vector<Eigen::VectorXd> current_options;
+        };
+
         const bool m_use_map_hyperparams;
         const int  m_num_options;
 
         const CurrentBestSelectionStrategy m_current_best_selection_strategy;
 
-        std::shared_ptr<PreferenceRegressor>   m_regressor;
-        std::shared_ptr<PreferenceDataManager> m_data;
-
-        /// \details The number of options is always equivalent to `m_num_options`. For example, the size of this list
-        /// is two in case of using pairwise comparison.
-        std::vector<Eigen::VectorXd> m_current_options;
+        /// \brief The published state. Accessed only via `LoadSnapshot` and `PublishSnapshot`.
+        std::shared_ptr<const Snapshot> m_snapshot;
 
         double m_kernel_signal_var;
         double m_kernel_length_scale;
@@ -146,13 +291,50 @@ namespace sequential_line_search
 
         double m_gaussian_process_upper_confidence_bound_hyperparam;
 
+        /// \brief The executor that the background and parallel computations run on.
+        std::shared_ptr<Executor> m_executor;
+
+        /// \brief The update submitted by `SubmitFeedbackDataAsync`. Invalid if nothing has been submitted.
+        std::shared_future<void> m_pending_update;
+
+        /// \brief The journal that every feedback is written to. Null if journaling is disabled.
+        std::shared_ptr<FeedbackJournal> m_journal;
+
+        /// \brief Get the published state without blocking, even while an update is being computed.
+        std::shared_ptr<const Snapshot> LoadSnapshot() const;
+
+        /// \brief Replace the published state in a single atomic step. Called only by the thread that owns the update
+        /// (i.e., the caller of a non-const method or the worker of the asynchronous update).
+        void PublishSnapshot(const Snapshot& snapshot);
+
+        /// \brief Make a modifiable copy of the published data, which is to be published by `PerformMapEstimation`.
+        ///
+        /// \details This costs O(Nd) on every update; see `SequentialLineSearchOptimizer::CopyData`.
+        std::shared_ptr<PreferenceDataManager> CopyData() const;
+
+        /// \brief Fit a surrogate model to the data.
+        ///
+        /// \param num_map_estimation_iters The number of iterations for the MAP estimation. When a non-positive value
+        /// (e.g., 0) is specified, this is heuristically set.
+        std::shared_ptr<const PreferenceRegressor> FitRegressor(const PreferenceDataManager& data,
+                                                                int num_map_estimation_iters) const;
+
+        /// \brief Determine the options for the next iteration from a surrogate model.
+        std::vector<Eigen::VectorXd> CalcNextOptions(const PreferenceRegressor&   regressor,
+                                                     const PreferenceDataManager& data,
+                                                     int                          num_global_search_iters,
+                                                     int                          num_local_search_iters) const;
+
         /// \brief Peform MAP estimation of the latent goodness values (and optionally the kernel hyperparameters).
         ///
         /// \details This private method is called by `SubmitFeedbackData` and `SubmitCustomFeedbackData`.
         ///
+        /// \param data The data that the surrogate model is fit to, which is published together with it.
+        ///
         /// \param num_map_estimation_iters The number of iterations for the MAP estimation. When a non-positive value
         /// (e.g., 0) is specified, this is heuristically set.
-        void PerformMapEstimation(const int num_map_estimation_iters);
+        void PerformMapEstimation(const std::shared_ptr<const PreferenceDataManager>& data,
+                                  const int                                           num_map_estimation_iters);
     };
 } // namespace sequential_line_search
 
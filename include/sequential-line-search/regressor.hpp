@@ -27,13 +27,40 @@ namespace sequential_line_search
         virtual const Eigen::MatrixXd& GetLargeX() const = 0;
         virtual const Eigen::VectorXd& GetSmallY() const = 0;
 
+        /// \brief Calculate K_y^{-1} B, where K_y is the kernel matrix of the data points (including the noise term).
+        ///
+        /// \details This is useful for predicting many points at once, where the kernel vectors of all the points can
+        /// be solved in a single call.
+        virtual Eigen::MatrixXd SolveLargeKY(const Eigen::MatrixXd& B) const = 0;
+
         Eigen::VectorXd PredictMaximumPointFromData() const;
 
+        /// \brief Predict the means and the standard deviations at multiple points at once.
+        ///
+        /// \param K_star The kernel vectors of the points, K_* = [k(x_1), ..., k(x_S)] (N x S), which can be
+        /// calculated by, e.g., `CalcLargeKStar` or `CalcLargeKStarOnLine`.
+        ///
+        /// \param mu If not null, the predictive means are stored.
+        ///
+        /// \param sigma If not null, the predictive standard deviations are stored.
+        void PredictFromLargeKStar(const Eigen::MatrixXd& K_star, Eigen::VectorXd* mu, Eigen::VectorXd* sigma) const;
+
+        /// \brief Predict the means and the standard deviations at multiple points (stored as columns) at once.
+        ///
+        /// \details The kernel vectors of all the points are calculated by `CalcLargeKStar` and then passed to
+        /// `PredictFromLargeKStar`, which is considerably cheaper than calling `PredictMu` and `PredictSigma` for each
+        /// point.
+        void PredictInBatch(const Eigen::Ref<const Eigen::MatrixXd>& X_star,
+                            Eigen::VectorXd*                         mu,
+                            Eigen::VectorXd*                         sigma) const;
+
+        KernelType               GetKernelType() const { return m_kernel_type; }
         Kernel                   GetKernel() const { return m_kernel; }
         KernelThetaDerivative    GetKernelThetaDerivative() const { return m_kernel_theta_derivative; }
         KernelFirstArgDerivative GetKernelFirstArgDerivative() const { return m_kernel_first_arg_derivative; }
 
     protected:
+        KernelType               m_kernel_type;
         Kernel                   m_kernel;
         KernelThetaDerivative    m_kernel_theta_derivative;
         KernelFirstArgDerivative m_kernel_first_arg_derivative;
@@ -45,6 +72,23 @@ namespace sequential_line_search
                                const Eigen::VectorXd& kernel_hyperparameters,
                                const Kernel           kernel);
 
+    // K_* = [k(x_1), ..., k(x_S)]
+    Eigen::MatrixXd CalcLargeKStar(const Eigen::Ref<const Eigen::MatrixXd>& X_star,
+                                   const Eigen::MatrixXd&                   X,
+                                   const Eigen::VectorXd&                   kernel_hyperparameters,
+                                   const Kernel                             kernel);
+
+    // K_* for the points on a line, x_s = origin + t_s * direction
+    //
+    // The squared (scaled) distance between a point on the line and a data point is a quadratic function of t, whose
+    // coefficients are calculated once per data point; this costs O(N D + N S) instead of O(N S D).
+    Eigen::MatrixXd CalcLargeKStarOnLine(const Eigen::VectorXd& origin,
+                                         const Eigen::VectorXd& direction,
+                                         const Eigen::VectorXd& ts,
+                                         const Eigen::MatrixXd& X,
+                                         const Eigen::VectorXd& kernel_hyperparameters,
+                                         const KernelType       kernel_type);
+
     // K_y = K_f + sigma^{2} I
     Eigen::MatrixXd CalcLargeKY(const Eigen::MatrixXd& X,
                                 const Eigen::VectorXd& kernel_hyperparameters,
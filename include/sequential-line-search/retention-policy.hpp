@@ -0,0 +1,22 @@
+#ifndef SEQUENTIAL_LINE_SEARCH_RETENTION_POLICY_HPP
+#define SEQUENTIAL_LINE_SEARCH_RETENTION_POLICY_HPP
+
+namespace sequential_line_search
+{
+    /// \brief Policy for bounding the number of data points kept by `PreferenceDataManager`.
+    ///
+    /// \details The costs of the MAP estimation and the acquisition function maximization grow (cubically) with the
+    /// number of data points. Bounding it caps the latency of each iteration in long-running sessions. In all the
+    /// policies, the points in the last preferential observation are never dropped.
+    enum class RetentionPolicy
+    {
+        KeepAll,          /// Keep all the data points.
+        SlidingWindow,    /// Drop the oldest preferential observations (and the points no longer referenced).
+        DropDominatedFar, /// Drop points that are never preferred to others, the farthest from the current maximizer
+                          /// first. Falls back to the sliding window when no such points are left.
+        Thinning,         /// Drop points that are closest to other points, replacing their references by the nearest
+                          /// points; this keeps the data evenly spread over the explored region.
+    };
+} // namespace sequential_line_search
+
+#endif // SEQUENTIAL_LINE_SEARCH_RETENTION_POLICY_HPP
@@ -2,17 +2,28 @@
 #define SEQUENTIAL_LINE_SEARCH_SEQUENTIAL_LINE_SEARCH_HPP
 
 #include <Eigen/Core>
+#include <functional>
+#include <future>
+#include <iosfwd>
 #include <memory>
 #include <sequential-line-search/acquisition-function.hpp>
+#include <sequential-line-search/cancellation-token.hpp>
 #include <sequential-line-search/current-best-selection-strategy.hpp>
+#include <sequential-line-search/executor.hpp>
+#include <sequential-line-search/feedback-journal.hpp>
 #include <sequential-line-search/kernel-type.hpp>
+#include <sequential-line-search/preference.hpp>
+#include <sequential-line-search/retention-policy.hpp>
+#include <string>
 #include <utility>
+#include <vector>
 
 namespace sequential_line_search
 {
     class PreferenceRegressor;
     class Slider;
     class PreferenceDataManager;
+    class TrustRegion;
 
     std::pair<Eigen::VectorXd, Eigen::VectorXd> GenerateRandomSliderEnds(const int num_dims);
     std::pair<Eigen::VectorXd, Eigen::VectorXd> GenerateCenteredFixedLengthRandomSliderEnds(const int num_dims);
@@ -20,6 +31,11 @@ namespace sequential_line_search
     /// \brief Optimizer class for performing sequential line search.
     ///
     /// \details This class assumes that the search space is [0, 1]^{D}.
+    ///
+    /// The getters of the current slider, the surrogate model, and the data (e.g., `GetSliderEnds`,
+    /// `GetPreferenceValueMean`, and `SampleSlider`) can be called from any number of threads concurrently, even while
+    /// an update is being computed; they read an immutable snapshot, which an update replaces atomically when it
+    /// finishes, and never wait for the update. The other methods should be called from one thread at a time.
     class SequentialLineSearchOptimizer
     {
     public:
@@ -42,6 +58,9 @@ namespace sequential_line_search
             const CurrentBestSelectionStrategy current_best_selection_strategy =
                 CurrentBestSelectionStrategy::LargestExpectValue);
 
+        /// \brief Wait for the pending asynchronous update (if any) before destruction.
+        ~SequentialLineSearchOptimizer();
+
         /// \brief Specify (kernel and other) hyperparameter values.
         ///
         /// \details When the MAP estimation is enabled, the specified kernel hyperparameters will be used as the median
@@ -69,6 +88,71 @@ namespace sequential_line_search
                                 const int    num_global_search_iters,
                                 const int    num_local_search_iters);
 
+        /// \brief Submit the result of user-performed line search and go to the next iteration step without blocking
+        /// the caller.
+        ///
+        /// \details The MAP estimation and the acquisition function maximization run on an internal worker thread.
+        /// Until they finish, the getters (e.g., `GetSliderEnds` and `GetPreferenceValueMean`) keep returning values
+        /// from the previous iteration; the new data, surrogate model, and slider are then published together, so
+        /// that a getter never observes a mixture of the two iterations. Calling any of the other non-const methods
+        /// (including another submission) waits for the pending update first.
+        ///
+        /// \param num_map_estimation_iters The number of iterations for the MAP estimation. When a non-positive value
+        /// (e.g., 0) is specified, this is heuristically set. The same applies to the other parameters.
+        ///
+        /// \param on_completed If not null, this is called on the worker thread right after the update is published, or
+        /// after the update has failed (in which case nothing is published and the exception is rethrown by the `get`
+        /// of the returned future).
+        /// Note that GUI toolkits usually require it to post an event to the main thread rather than to touch widgets
+        /// directly.
+        ///
+        /// \return A future that becomes ready when the update is published. An exception thrown during the update is
+        /// rethrown by its `get`.
+        std::shared_future<void> SubmitFeedbackDataAsync(const double                 slider_position,
+                                                         const int                    num_map_estimation_iters = 0,
+                                                         const int                    num_global_search_iters  = 0,
+                                                         const int                    num_local_search_iters   = 0,
+                                                         const std::function<void()>& on_completed = nullptr);
+
+        /// \brief Block until the update submitted by `SubmitFeedbackDataAsync` (if any) is published or has failed.
+        ///
+        /// \details An exception thrown during the update is not rethrown here, nor by the other methods that wait for
+        /// the update; it is reported only by the future returned by `SubmitFeedbackDataAsync`. The state before the
+        /// failed update stays published.
+        void WaitForPendingUpdate() const;
+
+        /// \brief Generate a batch of distinct sliders for serving multiple users concurrently.
+        ///
+        /// \details All the sliders share the current-best end-point, and their other end-points are determined
+        /// jointly by `acquisition_func::FindNextPoints`, which updates the predictive variance with the pending points
+        /// so that the sliders do not collapse onto each other. Each response should be submitted by
+        /// `SubmitBatchFeedbackData` together with the index of the slider that the user was given. Submitting a
+        /// response only stores the data; the surrogate model is refit once when the next batch is generated.
+        ///
+        /// When no feedback data is available yet, the sliders are generated by the initial query generator.
+        ///
+        /// \param num_map_estimation_iters The number of iterations for the MAP estimation. When a non-positive value
+        /// (e.g., 0) is specified, this is heuristically set. The same applies to the other parameters.
+        void GenerateSliderBatch(const int num_sliders,
+                                 const int num_map_estimation_iters = 0,
+                                 const int num_global_search_iters  = 0,
+                                 const int num_local_search_iters   = 0);
+
+        /// \brief Submit the result of line search performed on one of the sliders generated by `GenerateSliderBatch`.
+        ///
+        /// \param slider_index The index of the slider in the current batch, starting at zero. `std::out_of_range` is
+        /// thrown if it is not in the current batch; the same applies to the other batch methods.
+        void SubmitBatchFeedbackData(const int slider_index, const double slider_position);
+
+        /// \brief Get the number of sliders in the current batch.
+        int GetNumBatchSliders() const { return m_batch_sliders.size(); }
+
+        /// \brief Get the end-points of a slider in the current batch.
+        std::pair<Eigen::VectorXd, Eigen::VectorXd> GetBatchSliderEnds(const int slider_index) const;
+
+        /// \brief Calculate data point from a slider position of a slider in the current batch.
+        Eigen::VectorXd CalcPointFromBatchSliderPosition(const int slider_index, const double slider_position) const;
+
         /// \brief Get the slider end-points.
         ///
         /// \details When the slider enlargement is not enabled, the first end-point is the maximizer among the observed
@@ -78,6 +162,29 @@ namespace sequential_line_search
         /// \brief Calculate data point from a slider position.
         Eigen::VectorXd CalcPointFromSliderPosition(const double slider_position) const;
 
+        /// \brief Calculate data points from multiple slider positions at once.
+        ///
+        /// \return The points stored as columns (D x num_positions).
+        Eigen::MatrixXd CalcPointsFromSliderPositions(const Eigen::VectorXd& slider_positions) const;
+
+        /// \brief Sample evenly spaced points along the current slider, from the first end-point to the second one.
+        ///
+        /// \details This is much cheaper than calling `CalcPointFromSliderPosition`, `GetPreferenceValueMean`, and
+        /// so on for each slider position. The kernel vectors of all the samples are computed by exploiting that they
+        /// lie on a line (see `CalcLargeKStarOnLine`) and are solved in a single call.
+        ///
+        /// \param mu If not null, the means of the preference values at the samples are stored.
+        ///
+        /// \param sigma If not null, the standard deviations of the preference values at the samples are stored.
+        ///
+        /// \param acquisition_values If not null, the acquisition function values at the samples are stored.
+        ///
+        /// \return The sampled points (D x num_samples).
+        Eigen::MatrixXd SampleSlider(const int        num_samples,
+                                     Eigen::VectorXd* mu                 = nullptr,
+                                     Eigen::VectorXd* sigma              = nullptr,
+                                     Eigen::VectorXd* acquisition_values = nullptr) const;
+
         /// \brief Get the point that has the highest value among the observed points.
         ///
         /// \details The point is selected according to `CurrentBestSelectionStrategy`.
@@ -87,30 +194,211 @@ namespace sequential_line_search
         double GetPreferenceValueStdev(const Eigen::VectorXd& point) const;
         double GetAcquisitionFuncValue(const Eigen::VectorXd& point) const;
 
-        const Eigen::MatrixXd& GetRawDataPoints() const;
+        /// \brief Predict the means and the standard deviations of the preference values at multiple points at once.
+        ///
+        /// \details The kernel vectors of all the points are solved against the kernel matrix in a single call, which
+        /// is considerably cheaper than calling `GetPreferenceValueMean` and `GetPreferenceValueStdev` for each point.
+        ///
+        /// \param points The points stored as columns (D x num_points). Throws `std::invalid_argument` if the number of
+        /// rows is not D.
+        ///
+        /// \param mu If not null, the means are stored.
+        ///
+        /// \param sigma If not null, the standard deviations are stored.
+        void PredictPreferenceValues(const Eigen::Ref<const Eigen::MatrixXd>& points,
+                                     Eigen::VectorXd*                         mu,
+                                     Eigen::VectorXd*                         sigma) const;
+
+        Eigen::MatrixXd GetRawDataPoints() const;
+
+        /// \brief Get the number of dimensions of the search space.
+        int GetNumDims() const;
+
+        /// \brief Get the number of the data points, which is cheaper than `GetRawDataPoints().cols()`.
+        int GetNumDataPoints() const;
 
         void DampData(const std::string& directory_path) const;
 
+        /// \brief Write the whole state of the optimizer in a versioned binary format.
+        ///
+        /// \details The snapshot contains the configuration, the hyperparameters, the data, the surrogate model
+        /// (including the estimated goodness values and the kernel matrix), the current and batch sliders, and the
+        /// states of the warm-start and trust-region modes. See `binary_io` for the encoding. A pending asynchronous
+        /// update is waited for first. The initial query generator is not included; neither is the state of the
+        /// global random number generator used via `Eigen::VectorXd::Random`.
+        void Save(std::ostream& stream) const;
+        void Save(const std::string& file_path) const;
+
+        /// \brief Restore an optimizer written by `Save` without refitting the surrogate model.
+        ///
+        /// \details Throws `std::runtime_error` if the snapshot is broken or of an unsupported version.
+        static std::shared_ptr<SequentialLineSearchOptimizer>
+        Load(std::istream&                                                                 stream,
+             const std::function<std::pair<Eigen::VectorXd, Eigen::VectorXd>(const int)>& initial_query_generator =
+                 GenerateRandomSliderEnds);
+        static std::shared_ptr<SequentialLineSearchOptimizer>
+        Load(const std::string&                                                            file_path,
+             const std::function<std::pair<Eigen::VectorXd, Eigen::VectorXd>(const int)>& initial_query_generator =
+                 GenerateRandomSliderEnds);
+
         /// \brief Set the hyperparameter in the GP-UCB algorithm.
         ///
         /// \details This hyperparameter controls the trade-off of exploration and exploitation. Specifically, this
         /// hyperparameter corresponds to the square root of the beta in [Srinivas et al. ICML '10].
         ///
         /// If the acquisition function is not GP-UCB, this value will not be used.
-        void SetGaussianProcessUpperConfidenceBoundHyperparam(const double hyperparam)
-        {
-            m_gaussian_process_upper_confidence_bound_hyperparam = hyperparam;
-        }
+        void SetGaussianProcessUpperConfidenceBoundHyperparam(const double hyperparam);
+
+        /// \brief Enable or disable warm-starting of the acquisition function maximization.
+        ///
+        /// \details When enabled, the multi-start search in `SubmitFeedbackData` starts a part of its local searches
+        /// from the local maxima found in the previous iteration, the current incumbent, and the data points, instead
+        /// of only from random points. Since the acquisition landscape changes only slightly per feedback, fewer
+        /// starts (i.e., a smaller `num_global_search_iters`) are usually enough. This has no effect when the
+        /// multi-start search is not enabled.
+        ///
+        /// \param random_start_fraction The fraction of the starts that are still drawn uniformly at random for
+        /// exploration.
+        void SetWarmStartAcquisitionSearch(const bool use_warm_start, const double random_start_fraction = 0.25);
+
+        /// \brief Enable or disable the trust-region mode of the acquisition function maximization.
+        ///
+        /// \details When enabled, the acquisition function is maximized only within a box around the current-best
+        /// point (see `TrustRegion`). The box expands when the user keeps moving away from the previous current-best
+        /// end-point along the slider, and shrinks when the user keeps choosing (almost) the previous current-best
+        /// point. This mode is recommended for high-dimensional problems (e.g., D > 10), where searching the whole
+        /// space tends to propose uninformative points near the boundary.
+        void SetTrustRegionAcquisitionSearch(const bool use_trust_region);
+
+        /// \brief Set the policy for bounding the number of data points used in the surrogate model.
+        ///
+        /// \details See `RetentionPolicy`. The surrogate model is always fit to the retained data only.
+        void SetDataRetentionPolicy(const RetentionPolicy policy, const int max_num_data_points);
+
+        /// \brief Enable or disable the speculative computation of the next slider.
+        ///
+        /// \details When enabled, while a slider is displayed, the next slider is computed on the executor (see
+        /// `SetExecutor`) for a few likely slider positions: the maximizer of the predicted mean along the slider and
+        /// the quantiles of the choice probability along the slider under the Bradley-Terry-Luce model. When the
+        /// submitted position is within `tolerance` of one of them (and the computational efforts are the heuristic
+        /// ones), its result is adopted instead of being computed from scratch, and the other speculations are
+        /// cancelled. Note that the speculated position (rather than the submitted one) is then stored as the chosen
+        /// point.
+        ///
+        /// \param num_speculations The number of speculated slider positions, each of which occupies a worker.
+        ///
+        /// \param tolerance The tolerance in the slider space, i.e., [0, 1].
+        void SetSpeculativeSliderComputation(const bool   use_speculation,
+                                             const int    num_speculations = 3,
+                                             const double tolerance        = 0.02);
+
+        /// \brief Set the executor that the asynchronous updates, the speculations, the MAP estimation, and the
+        /// acquisition function maximization run on.
+        ///
+        /// \details By default, the process-wide pool returned by `GetDefaultExecutor` is used, so no thread is
+        /// created per call. When null is specified, the default one is used.
+        void SetExecutor(const std::shared_ptr<Executor>& executor);
+
+        /// \brief Start appending every submitted feedback to a journal file.
+        ///
+        /// \details Each feedback from `SubmitFeedbackData`, `SubmitFeedbackDataAsync`, and `SubmitBatchFeedbackData`
+        /// is written as a record (see `FeedbackJournal`) before the surrogate model is updated, so that the session
+        /// can be recovered by `ReplayFeedbackJournal` after a crash. If the file already exists, the records are
+        /// appended to it.
+        ///
+        /// \param sync_interval The number of records between syncs. Used only by `JournalSyncPolicy::EveryNRecords`.
+        void EnableFeedbackJournal(const std::string&      file_path,
+                                   const JournalSyncPolicy sync_policy   = JournalSyncPolicy::EveryRecord,
+                                   const int               sync_interval = 1);
+
+        /// \brief Stop journaling. The journal file is synced and closed.
+        void DisableFeedbackJournal();
+
+        /// \brief Add all the valid records of a journal file to the data and go to the next iteration step.
+        ///
+        /// \details The records are added in bulk and the MAP estimation is performed only once at the end, which is
+        /// much faster than submitting them one by one. The replayed records are not written to the journal enabled by
+        /// `EnableFeedbackJournal`; to recover a session, construct an optimizer with the same configuration, replay
+        /// the journal, and then enable journaling to the same file.
+        ///
+        /// \param num_map_estimation_iters The number of iterations for the MAP estimation. When a non-positive value
+        /// (e.g., 0) is specified, this is heuristically set. The same applies to the other parameters.
+        ///
+        /// \return The number of replayed records.
+        int ReplayFeedbackJournal(const std::string& file_path,
+                                  int                num_map_estimation_iters = 0,
+                                  int                num_global_search_iters  = 0,
+                                  int                num_local_search_iters   = 0);
+
+        /// \brief Add prior preference data and go to the next iteration step.
+        ///
+        /// \details The data is added in bulk by `PreferenceDataManager::AddData` and the MAP estimation is performed
+        /// only once, so an optimizer can be initialized from, e.g., the data of a previous session much faster than
+        /// by submitting the observations one by one.
+        /// Throws `std::runtime_error` (leaving the optimizer unchanged) if the number of dimensions of the data
+        /// differs from that of the optimizer.
+        ///
+        /// \param X The data points, one per column.
+        ///
+        /// \param D The preferential observations, which refer to the columns of `X`.
+        ///
+        /// \param num_map_estimation_iters The number of iterations for the MAP estimation. When a non-positive value
+        /// (e.g., 0) is specified, this is heuristically set. The same applies to the other parameters.
+        void ImportData(const Eigen::MatrixXd&         X,
+                        const std::vector<Preference>& D,
+                        const int                      num_map_estimation_iters = 0,
+                        const int                      num_global_search_iters  = 0,
+                        const int                      num_local_search_iters   = 0);
+
+        /// \brief Add the data written by `DampData` (i.e., `X.csv` and `D.csv` in the directory) and go to the next
+        /// iteration step.
+        void ImportData(const std::string& directory_path,
+                        const int          num_map_estimation_iters = 0,
+                        const int          num_global_search_iters  = 0,
+                        const int          num_local_search_iters   = 0);
 
     private:
+        /// \brief The state that the getters read.
+        ///
+        /// \details A published snapshot and the objects it refers to are never modified; an update builds new
+        /// objects (copying the data if needed) and publishes them together by `PublishSnapshot`. A reader thus keeps
+        /// a consistent model as long as it holds the snapshot, even while the next one is being built.
+        struct Snapshot
+        {
+            std::shared_ptr<const PreferenceDataManager> data;
+            std::shared_ptr<const PreferenceRegressor>   regressor;
+            std::shared_ptr<const Slider>                slider;
+        };
+
+        /// \brief The next slider computed in the background for a speculated slider position.
+        struct Speculation
+        {
+            double slider_position;
+
+            int num_map_estimation_iters;
+            int num_global_search_iters;
+            int num_local_search_iters;
+
+            /// \brief Copies of the states carried between iterations, updated by the speculation.
+            std::shared_ptr<acquisition_func::WarmStartState> warm_start_state;
+            std::shared_ptr<TrustRegion>                      trust_region;
+
+            std::shared_ptr<CancellationToken> cancellation_token;
+            ExecutorTask<Snapshot>             result;
+        };
+
         const bool m_use_slider_enlargement;
         const bool m_use_map_hyperparams;
 
         const CurrentBestSelectionStrategy m_current_best_selection_strategy;
 
-        std::shared_ptr<PreferenceRegressor>   m_regressor;
-        std::shared_ptr<Slider>                m_slider;
-        std::shared_ptr<PreferenceDataManager> m_data;
+        /// \brief The published state. Accessed only via `LoadSnapshot` and `PublishSnapshot`.
+        std::shared_ptr<const Snapshot> m_snapshot;
+
+        /// \brief Sliders generated by `GenerateSliderBatch` and waiting for responses.
+        std::vector<std::shared_ptr<Slider>> m_batch_sliders;
+
+        const std::function<std::pair<Eigen::VectorXd, Eigen::VectorXd>(const int)> m_initial_query_generator;
 
         double m_kernel_signal_var;
         double m_kernel_length_scale;
@@ -122,6 +410,132 @@ namespace sequential_line_search
         const AcquisitionFuncType m_acquisition_func_type;
 
         double m_gaussian_process_upper_confidence_bound_hyperparam;
+
+        /// \brief Whether responses to batch sliders have been submitted since the last MAP estimation.
+        bool m_has_pending_batch_feedback;
+
+        /// \brief The state carried between acquisition function maximizations. Null if warm-starting is disabled.
+        std::shared_ptr<acquisition_func::WarmStartState> m_warm_start_state;
+
+        /// \brief The trust region for the acquisition function maximization. Null if the trust-region mode is
+        /// disabled.
+        std::shared_ptr<TrustRegion> m_trust_region;
+
+        /// \brief The executor that the background and parallel computations run on.
+        std::shared_ptr<Executor> m_executor;
+
+        /// \brief The update submitted by `SubmitFeedbackDataAsync`. Invalid if nothing has been submitted.
+        std::shared_future<void> m_pending_update;
+
+        /// \brief The number of speculated slider positions. Zero if the speculative computation is disabled.
+        int    m_num_speculations;
+        double m_speculation_tolerance;
+
+        /// \brief Speculations for the current slider.
+        std::vector<Speculation> m_speculations;
+
+        /// \brief Speculations that have been cancelled but may still be running; they refer to this instance.
+        std::vector<ExecutorTask<Snapshot>> m_cancelled_speculations;
+
+        /// \brief The journal that every feedback is written to. Null if journaling is disabled.
+        std::shared_ptr<FeedbackJournal> m_journal;
+
+        /// \brief Get the published state without blocking, even while an update is being computed.
+        std::shared_ptr<const Snapshot> LoadSnapshot() const;
+
+        /// \brief Replace the published state in a single atomic step. Called only by the thread that owns the update
+        /// (i.e., the caller of a non-const method or the worker of the asynchronous update).
+        void PublishSnapshot(const Snapshot& snapshot);
+
+        /// \brief Replace non-positive computational efforts with the heuristic ones.
+        void SetDefaultComputationalEfforts(int* num_map_estimation_iters,
+                                            int* num_global_search_iters,
+                                            int* num_local_search_iters) const;
+
+        /// \brief Add the feedback on the slider to the data and compute the surrogate model and the next slider.
+        ///
+        /// \details The data, the warm-start state, and the trust region are modified in place; the caller decides
+        /// whether they are the current ones or copies. The latter two can be null.
+        ///
+        /// \param cancellation_token If not null and set, the MAP estimation or the acquisition search in progress is
+        /// stopped within one objective evaluation and an empty snapshot is returned.
+        Snapshot CalcNextSnapshot(const std::shared_ptr<PreferenceDataManager>& data,
+                                  const Slider&                                 slider,
+                                  const double                                  slider_position,
+                                  const int                                     num_map_estimation_iters,
+                                  const int                                     num_global_search_iters,
+                                  const int                                     num_local_search_iters,
+                                  acquisition_func::WarmStartState*             warm_start_state,
+                                  TrustRegion*                                  trust_region,
+                                  const CancellationToken*                      cancellation_token = nullptr) const;
+
+        /// \brief Find the closest speculation performed with the same computational efforts. Null if none matches
+        /// the slider position.
+        const Speculation* FindSpeculation(const double slider_position,
+                                           const int    num_map_estimation_iters,
+                                           const int    num_global_search_iters,
+                                           const int    num_local_search_iters) const;
+
+        /// \brief Compute the next snapshot, adopting the speculation if it is not null.
+        Snapshot ResolveNextSnapshot(const std::shared_ptr<PreferenceDataManager>& data,
+                                     const Slider&                                 slider,
+                                     const double                                  slider_position,
+                                     const int                                     num_map_estimation_iters,
+                                     const int                                     num_global_search_iters,
+                                     const int                                     num_local_search_iters,
+                                     const Speculation*                            speculation);
+
+        /// \brief Get a slider in the current batch. Throws `std::out_of_range` if the index is invalid.
+        const Slider& GetBatchSlider(const int slider_index) const;
+
+        /// \brief Write a feedback to the journal if journaling is enabled.
+        void AppendToJournal(const Slider& slider, const double slider_position);
+
+        /// \brief Determine the slider positions to speculate on from the published surrogate model and slider.
+        std::vector<double> CalcSpeculatedSliderPositions() const;
+
+        /// \brief Launch speculations for the published slider if the speculative computation is enabled.
+        void LaunchSpeculations();
+
+        /// \brief Cancel the running speculations without waiting for them.
+        void CancelSpeculations();
+
+        /// \brief Cancel the running speculations and wait for all the cancelled ones, so that the members read by
+        /// them can be modified safely.
+        void StopSpeculations();
+
+        /// \brief Fit a surrogate model to the data.
+        std::shared_ptr<const PreferenceRegressor>
+        FitRegressor(const PreferenceDataManager& data,
+                     const int                    num_map_estimation_iters,
+                     const CancellationToken*     cancellation_token = nullptr) const;
+
+        /// \brief Peform MAP estimation of the latent goodness values (and optionally the kernel hyperparameters).
+        ///
+        /// \param data The data that the surrogate model is fit to, which is published together with it.
+        void PerformMapEstimation(const std::shared_ptr<const PreferenceDataManager>& data,
+                                  const int                                           num_map_estimation_iters);
+
+        /// \brief Make a modifiable copy of the published data, which is to be published by `PerformMapEstimation` or
+        /// `UpdateModelAndSlider`.
+        ///
+        /// \details This deep-copies the data points, the preferences, and the hash grid, i.e., O(Nd) on every update,
+        /// since the published data must stay intact for the readers of the snapshot. This is a regression from the
+        /// in-place update before snapshots were introduced, but it is negligible next to refitting the surrogate
+        /// model (O(N^3)), which copies the data as well.
+        std::shared_ptr<PreferenceDataManager> CopyData() const;
+
+        /// \brief Fit the surrogate model to the current data and compute the next slider from it.
+        ///
+        /// \details This is used after data is added in bulk; the trust region is not updated since there is no
+        /// response to the current slider. Nothing is computed if there is no data.
+        void UpdateModelAndSlider(const std::shared_ptr<const PreferenceDataManager>& data,
+                                  int                                                 num_map_estimation_iters,
+                                  int                                                 num_global_search_iters,
+                                  int                                                 num_local_search_iters);
+
+        /// \brief Find the current-best point of a snapshot according to `CurrentBestSelectionStrategy`.
+        Eigen::VectorXd FindCurrentBestPoint(const Snapshot& snapshot) const;
     };
 } // namespace sequential_line_search
 
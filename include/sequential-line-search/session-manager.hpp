@@ -0,0 +1,260 @@
+#ifndef SEQUENTIAL_LINE_SEARCH_SESSION_MANAGER_HPP
+#define SEQUENTIAL_LINE_SEARCH_SESSION_MANAGER_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <sequential-line-search/thread-pool.hpp>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sequential_line_search
+{
+    class SequentialLineSearchOptimizer;
+
+    using SessionId = std::uint64_t;
+
+    /// \brief Host of many optimizer sessions that share a single bounded thread pool.
+    ///
+    /// \details Each feedback submitted to a session becomes a job (i.e., the MAP estimation and the acquisition
+    /// function maximization of `SequentialLineSearchOptimizer::SubmitFeedbackData`). The jobs of a session run one at
+    /// a time in the submission order, while the jobs of different sessions run concurrently on the pool. Among the
+    /// sessions whose next jobs are ready, the job with the earliest deadline runs first, then the one of the session
+    /// with the highest priority, then the oldest one; since a session has at most one ready job at a time, no session
+    /// can monopolize the pool. At most as many jobs as the worker threads are in flight, and a job is held back while
+    /// the estimated memory of the jobs in flight would exceed the cap.
+    ///
+    /// Sessions can be evicted to snapshot files (see `SequentialLineSearchOptimizer::Save`) when they are idle, and
+    /// are restored transparently when they are accessed again. The snapshot files are written and read without
+    /// holding the lock of the manager, so that the other sessions are not blocked by the disk; a session that fails to
+    /// be written stays resident. The hosted optimizers use the pool as their executor
+    /// (see `SequentialLineSearchOptimizer::SetExecutor`), so the parallel parts of the jobs (e.g., the multi-start
+    /// acquisition search) do not oversubscribe the cores; their executors are reset to the default one when they stop
+    /// being hosted. Hosted optimizers should not enable the speculative slider computation, which would compete with
+    /// the jobs for the workers.
+    class SessionManager
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /// \param num_threads The number of worker threads. When a non-positive value is specified, the number of
+        /// hardware threads is used.
+        ///
+        /// \param max_in_flight_memory The cap on the total estimated memory (in bytes) of the jobs in flight. A job is
+        /// always dispatched when nothing is in flight, even if it exceeds the cap alone. Zero means no cap.
+        ///
+        /// \param max_num_resident_sessions The number of sessions kept in memory. When it is exceeded, the least
+        /// recently used idle sessions are evicted. Zero means no limit. This requires `eviction_directory_path`.
+        ///
+        /// \param eviction_directory_path The directory for the snapshot files of evicted sessions. When this is
+        /// empty, sessions are never evicted.
+        SessionManager(const int          num_threads               = 0,
+                       const std::size_t  max_in_flight_memory      = 0,
+                       const int          max_num_resident_sessions = 0,
+                       const std::string& eviction_directory_path   = "");
+
+        /// \brief Wait for all the jobs and the snapshot transfers and then stop the workers.
+        ~SessionManager();
+
+        SessionManager(const SessionManager&) = delete;
+        SessionManager& operator=(const SessionManager&) = delete;
+
+        /// \brief Start hosting an optimizer. The optimizer must not be used directly while it has pending jobs.
+        ///
+        /// \details A pending asynchronous update of the optimizer is waited for first.
+        ///
+        /// \param priority Sessions with larger values are served first among the jobs with the same deadline.
+        SessionId AddSession(const std::shared_ptr<SequentialLineSearchOptimizer>& optimizer, const int priority = 0);
+
+        /// \brief Stop hosting a session after its pending jobs finish. Its snapshot file (if any) is deleted.
+        void RemoveSession(const SessionId session_id);
+
+        void SetSessionPriority(const SessionId session_id, const int priority);
+
+        /// \brief Queue a feedback for a session without blocking the caller.
+        ///
+        /// \param deadline The time by which the caller would like the next slider to be ready. Jobs with earlier
+        /// deadlines are dispatched first; a job that misses its deadline still runs.
+        ///
+        /// \param on_completed If not null, this is called on the worker thread right after the job finishes
+        /// (successfully or not) with the future of the job, which is ready by then. This is useful for replying
+        /// without occupying a thread for waiting. An exception thrown by this is ignored.
+        ///
+        /// \return A future that becomes ready when the job finishes. An exception thrown by the job is rethrown by
+        /// its `get`.
+        std::shared_future<void> SubmitFeedbackData(const SessionId              session_id,
+                                                    const double                 slider_position,
+                                                    const Clock::time_point      deadline = Clock::time_point::max(),
+                                                    const std::function<void(const std::shared_future<void>&)>&
+                                                        on_completed = nullptr);
+
+        /// \brief Get the optimizer of a session, restoring it from its snapshot file if it has been evicted.
+        ///
+        /// \details The const methods of the returned optimizer (e.g., `GetSliderEnds`) can be called while a job of
+        /// the session is running; they see the state before the job until it finishes.
+        std::shared_ptr<SequentialLineSearchOptimizer> GetOptimizer(const SessionId session_id);
+
+        /// \brief Write the snapshot of a session (see `SequentialLineSearchOptimizer::Save`) after its queued jobs
+        /// finish.
+        void SaveSession(const SessionId session_id, const std::string& file_path);
+
+        /// \brief Evict the sessions that have been neither accessed nor submitted to for the given duration.
+        ///
+        /// \return The number of evicted sessions.
+        int EvictIdleSessions(const Clock::duration idle_duration);
+
+        /// \brief Block until all the queued jobs finish.
+        void WaitForAllJobs();
+
+        int GetNumSessions() const;
+        int GetNumResidentSessions() const;
+
+    private:
+        struct Job
+        {
+            SessionId         session_id;
+            double            slider_position;
+            Clock::time_point deadline;
+
+            /// \brief The submission order, used for breaking ties.
+            std::uint64_t sequence;
+
+            std::shared_future<void>            future;
+            std::shared_ptr<std::promise<void>> promise;
+
+            std::function<void(const std::shared_future<void>&)> on_completed;
+        };
+
+        struct Session
+        {
+            /// \brief Null while the session is evicted.
+            std::shared_ptr<SequentialLineSearchOptimizer> optimizer;
+
+            int priority;
+
+            /// \brief The jobs waiting for the previous job of this session. The front one is the next to run.
+            std::deque<Job> jobs;
+
+            bool is_running;
+            bool is_removed;
+
+            /// \brief Whether the snapshot of this session is being written or read without the lock. The session
+            /// neither accepts jobs nor is erased until the transfer ends.
+            bool is_transferring;
+
+            Clock::time_point last_access_time;
+
+            /// \brief The size of the data, cached for estimating the memory of a job without copying the data. It is
+            /// updated when a job finishes.
+            int num_dims;
+            int num_data_points;
+        };
+
+        /// \brief Entry of a session whose next job is ready (i.e., which has queued jobs and is not running). The most
+        /// urgent job comes first: the earliest deadline, then the highest priority, then the oldest one.
+        struct ReadySession
+        {
+            Clock::time_point deadline;
+            int               priority;
+            std::uint64_t     sequence;
+            SessionId         session_id;
+
+            bool operator<(const ReadySession& other) const
+            {
+                if (deadline != other.deadline)
+                {
+                    return deadline < other.deadline;
+                }
+                if (priority != other.priority)
+                {
+                    return priority > other.priority;
+                }
+                return sequence < other.sequence;
+            }
+        };
+
+        const std::size_t m_max_in_flight_memory;
+        const int         m_max_num_resident_sessions;
+        const std::string m_eviction_directory_path;
+
+        mutable std::mutex m_mutex;
+
+        /// \brief Notified when a job or a snapshot transfer finishes.
+        std::condition_variable m_jobs_done_condition;
+
+        std::unordered_map<SessionId, Session> m_sessions;
+        SessionId                              m_next_session_id;
+
+        /// \brief The sessions whose next jobs are ready, ordered by urgency, so that the next job is found in
+        /// O(log S) instead of scanning all the sessions.
+        std::set<ReadySession> m_ready_sessions;
+
+        std::uint64_t                          m_next_job_sequence;
+
+        int         m_num_in_flight_jobs;
+        std::size_t m_in_flight_memory;
+        int         m_num_queued_jobs;
+        int         m_num_transfers;
+
+        /// \brief Declared last so that the workers are stopped before the other members are destroyed.
+        ThreadPool m_thread_pool;
+
+        /// \brief A non-owning reference to `m_thread_pool`, given to the hosted optimizers as their executor.
+        const std::shared_ptr<Executor> m_executor;
+
+        /// \brief Dispatch ready jobs to the pool as long as the limits allow. Called with `m_mutex` held.
+        void DispatchJobs();
+
+        /// \brief Run a job on a worker.
+        void RunJob(const Job& job, const std::shared_ptr<SequentialLineSearchOptimizer>& optimizer);
+
+        /// \brief Called with `m_mutex` held.
+        Session& FindSession(const SessionId session_id);
+
+        /// \brief Make the entry of `m_ready_sessions` for the next job of a session.
+        static ReadySession MakeReadySession(const SessionId session_id, const Session& session);
+
+        static bool IsReady(const Session& session) { return !session.is_running && !session.jobs.empty(); }
+
+        /// \brief Restore the session if it has been evicted. Called with `m_mutex` held via `lock`, which is
+        /// released while the snapshot file is read.
+        Session& MakeResident(std::unique_lock<std::mutex>& lock, const SessionId session_id);
+
+        /// \brief Save the idle sessions to their snapshot files and release their optimizers. A session whose
+        /// snapshot cannot be written stays resident. Called with `m_mutex` held via `lock`, which is released while
+        /// the snapshot files are written.
+        ///
+        /// \return The number of evicted sessions.
+        int Evict(std::unique_lock<std::mutex>& lock, const std::vector<SessionId>& session_ids);
+
+        /// \brief Evict the least recently used idle sessions (except the given one) until the number of resident
+        /// sessions is within the limit. Called with `m_mutex` held via `lock`, which may be released in between.
+        void EnforceResidentLimit(std::unique_lock<std::mutex>& lock, const SessionId protected_session_id);
+
+        /// \brief Called with `m_mutex` held.
+        void BeginTransfer(Session& session);
+
+        /// \brief Called with `m_mutex` held. A session removed during the transfer is erased here.
+        ///
+        /// \return Whether the session is still hosted.
+        bool EndTransfer(const SessionId session_id);
+
+        /// \brief Stop hosting a session that has neither jobs nor transfers. Called with `m_mutex` held.
+        void EraseSession(const SessionId session_id);
+
+        std::string GetSnapshotPath(const SessionId session_id) const;
+
+        /// \brief Roughly estimate the peak memory (in bytes) of a job from the size of the data.
+        static std::size_t EstimateJobMemory(const int num_dims, const int num_data_points);
+    };
+} // namespace sequential_line_search
+
+#endif // SEQUENTIAL_LINE_SEARCH_SESSION_MANAGER_HPP
@@ -0,0 +1,40 @@
+#ifndef SEQUENTIAL_LINE_SEARCH_SLIDER_GEOMETRY_HPP
+#define SEQUENTIAL_LINE_SEARCH_SLIDER_GEOMETRY_HPP
+
+#include <Eigen/Core>
+#include <utility>
+
+namespace sequential_line_search
+{
+    /// \brief Closed-form geometric operations on slider spaces (i.e., line segments) in an axis-aligned box.
+    ///
+    /// \details All the functions take the bounds of the box, [lower, upper]. When they are empty, the unit box
+    /// [0, 1]^{D} is used.
+    namespace slider_geometry
+    {
+        /// \brief Calculate the range of t such that `origin + t * direction` lies in the box.
+        ///
+        /// \details This is computed by intersecting the slabs of the box in O(D). If the line does not intersect the
+        /// box, the returned range is empty (i.e., the first value is larger than the second one).
+        std::pair<double, double> CalcLineBoxIntersection(const Eigen::VectorXd& origin,
+                                                          const Eigen::VectorXd& direction,
+                                                          const Eigen::VectorXd& lower = {},
+                                                          const Eigen::VectorXd& upper = {});
+
+        /// \brief Enlarge a slider by the specified scale around its center while keeping it in the box.
+        ///
+        /// \details Each end-point is moved outward until it reaches either the scaled position or the boundary of the
+        /// box. If the resulting slider is shorter than `minimum_length`, both end-points are further moved outward
+        /// evenly; when one of them reaches the boundary, the other one takes over the remaining length. The slider
+        /// never leaves the box, so it can be shorter than `minimum_length` only when the box is too small along the
+        /// slider direction.
+        std::pair<Eigen::VectorXd, Eigen::VectorXd> EnlargeSliderEnds(const Eigen::VectorXd& end_0,
+                                                                      const Eigen::VectorXd& end_1,
+                                                                      const double           scale,
+                                                                      const double           minimum_length,
+                                                                      const Eigen::VectorXd& lower = {},
+                                                                      const Eigen::VectorXd& upper = {});
+    } // namespace slider_geometry
+} // namespace sequential_line_search
+
+#endif // SEQUENTIAL_LINE_SEARCH_SLIDER_GEOMETRY_HPP
@@ -13,11 +13,16 @@ namespace sequential_line_search
         /// \param end_1 The second end-point, which is expected to be x^{EI} in [Koyama+17]
         ///
         /// \param enlarge When this is true, the slider enlargement post-processing will be performed.
+        ///
+        /// \param lower The lower bound of the search space used in the enlargement. When this is empty, the search
+        /// space is regarded as [0, 1]^{D}. The same applies to `upper`.
         Slider(const Eigen::VectorXd& end_0,
                const Eigen::VectorXd& end_1,
                const bool             enlarge,
                const double           scale          = 1.25,
-               const double           minimum_length = 0.25);
+               const double           minimum_length = 0.25,
+               const Eigen::VectorXd& lower          = {},
+               const Eigen::VectorXd& upper          = {});
 
         Eigen::VectorXd GetValue(const double t) const { return (1.0 - t) * end_0 + t * end_1; }
 
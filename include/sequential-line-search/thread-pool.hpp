@@ -0,0 +1,68 @@
+#ifndef SEQUENTIAL_LINE_SEARCH_THREAD_POOL_HPP
+#define SEQUENTIAL_LINE_SEARCH_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sequential-line-search/executor.hpp>
+#include <thread>
+#include <vector>
+
+namespace sequential_line_search
+{
+    /// \brief A fixed-size pool of persistent worker threads with work stealing.
+    ///
+    /// \details Each worker has its own task queue. A task submitted from a worker is pushed to that worker's queue
+    /// and the worker pops its own tasks in LIFO order, which keeps nested tasks cache-friendly; an idle worker steals
+    /// the oldest task from the other queues. Tasks submitted from outside the pool are distributed over the queues
+    /// in a round-robin manner.
+    class ThreadPool : public Executor
+    {
+    public:
+        /// \param num_threads The number of worker threads. When a non-positive value is specified, the number of
+        /// hardware threads is used.
+        explicit ThreadPool(const int num_threads = 0);
+
+        /// \brief Run all the submitted tasks to completion and join the workers.
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /// \brief Submit a task. The task must not throw.
+        void Submit(std::function<void()> task) override;
+
+        int GetConcurrency() const override { return GetNumThreads(); }
+
+        int GetNumThreads() const { return m_threads.size(); }
+
+    private:
+        struct WorkerQueue
+        {
+            std::mutex                        mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+        std::vector<std::thread>                  m_threads;
+
+        /// \brief Guards `m_num_pending_tasks` and `m_is_stopping`, and is used for putting idle workers to sleep.
+        std::mutex              m_mutex;
+        std::condition_variable m_condition;
+        int                     m_num_pending_tasks;
+        bool                    m_is_stopping;
+
+        /// \brief The queue that the next task submitted from outside the pool is pushed to.
+        std::atomic<unsigned> m_next_queue_index;
+
+        void RunWorker(const int worker_index);
+
+        /// \brief Pop a task from the worker's own queue, or steal one from the others.
+        bool PopTask(const int worker_index, std::function<void()>* task);
+    };
+} // namespace sequential_line_search
+
+#endif // SEQUENTIAL_LINE_SEARCH_THREAD_POOL_HPP
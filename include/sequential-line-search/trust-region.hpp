@@ -0,0 +1,69 @@
+#ifndef SEQUENTIAL_LINE_SEARCH_TRUST_REGION_HPP
+#define SEQUENTIAL_LINE_SEARCH_TRUST_REGION_HPP
+
+#include <Eigen/Core>
+#include <iosfwd>
+#include <memory>
+#include <utility>
+
+namespace sequential_line_search
+{
+    /// \brief An adaptive box around the incumbent to which the acquisition function maximization is restricted.
+    ///
+    /// \details This follows TuRBO [Eriksson et al. NeurIPS 2019]. The box is centered at the incumbent, and its edge
+    /// lengths are proportional to the ARD length scales of the kernel, normalized so that their geometric mean is the
+    /// base length. The base length is doubled after consecutive successes and halved after consecutive failures. When
+    /// it becomes shorter than the minimum length, it is reset to the initial length.
+    ///
+    /// In high-dimensional problems, the acquisition function over the whole search space tends to be maximized at
+    /// points near the boundary, which are rarely informative. Restricting the search to a local region avoids such
+    /// points and also bounds the computational cost of each search.
+    class TrustRegion
+    {
+    public:
+        /// \param initial_length The initial base length of the box (relative to the search space [0, 1]^{D}).
+        ///
+        /// \param min_length The base length below which the box is reset. The default value, 2^{-7}, follows TuRBO.
+        ///
+        /// \param success_tolerance The number of consecutive successes for expanding the box.
+        ///
+        /// \param failure_tolerance The number of consecutive failures for shrinking the box. When a non-positive value
+        /// is specified, max(4, D) is used as in TuRBO.
+        TrustRegion(const int    num_dims,
+                    const double initial_length    = 0.8,
+                    const double min_length        = 0.0078125,
+                    const double max_length        = 1.6,
+                    const int    success_tolerance = 3,
+                    const int    failure_tolerance = 0);
+
+        /// \brief Report whether the last iteration improved the incumbent, and expand or shrink the box accordingly.
+        void Update(const bool is_improved);
+
+        /// \brief Calculate the lower and upper bounds of the box clipped to [0, 1]^{D}.
+        ///
+        /// \param length_scales The ARD length scales of the kernel. When this is empty, the box is a hypercube.
+        std::pair<Eigen::VectorXd, Eigen::VectorXd> CalcBounds(const Eigen::VectorXd& center,
+                                                               const Eigen::VectorXd& length_scales = {}) const;
+
+        double GetLength() const { return m_length; }
+
+        /// \brief Write the settings and the current state in the binary snapshot format.
+        void Save(std::ostream& stream) const;
+
+        /// \brief Restore a trust region written by `Save`.
+        static std::shared_ptr<TrustRegion> Load(std::istream& stream);
+
+    private:
+        const double m_initial_length;
+        const double m_min_length;
+        const double m_max_length;
+        const int    m_success_tolerance;
+        const int    m_failure_tolerance;
+
+        double m_length;
+        int    m_success_count;
+        int    m_failure_count;
+    };
+} // namespace sequential_line_search
+
+#endif // SEQUENTIAL_LINE_SEARCH_TRUST_REGION_HPP
@@ -56,6 +56,12 @@ namespace sequential_line_search
         ////////////////////////////////////////////////
 
         void ExportMatrixToCsv(const std::string& file_path, const Eigen::MatrixXd& X);
+
+        /// \brief Read a matrix written by `ExportMatrixToCsv`.
+        ///
+        /// \details The file is parsed line by line, where each line is a row. Throws `std::runtime_error` if the file
+        /// cannot be opened or the rows have different numbers of elements.
+        Eigen::MatrixXd ImportMatrixFromCsv(const std::string& file_path);
     } // namespace utils
 } // namespace sequential_line_search
 
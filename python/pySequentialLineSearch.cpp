@@ -1,31 +1,258 @@
+#include <chrono>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
 #include <pybind11/eigen.h>
 #include <pybind11/functional.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <random>
+#include <sequential-line-search/acquisition-function.hpp>
+#include <sequential-line-search/gaussian-process-regressor.hpp>
+#include <sequential-line-search/preference-regressor.hpp>
+#include <sequential-line-search/preference.hpp>
 #include <sequential-line-search/preferential-bayesian-optimizer.hpp>
+#include <sequential-line-search/regressor.hpp>
 #include <sequential-line-search/sequential-line-search.hpp>
-
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using sequential_line_search::GaussianProcessHyperparamsPrior;
+using sequential_line_search::GaussianProcessRegressor;
+using sequential_line_search::PreferenceRegressor;
 using sequential_line_search::PreferentialBayesianOptimizer;
 using sequential_line_search::SequentialLineSearchOptimizer;
 namespace py = pybind11;
 using namespace py::literals;
 
+// Note: The methods that run the MAP estimation, the acquisition function maximization, or the predictions (or that
+// wait for them) release the GIL, so that other Python threads (e.g., ones serving other sessions or a GUI event loop)
+// keep running meanwhile. The arguments are converted before and the results after the release. The methods of an
+// optimizer other than the getters of its snapshot are serialized by a mutex of the optimizer (see `Exclusively`).
+using ReleaseGil = py::call_guard<py::gil_scoped_release>;
+
+// Note: Multiple points are passed as (n, d) NumPy arrays, one point per row. A C-contiguous float64 array is mapped
+// without copying; its transpose is the D x n (column-major) matrix that the library takes.
+using RowMajorMatrixXd = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+namespace
+{
+    /// \brief Entry of the table of the optimizer mutexes.
+    struct OptimizerMutexEntry
+    {
+        std::weak_ptr<const void>   optimizer;
+        std::shared_ptr<std::mutex> mutex;
+    };
+
+    /// \brief Get the mutex that serializes the calls to an optimizer.
+    ///
+    /// \details The mutexes are kept in a table keyed by the address of the optimizer. An entry refers to its optimizer
+    /// weakly, so that it is replaced when the address is reused by a new optimizer. The entries of the destroyed
+    /// optimizers are removed each time the table has doubled. Must be called with the GIL held.
+    std::shared_ptr<std::mutex> GetOptimizerMutex(const std::shared_ptr<const void>& optimizer)
+    {
+        static std::unordered_map<const void*, OptimizerMutexEntry> table;
+        static std::size_t                                          num_entries_after_pruning = 0;
+
+        if (table.size() > 2 * num_entries_after_pruning + 16)
+        {
+            for (auto it = table.begin(); it != table.end();)
+            {
+                it = it->second.optimizer.expired() ? table.erase(it) : std::next(it);
+            }
+            num_entries_after_pruning = table.size();
+        }
+
+        OptimizerMutexEntry& entry = table[optimizer.get()];
+        if (entry.mutex == nullptr || entry.optimizer.expired())
+        {
+            entry.optimizer = optimizer;
+            entry.mutex     = std::make_shared<std::mutex>();
+        }
+        return entry.mutex;
+    }
+
+    /// \brief Call `function` on an optimizer with the GIL released and the mutex of the optimizer locked.
+    ///
+    /// \details The optimizers require their methods other than the getters of the snapshot to be called from one
+    /// thread at a time. The GIL is released before locking, since the thread holding the lock may need the GIL (e.g.,
+    /// for calling an initial query generator written in Python).
+    template <typename Optimizer, typename Function>
+    auto CallExclusively(const std::shared_ptr<Optimizer>& optimizer, const Function& function)
+        -> decltype(function(*optimizer))
+    {
+        const std::shared_ptr<std::mutex> mutex = GetOptimizerMutex(optimizer);
+
+        py::gil_scoped_release      release;
+        std::lock_guard<std::mutex> lock(*mutex);
+
+        return function(*optimizer);
+    }
+
+    /// \brief Method of an optimizer bound so that it is called by `CallExclusively`.
+    template <typename Optimizer, typename Result, typename... Args> struct ExclusiveMethod
+    {
+        std::function<Result(Optimizer&, Args...)> method;
+
+        Result operator()(const std::shared_ptr<Optimizer>& optimizer, Args... args) const
+        {
+            return CallExclusively(optimizer, [&](Optimizer& target) { return method(target, args...); });
+        }
+    };
+
+    /// \brief Bind a method of an optimizer so that it is called by `CallExclusively`.
+    template <typename Optimizer, typename Result, typename... Args>
+    ExclusiveMethod<Optimizer, Result, Args...> Exclusively(Result (Optimizer::*method)(Args...))
+    {
+        return {std::mem_fn(method)};
+    }
+
+    /// \brief Bind a const method of an optimizer so that it is called by `CallExclusively`.
+    template <typename Optimizer, typename Result, typename... Args>
+    ExclusiveMethod<Optimizer, Result, Args...> Exclusively(Result (Optimizer::*method)(Args...) const)
+    {
+        return {std::mem_fn(method)};
+    }
+
+    /// \brief Write the binary snapshot of an optimizer (see `Save`) into a bytes object for pickling.
+    template <typename Optimizer> py::bytes SaveToBytes(const std::shared_ptr<Optimizer>& optimizer)
+    {
+        // Saving waits for a pending asynchronous update
+        const std::string state = CallExclusively(optimizer,
+                                                  [](const Optimizer& target)
+                                                  {
+                                                      std::ostringstream stream(std::ios::out | std::ios::binary);
+                                                      target.Save(stream);
+                                                      return stream.str();
+                                                  });
+        return py::bytes(state);
+    }
+
+    /// \brief Restore an optimizer from a bytes object written by `SaveToBytes`.
+    template <typename Optimizer> std::shared_ptr<Optimizer> LoadFromBytes(const py::bytes& state)
+    {
+        std::istringstream stream(static_cast<std::string>(state), std::ios::in | std::ios::binary);
+        return Optimizer::Load(stream);
+    }
+
+    /// \brief Check that there is a target value for each data point (i.e., each row of `X`).
+    void CheckTargets(const Eigen::Ref<const RowMajorMatrixXd>& X, const Eigen::VectorXd& y)
+    {
+        if (y.size() != X.rows())
+        {
+            throw py::value_error("The size of y (" + std::to_string(y.size()) +
+                                  ") does not match the number of data points (" + std::to_string(X.rows()) + ").");
+        }
+    }
+
+    /// \brief Check that each preference has two or more indices, all of which refer to the data points (i.e., the
+    /// rows of `X`).
+    void CheckPreferences(const Eigen::Ref<const RowMajorMatrixXd>& X,
+                          const std::vector<std::vector<unsigned>>& preferences)
+    {
+        for (const auto& preference : preferences)
+        {
+            if (preference.size() < 2)
+            {
+                throw py::value_error("Each preference must have two or more indices.");
+            }
+            for (const unsigned index : preference)
+            {
+                if (static_cast<Eigen::Index>(index) >= X.rows())
+                {
+                    throw py::value_error("The index " + std::to_string(index) +
+                                          " is out of the data points (" + std::to_string(X.rows()) + ").");
+                }
+            }
+        }
+    }
+
+    /// \brief Check that points (a vector or the rows of an array) have the dimension of the regressor.
+    void CheckNumDims(const sequential_line_search::Regressor& regressor,
+                      const Eigen::Index                       num_dims,
+                      const std::string&                       name = "points")
+    {
+        if (num_dims != static_cast<Eigen::Index>(regressor.GetNumDims()))
+        {
+            throw py::value_error("The dimension of the " + name + " (" + std::to_string(num_dims) +
+                                  ") does not match that of the regressor (" +
+                                  std::to_string(regressor.GetNumDims()) + ").");
+        }
+    }
+
+    /// \brief Check that there is a hyperparameter for the signal variance and the length scale of each dimension.
+    void CheckKernelHyperparams(const Eigen::Ref<const RowMajorMatrixXd>& X, const Eigen::VectorXd& kernel_hyperparams)
+    {
+        if (kernel_hyperparams.size() != X.cols() + 1)
+        {
+            throw py::value_error("The size of kernel_hyperparams (" + std::to_string(kernel_hyperparams.size()) +
+                                  ") must be the dimension of the data points plus one (" +
+                                  std::to_string(X.cols() + 1) + ").");
+        }
+    }
+} // namespace
+
 PYBIND11_MODULE(pySequentialLineSearch, m)
 {
     py::enum_<sequential_line_search::CurrentBestSelectionStrategy>(m, "CurrentBestSelectionStrategy", py::arithmetic())
         .value("LargestExpectValue", sequential_line_search::CurrentBestSelectionStrategy::LargestExpectValue)
         .value("LastSelection", sequential_line_search::CurrentBestSelectionStrategy::LastSelection);
 
+    py::enum_<sequential_line_search::RetentionPolicy>(m, "RetentionPolicy", py::arithmetic())
+        .value("KeepAll", sequential_line_search::RetentionPolicy::KeepAll)
+        .value("SlidingWindow", sequential_line_search::RetentionPolicy::SlidingWindow)
+        .value("DropDominatedFar", sequential_line_search::RetentionPolicy::DropDominatedFar)
+        .value("Thinning", sequential_line_search::RetentionPolicy::Thinning);
+
+    py::enum_<sequential_line_search::JournalSyncPolicy>(m, "JournalSyncPolicy", py::arithmetic())
+        .value("EveryRecord", sequential_line_search::JournalSyncPolicy::EveryRecord)
+        .value("EveryNRecords", sequential_line_search::JournalSyncPolicy::EveryNRecords)
+        .value("OnClose", sequential_line_search::JournalSyncPolicy::OnClose);
+
     py::enum_<sequential_line_search::AcquisitionFuncType>(m, "AcquisitionFuncType", py::arithmetic())
         .value("ExpectedImprovement", sequential_line_search::AcquisitionFuncType::ExpectedImprovement)
         .value("GaussianProcessUpperConfidenceBound",
-               sequential_line_search::AcquisitionFuncType::GaussianProcessUpperConfidenceBound);
+               sequential_line_search::AcquisitionFuncType::GaussianProcessUpperConfidenceBound)
+        .value("ThompsonSampling", sequential_line_search::AcquisitionFuncType::ThompsonSampling);
 
     py::enum_<sequential_line_search::KernelType>(m, "KernelType", py::arithmetic())
         .value("ArdSquaredExponentialKernel", sequential_line_search::KernelType::ArdSquaredExponentialKernel)
         .value("ArdMatern52Kernel", sequential_line_search::KernelType::ArdMatern52Kernel);
 
-    py::class_<SequentialLineSearchOptimizer> seq_opt_class(m, "SequentialLineSearchOptimizer");
+    // Note: Awaiting a pending update (in a coroutine) waits for it on a thread of the default executor of the running
+    // event loop, so the event loop itself is not blocked
+    py::class_<std::shared_future<void>> pending_update_class(m, "PendingUpdate");
+
+    pending_update_class.def(
+        "wait", [](const std::shared_future<void>& pending_update) { pending_update.get(); }, ReleaseGil());
+
+    pending_update_class.def("done",
+                             [](const std::shared_future<void>& pending_update)
+                             {
+                                 return pending_update.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+                             });
+
+    pending_update_class.def("__await__",
+                             [](const std::shared_future<void>& pending_update)
+                             {
+                                 const py::object wait = py::cpp_function(
+                                     [pending_update]()
+                                     {
+                                         py::gil_scoped_release release;
+                                         pending_update.get();
+                                     });
+                                 const py::object loop = py::module::import("asyncio").attr("get_running_loop")();
+
+                                 return loop.attr("run_in_executor")(py::none(), wait).attr("__await__")();
+                             });
+
+    // Note: The holder type is std::shared_ptr since `load` returns one
+    py::class_<SequentialLineSearchOptimizer, std::shared_ptr<SequentialLineSearchOptimizer>> seq_opt_class(
+        m, "SequentialLineSearchOptimizer");
 
     seq_opt_class.def(
         py::init<const int,
@@ -45,7 +272,7 @@ PYBIND11_MODULE(pySequentialLineSearch, m)
         "current_best_selection_strategy"_a = sequential_line_search::CurrentBestSelectionStrategy::LargestExpectValue);
 
     seq_opt_class.def("set_hyperparams",
-                      &SequentialLineSearchOptimizer::SetHyperparams,
+                      Exclusively(&SequentialLineSearchOptimizer::SetHyperparams),
                       "kernel_signal_var"_a            = 0.500,
                       "kernel_length_scale"_a          = 0.500,
                       "noise_level"_a                  = 0.005,
@@ -53,42 +280,181 @@ PYBIND11_MODULE(pySequentialLineSearch, m)
                       "btl_scale"_a                    = 0.010);
 
     seq_opt_class.def("submit_feedback_data",
-                      static_cast<void (SequentialLineSearchOptimizer::*)(const double)>(
-                          &SequentialLineSearchOptimizer::SubmitFeedbackData),
+                      Exclusively(static_cast<void (SequentialLineSearchOptimizer::*)(const double)>(
+                          &SequentialLineSearchOptimizer::SubmitFeedbackData)),
                       "slider_position"_a);
 
     seq_opt_class.def(
         "submit_feedback_data",
-        static_cast<void (SequentialLineSearchOptimizer::*)(const double, const int, const int, const int)>(
-            &SequentialLineSearchOptimizer::SubmitFeedbackData),
+        Exclusively(
+            static_cast<void (SequentialLineSearchOptimizer::*)(const double, const int, const int, const int)>(
+                &SequentialLineSearchOptimizer::SubmitFeedbackData)),
         "slider_position"_a,
         "num_map_estimation_iters"_a,
         "num_global_search_iters"_a,
         "num_local_search_iters"_a);
 
+    // Note: The returned `PendingUpdate` can be waited for, or awaited in a coroutine. The worker never calls back into
+    // Python, so it does not need the GIL.
+    seq_opt_class.def(
+        "submit_feedback_data_async",
+        [](const std::shared_ptr<SequentialLineSearchOptimizer>& optimizer,
+           const double                                          slider_position,
+           const int                                             num_map_estimation_iters,
+           const int                                             num_global_search_iters,
+           const int                                             num_local_search_iters)
+        {
+            return CallExclusively(optimizer,
+                                   [&](SequentialLineSearchOptimizer& target)
+                                   {
+                                       return target.SubmitFeedbackDataAsync(slider_position,
+                                                                             num_map_estimation_iters,
+                                                                             num_global_search_iters,
+                                                                             num_local_search_iters);
+                                   });
+        },
+        "slider_position"_a,
+        "num_map_estimation_iters"_a = 0,
+        "num_global_search_iters"_a  = 0,
+        "num_local_search_iters"_a   = 0);
+
+    seq_opt_class.def("wait_for_pending_update", Exclusively(&SequentialLineSearchOptimizer::WaitForPendingUpdate));
+
+    seq_opt_class.def("generate_slider_batch",
+                      Exclusively(&SequentialLineSearchOptimizer::GenerateSliderBatch),
+                      "num_sliders"_a,
+                      "num_map_estimation_iters"_a = 0,
+                      "num_global_search_iters"_a  = 0,
+                      "num_local_search_iters"_a   = 0);
+
+    seq_opt_class.def("submit_batch_feedback_data",
+                      Exclusively(&SequentialLineSearchOptimizer::SubmitBatchFeedbackData),
+                      "slider_index"_a,
+                      "slider_position"_a);
+
+    seq_opt_class.def("get_num_batch_sliders", Exclusively(&SequentialLineSearchOptimizer::GetNumBatchSliders));
+
+    seq_opt_class.def("get_batch_slider_ends",
+                      Exclusively(&SequentialLineSearchOptimizer::GetBatchSliderEnds),
+                      "slider_index"_a);
+
+    seq_opt_class.def("calc_point_from_batch_slider_position",
+                      Exclusively(&SequentialLineSearchOptimizer::CalcPointFromBatchSliderPosition),
+                      "slider_index"_a,
+                      "slider_position"_a);
+
     seq_opt_class.def("get_slider_ends", &SequentialLineSearchOptimizer::GetSliderEnds);
 
     seq_opt_class.def("calc_point_from_slider_position",
                       &SequentialLineSearchOptimizer::CalcPointFromSliderPosition,
                       "slider_position"_a);
 
+    seq_opt_class.def(
+        "calc_points_from_slider_positions",
+        [](const SequentialLineSearchOptimizer& optimizer, const Eigen::VectorXd& slider_positions)
+        { return RowMajorMatrixXd(optimizer.CalcPointsFromSliderPositions(slider_positions).transpose()); },
+        "slider_positions"_a);
+
+    seq_opt_class.def(
+        "sample_slider",
+        [](const SequentialLineSearchOptimizer& optimizer, const int num_samples)
+        { return RowMajorMatrixXd(optimizer.SampleSlider(num_samples).transpose()); },
+        "num_samples"_a);
+
     seq_opt_class.def("get_maximizer", &SequentialLineSearchOptimizer::GetMaximizer);
 
-    seq_opt_class.def("get_preference_value_mean", &SequentialLineSearchOptimizer::GetPreferenceValueMean, "point"_a);
+    seq_opt_class.def(
+        "get_preference_value_mean", &SequentialLineSearchOptimizer::GetPreferenceValueMean, ReleaseGil(), "point"_a);
 
-    seq_opt_class.def("get_preference_value_stdev", &SequentialLineSearchOptimizer::GetPreferenceValueStdev, "point"_a);
+    seq_opt_class.def(
+        "get_preference_value_stdev", &SequentialLineSearchOptimizer::GetPreferenceValueStdev, ReleaseGil(), "point"_a);
 
-    seq_opt_class.def("get_acquisition_func_value", &SequentialLineSearchOptimizer::GetAcquisitionFuncValue, "point"_a);
+    seq_opt_class.def(
+        "get_acquisition_func_value", &SequentialLineSearchOptimizer::GetAcquisitionFuncValue, ReleaseGil(), "point"_a);
+
+    seq_opt_class.def(
+        "get_preference_value_means",
+        [](const SequentialLineSearchOptimizer& optimizer, const Eigen::Ref<const RowMajorMatrixXd>& points)
+        {
+            Eigen::VectorXd mu;
+            optimizer.PredictPreferenceValues(points.transpose(), &mu, nullptr);
+            return mu;
+        },
+        ReleaseGil(),
+        "points"_a);
+
+    seq_opt_class.def(
+        "get_preference_value_stdevs",
+        [](const SequentialLineSearchOptimizer& optimizer, const Eigen::Ref<const RowMajorMatrixXd>& points)
+        {
+            Eigen::VectorXd sigma;
+            optimizer.PredictPreferenceValues(points.transpose(), nullptr, &sigma);
+            return sigma;
+        },
+        ReleaseGil(),
+        "points"_a);
 
     seq_opt_class.def("get_raw_data_points", &SequentialLineSearchOptimizer::GetRawDataPoints);
 
-    seq_opt_class.def("damp_data", &SequentialLineSearchOptimizer::DampData, "directory_path"_a);
+    seq_opt_class.def("damp_data", Exclusively(&SequentialLineSearchOptimizer::DampData), "directory_path"_a);
+
+    seq_opt_class.def("save",
+                      Exclusively(static_cast<void (SequentialLineSearchOptimizer::*)(const std::string&) const>(
+                          &SequentialLineSearchOptimizer::Save)),
+                      "file_path"_a);
+
+    seq_opt_class.def_static(
+        "load",
+        [](const std::string& file_path) { return SequentialLineSearchOptimizer::Load(file_path); },
+        "file_path"_a);
+
+    // Note: Pickling (and thus copying or sending an optimizer to another process) uses the same binary snapshot as
+    // `save`, so a custom initial query generator is not carried over
+    seq_opt_class.def(
+        py::pickle(&SaveToBytes<SequentialLineSearchOptimizer>, &LoadFromBytes<SequentialLineSearchOptimizer>));
 
     seq_opt_class.def("set_gaussian_process_upper_confidence_bound_hyperparam",
-                      &SequentialLineSearchOptimizer::SetGaussianProcessUpperConfidenceBoundHyperparam,
+                      Exclusively(&SequentialLineSearchOptimizer::SetGaussianProcessUpperConfidenceBoundHyperparam),
                       "hyperparam"_a);
-
-    py::class_<PreferentialBayesianOptimizer> pref_opt_class(m, "PreferentialBayesianOptimizer");
+    seq_opt_class.def("set_warm_start_acquisition_search",
+                      Exclusively(&SequentialLineSearchOptimizer::SetWarmStartAcquisitionSearch),
+                      "use_warm_start"_a,
+                      "random_start_fraction"_a = 0.25);
+    seq_opt_class.def("set_trust_region_acquisition_search",
+                      Exclusively(&SequentialLineSearchOptimizer::SetTrustRegionAcquisitionSearch),
+                      "use_trust_region"_a);
+    seq_opt_class.def("set_data_retention_policy",
+                      Exclusively(&SequentialLineSearchOptimizer::SetDataRetentionPolicy),
+                      "policy"_a,
+                      "max_num_data_points"_a);
+    seq_opt_class.def("set_speculative_slider_computation",
+                      Exclusively(&SequentialLineSearchOptimizer::SetSpeculativeSliderComputation),
+                      "use_speculation"_a,
+                      "num_speculations"_a = 3,
+                      "tolerance"_a        = 0.02);
+    seq_opt_class.def("enable_feedback_journal",
+                      Exclusively(&SequentialLineSearchOptimizer::EnableFeedbackJournal),
+                      "file_path"_a,
+                      "sync_policy"_a   = sequential_line_search::JournalSyncPolicy::EveryRecord,
+                      "sync_interval"_a = 1);
+    seq_opt_class.def("disable_feedback_journal", Exclusively(&SequentialLineSearchOptimizer::DisableFeedbackJournal));
+    seq_opt_class.def("replay_feedback_journal",
+                      Exclusively(&SequentialLineSearchOptimizer::ReplayFeedbackJournal),
+                      "file_path"_a,
+                      "num_map_estimation_iters"_a = 0,
+                      "num_global_search_iters"_a  = 0,
+                      "num_local_search_iters"_a   = 0);
+    seq_opt_class.def("import_data",
+                      Exclusively(
+                          static_cast<void (SequentialLineSearchOptimizer::*)(const std::string&, int, int, int)>(
+                              &SequentialLineSearchOptimizer::ImportData)),
+                      "directory_path"_a,
+                      "num_map_estimation_iters"_a = 0,
+                      "num_global_search_iters"_a  = 0,
+                      "num_local_search_iters"_a   = 0);
+
+    py::class_<PreferentialBayesianOptimizer, std::shared_ptr<PreferentialBayesianOptimizer>> pref_opt_class(
+        m, "PreferentialBayesianOptimizer");
 
     pref_opt_class.def(py::init<const int,
                                 const bool,
@@ -108,7 +474,7 @@ PYBIND11_MODULE(pySequentialLineSearch, m)
                        "num_options"_a = 2);
 
     pref_opt_class.def("set_hyperparams",
-                       &PreferentialBayesianOptimizer::SetHyperparams,
+                       Exclusively(&PreferentialBayesianOptimizer::SetHyperparams),
                        "kernel_signal_var"_a            = 0.500,
                        "kernel_length_scale"_a          = 0.500,
                        "noise_level"_a                  = 0.005,
@@ -116,38 +482,419 @@ PYBIND11_MODULE(pySequentialLineSearch, m)
                        "btl_scale"_a                    = 0.010);
 
     pref_opt_class.def("submit_feedback_data",
-                       &PreferentialBayesianOptimizer::SubmitFeedbackData,
+                       Exclusively(&PreferentialBayesianOptimizer::SubmitFeedbackData),
                        "option_index"_a,
                        "num_map_estimation_iters"_a = 0);
 
     pref_opt_class.def("submit_custom_feedback_data",
-                       &PreferentialBayesianOptimizer::SubmitCustomFeedbackData,
+                       Exclusively(&PreferentialBayesianOptimizer::SubmitCustomFeedbackData),
                        "chosen_option"_a,
                        "other_options"_a,
                        "num_map_estimation_iters"_a = 0);
 
     pref_opt_class.def("determine_next_query",
-                       &PreferentialBayesianOptimizer::DetermineNextQuery,
+                       Exclusively(&PreferentialBayesianOptimizer::DetermineNextQuery),
                        "num_global_search_iters"_a = 0,
                        "num_local_search_iters"_a  = 0);
 
+    pref_opt_class.def(
+        "submit_feedback_data_async",
+        [](const std::shared_ptr<PreferentialBayesianOptimizer>& optimizer,
+           const int                                             option_index,
+           const int                                             num_map_estimation_iters,
+           const int                                             num_global_search_iters,
+           const int                                             num_local_search_iters)
+        {
+            return CallExclusively(optimizer,
+                                   [&](PreferentialBayesianOptimizer& target)
+                                   {
+                                       return target.SubmitFeedbackDataAsync(option_index,
+                                                                             num_map_estimation_iters,
+                                                                             num_global_search_iters,
+                                                                             num_local_search_iters);
+                                   });
+        },
+        "option_index"_a,
+        "num_map_estimation_iters"_a = 0,
+        "num_global_search_iters"_a  = 0,
+        "num_local_search_iters"_a   = 0);
+
+    pref_opt_class.def("wait_for_pending_update", Exclusively(&PreferentialBayesianOptimizer::WaitForPendingUpdate));
+
     pref_opt_class.def("get_current_options", &PreferentialBayesianOptimizer::GetCurrentOptions);
 
     pref_opt_class.def("get_maximizer", &PreferentialBayesianOptimizer::GetMaximizer);
 
-    pref_opt_class.def("get_preference_value_mean", &PreferentialBayesianOptimizer::GetPreferenceValueMean, "point"_a);
+    pref_opt_class.def(
+        "get_preference_value_mean", &PreferentialBayesianOptimizer::GetPreferenceValueMean, ReleaseGil(), "point"_a);
+
+    pref_opt_class.def(
+        "get_preference_value_stdev", &PreferentialBayesianOptimizer::GetPreferenceValueStdev, ReleaseGil(), "point"_a);
+
+    pref_opt_class.def(
+        "get_acquisition_func_value", &PreferentialBayesianOptimizer::GetAcquisitionFuncValue, ReleaseGil(), "point"_a);
 
     pref_opt_class.def(
-        "get_preference_value_stdev", &PreferentialBayesianOptimizer::GetPreferenceValueStdev, "point"_a);
+        "get_preference_value_means",
+        [](const PreferentialBayesianOptimizer& optimizer, const Eigen::Ref<const RowMajorMatrixXd>& points)
+        {
+            Eigen::VectorXd mu;
+            optimizer.PredictPreferenceValues(points.transpose(), &mu, nullptr);
+            return mu;
+        },
+        ReleaseGil(),
+        "points"_a);
 
     pref_opt_class.def(
-        "get_acquisition_func_value", &PreferentialBayesianOptimizer::GetAcquisitionFuncValue, "point"_a);
+        "get_preference_value_stdevs",
+        [](const PreferentialBayesianOptimizer& optimizer, const Eigen::Ref<const RowMajorMatrixXd>& points)
+        {
+            Eigen::VectorXd sigma;
+            optimizer.PredictPreferenceValues(points.transpose(), nullptr, &sigma);
+            return sigma;
+        },
+        ReleaseGil(),
+        "points"_a);
 
     pref_opt_class.def("get_raw_data_points", &PreferentialBayesianOptimizer::GetRawDataPoints);
 
-    pref_opt_class.def("damp_data", &PreferentialBayesianOptimizer::DampData, "directory_path"_a);
+    pref_opt_class.def("damp_data", Exclusively(&PreferentialBayesianOptimizer::DampData), "directory_path"_a);
+
+    pref_opt_class.def("save",
+                       Exclusively(static_cast<void (PreferentialBayesianOptimizer::*)(const std::string&) const>(
+                           &PreferentialBayesianOptimizer::Save)),
+                       "file_path"_a);
+
+    pref_opt_class.def_static(
+        "load",
+        [](const std::string& file_path) { return PreferentialBayesianOptimizer::Load(file_path); },
+        "file_path"_a);
+
+    // Note: See the note on pickling `SequentialLineSearchOptimizer`
+    pref_opt_class.def(
+        py::pickle(&SaveToBytes<PreferentialBayesianOptimizer>, &LoadFromBytes<PreferentialBayesianOptimizer>));
 
     pref_opt_class.def("set_gaussian_process_upper_confidence_bound_hyperparam",
-                       &PreferentialBayesianOptimizer::SetGaussianProcessUpperConfidenceBoundHyperparam,
+                       Exclusively(&PreferentialBayesianOptimizer::SetGaussianProcessUpperConfidenceBoundHyperparam),
                        "hyperparam"_a);
+    pref_opt_class.def("set_data_retention_policy",
+                       Exclusively(&PreferentialBayesianOptimizer::SetDataRetentionPolicy),
+                       "policy"_a,
+                       "max_num_data_points"_a);
+    pref_opt_class.def("enable_feedback_journal",
+                       Exclusively(&PreferentialBayesianOptimizer::EnableFeedbackJournal),
+                       "file_path"_a,
+                       "sync_policy"_a   = sequential_line_search::JournalSyncPolicy::EveryRecord,
+                       "sync_interval"_a = 1);
+    pref_opt_class.def("disable_feedback_journal", Exclusively(&PreferentialBayesianOptimizer::DisableFeedbackJournal));
+    pref_opt_class.def("replay_feedback_journal",
+                       Exclusively(&PreferentialBayesianOptimizer::ReplayFeedbackJournal),
+                       "file_path"_a,
+                       "num_map_estimation_iters"_a = 0);
+    pref_opt_class.def("import_data",
+                       Exclusively(static_cast<void (PreferentialBayesianOptimizer::*)(const std::string&, int)>(
+                           &PreferentialBayesianOptimizer::ImportData)),
+                       "directory_path"_a,
+                       "num_map_estimation_iters"_a = 0);
+
+    py::class_<sequential_line_search::Regressor, std::shared_ptr<sequential_line_search::Regressor>> regressor_class(
+        m, "Regressor");
+
+    // Note: The dimension of the points is checked before the GIL is released
+    regressor_class.def(
+        "predict_mu",
+        [](const sequential_line_search::Regressor& regressor, const Eigen::VectorXd& x)
+        {
+            CheckNumDims(regressor, x.size(), "point");
+
+            py::gil_scoped_release release;
+            return regressor.PredictMu(x);
+        },
+        "x"_a);
+
+    regressor_class.def(
+        "predict_sigma",
+        [](const sequential_line_search::Regressor& regressor, const Eigen::VectorXd& x)
+        {
+            CheckNumDims(regressor, x.size(), "point");
+
+            py::gil_scoped_release release;
+            return regressor.PredictSigma(x);
+        },
+        "x"_a);
+
+    regressor_class.def(
+        "predict_mu_derivative",
+        [](const sequential_line_search::Regressor& regressor, const Eigen::VectorXd& x)
+        {
+            CheckNumDims(regressor, x.size(), "point");
+
+            py::gil_scoped_release release;
+            return regressor.PredictMuDerivative(x);
+        },
+        "x"_a);
+
+    regressor_class.def(
+        "predict_sigma_derivative",
+        [](const sequential_line_search::Regressor& regressor, const Eigen::VectorXd& x)
+        {
+            CheckNumDims(regressor, x.size(), "point");
+
+            py::gil_scoped_release release;
+            return regressor.PredictSigmaDerivative(x);
+        },
+        "x"_a);
+
+    regressor_class.def(
+        "predict_mus",
+        [](const sequential_line_search::Regressor& regressor, const Eigen::Ref<const RowMajorMatrixXd>& points)
+        {
+            CheckNumDims(regressor, points.cols());
+
+            py::gil_scoped_release release;
+
+            Eigen::VectorXd mu;
+            regressor.PredictInBatch(points.transpose(), &mu, nullptr);
+            return mu;
+        },
+        "points"_a);
+
+    regressor_class.def(
+        "predict_sigmas",
+        [](const sequential_line_search::Regressor& regressor, const Eigen::Ref<const RowMajorMatrixXd>& points)
+        {
+            CheckNumDims(regressor, points.cols());
+
+            py::gil_scoped_release release;
+
+            Eigen::VectorXd sigma;
+            regressor.PredictInBatch(points.transpose(), nullptr, &sigma);
+            return sigma;
+        },
+        "points"_a);
+
+    regressor_class.def("get_num_dims", &sequential_line_search::Regressor::GetNumDims);
+
+    regressor_class.def("get_kernel_hyperparams", &sequential_line_search::Regressor::GetKernelHyperparams);
+
+    regressor_class.def("get_noise_hyperparam", &sequential_line_search::Regressor::GetNoiseHyperparam);
+
+    py::class_<GaussianProcessHyperparamsPrior> gp_hyperparams_prior_class(m, "GaussianProcessHyperparamsPrior");
+
+    gp_hyperparams_prior_class.def(py::init<>());
+    gp_hyperparams_prior_class.def_readwrite("use_log_normal_prior",
+                                             &GaussianProcessHyperparamsPrior::use_log_normal_prior);
+    gp_hyperparams_prior_class.def_readwrite("signal_var_mu", &GaussianProcessHyperparamsPrior::signal_var_mu);
+    gp_hyperparams_prior_class.def_readwrite("signal_var_sigma_squared",
+                                             &GaussianProcessHyperparamsPrior::signal_var_sigma_squared);
+    gp_hyperparams_prior_class.def_readwrite("noise_level_mu", &GaussianProcessHyperparamsPrior::noise_level_mu);
+    gp_hyperparams_prior_class.def_readwrite("noise_level_sigma_squared",
+                                             &GaussianProcessHyperparamsPrior::noise_level_sigma_squared);
+    gp_hyperparams_prior_class.def_readwrite("length_scale_mu", &GaussianProcessHyperparamsPrior::length_scale_mu);
+    gp_hyperparams_prior_class.def_readwrite("length_scale_sigma_squared",
+                                             &GaussianProcessHyperparamsPrior::length_scale_sigma_squared);
+
+    // Note: The data points are passed as an (n, d) array like the other batch methods. The GIL is released only
+    // during the fitting; the instance is registered to Python after it is reacquired.
+    py::class_<GaussianProcessRegressor, sequential_line_search::Regressor, std::shared_ptr<GaussianProcessRegressor>>
+        gp_regressor_class(m, "GaussianProcessRegressor");
+
+    gp_regressor_class.def(py::init(
+                               [](const Eigen::Ref<const RowMajorMatrixXd>& X,
+                                  const Eigen::VectorXd&                    y,
+                                  const sequential_line_search::KernelType  kernel_type,
+                                  const GaussianProcessHyperparamsPrior&    prior)
+                               {
+                                   CheckTargets(X, y);
+
+                                   py::gil_scoped_release release;
+                                   return std::make_shared<GaussianProcessRegressor>(
+                                       X.transpose(), y, kernel_type, prior);
+                               }),
+                           "X"_a,
+                           "y"_a,
+                           "kernel_type"_a = sequential_line_search::KernelType::ArdMatern52Kernel,
+                           "prior"_a       = GaussianProcessHyperparamsPrior());
+
+    gp_regressor_class.def(py::init(
+                               [](const Eigen::Ref<const RowMajorMatrixXd>& X,
+                                  const Eigen::VectorXd&                    y,
+                                  const Eigen::VectorXd&                    kernel_hyperparams,
+                                  const double                              noise_hyperparam,
+                                  const sequential_line_search::KernelType  kernel_type)
+                               {
+                                   CheckTargets(X, y);
+                                   CheckKernelHyperparams(X, kernel_hyperparams);
+
+                                   py::gil_scoped_release release;
+                                   return std::make_shared<GaussianProcessRegressor>(
+                                       X.transpose(), y, kernel_hyperparams, noise_hyperparam, kernel_type);
+                               }),
+                           "X"_a,
+                           "y"_a,
+                           "kernel_hyperparams"_a,
+                           "noise_hyperparam"_a,
+                           "kernel_type"_a = sequential_line_search::KernelType::ArdMatern52Kernel);
+
+    // Note: Each preference is a list of indices of the data points, the first of which is preferred to the others
+    py::class_<PreferenceRegressor, sequential_line_search::Regressor, std::shared_ptr<PreferenceRegressor>>
+        pref_regressor_class(m, "PreferenceRegressor");
+
+    pref_regressor_class.def(py::init(
+                                 [](const Eigen::Ref<const RowMajorMatrixXd>&   X,
+                                    const std::vector<std::vector<unsigned>>& preferences,
+                                    const bool                                use_map_hyperparams,
+                                    const double                              default_kernel_signal_var,
+                                    const double                              default_kernel_length_scale,
+                                    const double                              default_noise_level,
+                                    const double                              kernel_hyperparams_prior_var,
+                                    const double                              btl_scale,
+                                    const unsigned                            num_map_estimation_iters,
+                                    const sequential_line_search::KernelType  kernel_type)
+                                 {
+                                     CheckPreferences(X, preferences);
+
+                                     const std::vector<sequential_line_search::Preference> D(preferences.begin(),
+                                                                                             preferences.end());
+
+                                     py::gil_scoped_release release;
+                                     return std::make_shared<PreferenceRegressor>(X.transpose(),
+                                                                                  D,
+                                                                                  use_map_hyperparams,
+                                                                                  default_kernel_signal_var,
+                                                                                  default_kernel_length_scale,
+                                                                                  default_noise_level,
+                                                                                  kernel_hyperparams_prior_var,
+                                                                                  btl_scale,
+                                                                                  num_map_estimation_iters,
+                                                                                  kernel_type);
+                                 }),
+                             "X"_a,
+                             "preferences"_a,
+                             "use_map_hyperparams"_a          = false,
+                             "default_kernel_signal_var"_a    = 0.500,
+                             "default_kernel_length_scale"_a  = 0.500,
+                             "default_noise_level"_a          = 0.005,
+                             "kernel_hyperparams_prior_var"_a = 0.250,
+                             "btl_scale"_a                    = 0.010,
+                             "num_map_estimation_iters"_a     = 100,
+                             "kernel_type"_a                  = sequential_line_search::KernelType::ArdMatern52Kernel);
+
+    pref_regressor_class.def("find_arg_max", &PreferenceRegressor::FindArgMax, ReleaseGil());
+
+    py::module acquisition_func_module = m.def_submodule("acquisition_func");
+
+    acquisition_func_module.def(
+        "calc_acquisition_values",
+        [](const sequential_line_search::Regressor&          regressor,
+           const Eigen::Ref<const RowMajorMatrixXd>&         points,
+           const sequential_line_search::AcquisitionFuncType func_type,
+           const double                                      gaussian_process_upper_confidence_bound_hyperparam)
+        {
+            CheckNumDims(regressor, points.cols());
+
+            py::gil_scoped_release release;
+            return sequential_line_search::acquisition_func::CalcAcquisitionValuesInBatch(
+                regressor, points.transpose(), func_type, gaussian_process_upper_confidence_bound_hyperparam);
+        },
+        "regressor"_a,
+        "points"_a,
+        "func_type"_a = sequential_line_search::AcquisitionFuncType::ExpectedImprovement,
+        "gaussian_process_upper_confidence_bound_hyperparam"_a = 1.0);
+
+    // Note: Empty bounds mean the whole search space, [0, 1]^{D}. The seed is used for Thompson sampling; when it is
+    // None, the posterior function sample is drawn nondeterministically.
+    acquisition_func_module.def(
+        "find_next_point",
+        [](const sequential_line_search::Regressor&          regressor,
+           const unsigned                                    num_global_search_iters,
+           const unsigned                                    num_local_search_iters,
+           const sequential_line_search::AcquisitionFuncType func_type,
+           const double                                      gaussian_process_upper_confidence_bound_hyperparam,
+           const Eigen::VectorXd&                            lower,
+           const Eigen::VectorXd&                            upper,
+           const py::object&                                 seed)
+        {
+            if (lower.size() != 0)
+            {
+                CheckNumDims(regressor, lower.size(), "lower bound");
+            }
+            if (upper.size() != 0)
+            {
+                CheckNumDims(regressor, upper.size(), "upper bound");
+            }
+
+            std::unique_ptr<std::mt19937> random_engine;
+            if (!seed.is_none())
+            {
+                random_engine.reset(new std::mt19937(seed.cast<unsigned>()));
+            }
+
+            py::gil_scoped_release release;
+            return sequential_line_search::acquisition_func::FindNextPoint(
+                regressor,
+                num_global_search_iters,
+                num_local_search_iters,
+                func_type,
+                gaussian_process_upper_confidence_bound_hyperparam,
+                nullptr,
+                lower,
+                upper,
+                nullptr,
+                nullptr,
+                random_engine.get());
+        },
+        "regressor"_a,
+        "num_global_search_iters"_a = 100,
+        "num_local_search_iters"_a  = 50,
+        "func_type"_a               = sequential_line_search::AcquisitionFuncType::ExpectedImprovement,
+        "gaussian_process_upper_confidence_bound_hyperparam"_a = 1.0,
+        "lower"_a                                              = Eigen::VectorXd(),
+        "upper"_a                                              = Eigen::VectorXd(),
+        "seed"_a                                               = py::none());
+
+    // Note: The points are returned as an (n, d) array. The seed is used in the same way as in find_next_point.
+    acquisition_func_module.def(
+        "find_next_points",
+        [](const sequential_line_search::Regressor&          regressor,
+           const unsigned                                    num_points,
+           const unsigned                                    num_global_search_iters,
+           const unsigned                                    num_local_search_iters,
+           const sequential_line_search::AcquisitionFuncType func_type,
+           const double                                      gaussian_process_upper_confidence_bound_hyperparam,
+           const py::object&                                 seed)
+        {
+            std::unique_ptr<std::mt19937> random_engine;
+            if (!seed.is_none())
+            {
+                random_engine.reset(new std::mt19937(seed.cast<unsigned>()));
+            }
+
+            py::gil_scoped_release release;
+
+            const auto points = sequential_line_search::acquisition_func::FindNextPoints(
+                regressor,
+                num_points,
+                num_global_search_iters,
+                num_local_search_iters,
+                func_type,
+                gaussian_process_upper_confidence_bound_hyperparam,
+                nullptr,
+                nullptr,
+                random_engine.get());
+
+            RowMajorMatrixXd result(points.size(), regressor.GetNumDims());
+            for (std::size_t i = 0; i < points.size(); ++i)
+            {
+                result.row(i) = points[i].transpose();
+            }
+            return result;
+        },
+        "regressor"_a,
+        "num_points"_a,
+        "num_global_search_iters"_a = 100,
+        "num_local_search_iters"_a  = 50,
+        "func_type"_a               = sequential_line_search::AcquisitionFuncType::ExpectedImprovement,
+        "gaussian_process_upper_confidence_bound_hyperparam"_a = 1.0,
+        "seed"_a                                               = py::none());
 }
@@ -1,11 +1,15 @@
+#include <algorithm>
 #include <cmath>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
-#include <mathtoolbox/acquisition-functions.hpp>
+#include <mathtoolbox/constants.hpp>
 #include <nlopt-util.hpp>
-#include <parallel-util.hpp>
+#include <numeric>
 #include <sequential-line-search/acquisition-function.hpp>
+#include <sequential-line-search/batched-lbfgs.hpp>
 #include <sequential-line-search/gaussian-process-regressor.hpp>
+#include <sequential-line-search/posterior-function-sample.hpp>
 
 using Eigen::MatrixXd;
 using Eigen::VectorXd;
@@ -15,6 +19,24 @@ namespace
 {
     using namespace sequential_line_search;
 
+    /// \brief The number of random Fourier features used for drawing a posterior function sample in Thompson sampling.
+    constexpr unsigned num_posterior_sample_features = 500;
+
+    /// \brief Draw a seed for a posterior function sample from the given generator, or from a generator local to the
+    /// calling thread if it is null. Unlike `std::rand`, this is safe to call from multiple threads.
+    unsigned DrawSeed(std::mt19937* random_engine)
+    {
+        if (random_engine == nullptr)
+        {
+            thread_local std::mt19937 thread_random_engine(std::random_device{}());
+            return thread_random_engine();
+        }
+        return (*random_engine)();
+    }
+
+    /// \brief The minimum number of points evaluated by a task when a batch evaluation is split over the executor.
+    constexpr int min_num_points_per_task = 8;
+
     /// \brief A wrapper struct for an nlopt-style objective function
     struct RegressorWrapper
     {
@@ -32,6 +54,124 @@ namespace
         const double              gaussian_process_upper_confidence_bound_hyperparam;
     };
 
+    /// \brief Calculate an acquisition value from the predicted mean and standard deviation at a point.
+    ///
+    /// \details This is the only implementation of the closed forms; the scalar and the batched evaluations both use
+    /// it. The derivative of the value is `mu_weight` times the derivative of the mean plus `sigma_weight` times the
+    /// derivative of the standard deviation.
+    ///
+    /// \param y_best The mean at the incumbent (see `PredictIncumbentMean`). Used only by EI.
+    ///
+    /// \param mu_weight If not null, the weight of the derivative of the mean is stored.
+    ///
+    /// \param sigma_weight If not null, the weight of the derivative of the standard deviation is stored.
+    double CalcAcquisitionValueFromPrediction(const double              mu,
+                                              const double              sigma,
+                                              const double              y_best,
+                                              const AcquisitionFuncType func_type,
+                                              const double gaussian_process_upper_confidence_bound_hyperparam,
+                                              double*      mu_weight    = nullptr,
+                                              double*      sigma_weight = nullptr)
+    {
+        double value              = 0.0;
+        double value_mu_weight    = 0.0;
+        double value_sigma_weight = 0.0;
+
+        switch (func_type)
+        {
+            case AcquisitionFuncType::ExpectedImprovement:
+            {
+                // The value and its derivative vanish where the prediction is (almost) certain
+                if (sigma < 1e-10)
+                {
+                    break;
+                }
+
+                const double diff = mu - y_best;
+                const double z    = diff / sigma;
+                const double cdf  = 0.5 * std::erfc(-z / std::sqrt(2.0));
+                const double pdf  = std::exp(-0.5 * z * z) / std::sqrt(2.0 * mathtoolbox::constants::pi);
+
+                value              = diff * cdf + sigma * pdf;
+                value_mu_weight    = cdf;
+                value_sigma_weight = pdf;
+                break;
+            }
+            case AcquisitionFuncType::GaussianProcessUpperConfidenceBound:
+            {
+                const double kappa = gaussian_process_upper_confidence_bound_hyperparam;
+
+                value              = mu + kappa * sigma;
+                value_mu_weight    = 1.0;
+                value_sigma_weight = kappa;
+                break;
+            }
+            case AcquisitionFuncType::ThompsonSampling:
+            {
+                value           = mu;
+                value_mu_weight = 1.0;
+                break;
+            }
+        }
+
+        if (mu_weight != nullptr)
+        {
+            *mu_weight = value_mu_weight;
+        }
+        if (sigma_weight != nullptr)
+        {
+            *sigma_weight = value_sigma_weight;
+        }
+
+        return value;
+    }
+
+    /// \brief Predict the mean at the incumbent, which EI measures the improvement from. Zero for the other types or
+    /// without data.
+    double PredictIncumbentMean(const Regressor& regressor, const AcquisitionFuncType func_type)
+    {
+        if (func_type != AcquisitionFuncType::ExpectedImprovement || regressor.GetSmallY().rows() == 0)
+        {
+            return 0.0;
+        }
+
+        return regressor.PredictMu(regressor.PredictMaximumPointFromData());
+    }
+
+    /// \brief Calculate the acquisition value (and optionally the derivative) of a single point.
+    ///
+    /// \details The mean is predicted by `mu_regressor` and the standard deviation by `sigma_regressor`; they are the
+    /// same object except when finding multiple points [Schonlau et al. 1998].
+    double CalcAcquisitionValueWithRegressorPair(const Regressor&          mu_regressor,
+                                                 const Regressor&          sigma_regressor,
+                                                 const VectorXd&           x,
+                                                 const AcquisitionFuncType func_type,
+                                                 const double gaussian_process_upper_confidence_bound_hyperparam,
+                                                 VectorXd*    derivative)
+    {
+        double mu_weight;
+        double sigma_weight;
+
+        const double value = CalcAcquisitionValueFromPrediction(mu_regressor.PredictMu(x),
+                                                                sigma_regressor.PredictSigma(x),
+                                                                PredictIncumbentMean(mu_regressor, func_type),
+                                                                func_type,
+                                                                gaussian_process_upper_confidence_bound_hyperparam,
+                                                                &mu_weight,
+                                                                &sigma_weight);
+
+        if (derivative != nullptr)
+        {
+            *derivative = mu_weight * mu_regressor.PredictMuDerivative(x);
+            if (sigma_weight != 0.0)
+            {
+                *derivative += sigma_weight * sigma_regressor.PredictSigmaDerivative(x);
+            }
+        }
+
+        return value;
+    }
+
     /// \brief NLopt-style objective function definition for finding the next (single) point.
     ///
     /// \param data A pointer for a `RegressorWrapper` object.
@@ -69,98 +209,330 @@ namespace
         const AcquisitionFuncType& func_type         = casted_data->func_type;
         const double&              hyperparam        = casted_data->gaussian_process_upper_confidence_bound_hyperparam;
 
-        const auto mu               = [&](const VectorXd& x) { return orig_regressor->PredictMu(x); };
-        const auto sigma            = [&](const VectorXd& x) { return updated_regressor->PredictSigma(x); };
-        const auto mu_derivative    = [&](const VectorXd& x) { return orig_regressor->PredictMuDerivative(x); };
-        const auto sigma_derivative = [&](const VectorXd& x) { return updated_regressor->PredictSigmaDerivative(x); };
+        const auto eigen_x = Eigen::Map<const VectorXd>(&x[0], x.size());
+
+        VectorXd     derivative;
+        const double value = CalcAcquisitionValueWithRegressorPair(
+            *orig_regressor, *updated_regressor, eigen_x, func_type, hyperparam, grad.empty() ? nullptr : &derivative);
+
+        if (!grad.empty())
+        {
+            std::memcpy(grad.data(), derivative.data(), sizeof(double) * derivative.size());
+        }
+
+        return value;
+    }
+
+    /// \brief NLopt-style objective function definition for maximizing a posterior function sample.
+    ///
+    /// \param data A pointer for a `PosteriorFunctionSample` object.
+    double objective_for_posterior_sample(const std::vector<double>& x, std::vector<double>& grad, void* data)
+    {
+        const auto sample = static_cast<const PosteriorFunctionSample*>(data);
 
         const auto eigen_x = Eigen::Map<const VectorXd>(&x[0], x.size());
 
-        switch (func_type)
+        if (!grad.empty())
         {
-            case AcquisitionFuncType::ExpectedImprovement:
+            const VectorXd derivative = sample->EvaluateDerivative(eigen_x);
+            std::memcpy(grad.data(), derivative.data(), sizeof(double) * derivative.size());
+        }
+
+        return sample->Evaluate(eigen_x);
+    }
+
+    /// \brief A wrapper struct for making an nlopt-style objective function cancellable
+    struct CancellableObjectiveWrapper
+    {
+        const nlopt::vfunc       objective;
+        void* const              data;
+        const CancellationToken* cancellation_token;
+    };
+
+    /// \brief NLopt-style objective function that forwards to the wrapped one unless the search is cancelled.
+    ///
+    /// \details Throwing `nlopt::forced_stop` makes nlopt force-stop the optimization, which then returns the best
+    /// point found so far.
+    ///
+    /// \param data A pointer for a `CancellableObjectiveWrapper` object.
+    double cancellable_objective(const std::vector<double>& x, std::vector<double>& grad, void* data)
+    {
+        const auto casted_data = static_cast<CancellableObjectiveWrapper*>(data);
+
+        if (IsCancelled(casted_data->cancellation_token))
+        {
+            throw nlopt::forced_stop();
+        }
+
+        return casted_data->objective(x, grad, casted_data->data);
+    }
+
+    /// \brief Calculate the acquisition values (and optionally the derivatives) of multiple points at once.
+    ///
+    /// \details The mean is predicted by `mu_regressor` and the standard deviation by `sigma_regressor`; they are the
+    /// same object except when finding multiple points [Schonlau et al. 1998]. The kernel vectors of all the points are
+    /// solved against the kernel matrix in a single call.
+    VectorXd
+    CalcAcquisitionValuesInBatchWithRegressorPair(const Regressor&          mu_regressor,
+                                                  const Regressor&          sigma_regressor,
+                                                  const MatrixXd&           X,
+                                                  const AcquisitionFuncType func_type,
+                                                  const double gaussian_process_upper_confidence_bound_hyperparam,
+                                                  MatrixXd*    derivatives)
+    {
+        const unsigned num_dims   = X.rows();
+        const unsigned num_points = X.cols();
+
+        if (derivatives != nullptr)
+        {
+            *derivatives = MatrixXd::Zero(num_dims, num_points);
+        }
+
+        if (mu_regressor.GetSmallY().rows() == 0)
+        {
+            return VectorXd::Zero(num_points);
+        }
+
+        const MatrixXd& X_mu     = mu_regressor.GetLargeX();
+        const VectorXd& theta_mu = mu_regressor.GetKernelHyperparams();
+        const MatrixXd  K_mu     = CalcLargeKStar(X, X_mu, theta_mu, mu_regressor.GetKernel());
+        const VectorXd  alpha    = mu_regressor.SolveLargeKY(mu_regressor.GetSmallY());
+        const VectorXd  mu       = K_mu.transpose() * alpha;
+
+        const MatrixXd& X_sigma     = sigma_regressor.GetLargeX();
+        const VectorXd& theta_sigma = sigma_regressor.GetKernelHyperparams();
+        const MatrixXd  K_sigma     = (&mu_regressor == &sigma_regressor)
+                                          ? K_mu
+                                          : CalcLargeKStar(X, X_sigma, theta_sigma, sigma_regressor.GetKernel());
+
+        const MatrixXd K_sigma_solved = sigma_regressor.SolveLargeKY(K_sigma);
+
+        // This code assumes that the kernel is either ARD squared exponential or ARD Matern and the first
+        // hyperparameter represents the intensity of the kernel.
+        const double intensity = theta_sigma(0);
+
+        const double y_best = PredictIncumbentMean(mu_regressor, func_type);
+
+        VectorXd values(num_points);
+        for (unsigned s = 0; s < num_points; ++s)
+        {
+            // Note: The value of `sigma_2` can be negative due to numerical errors.
+            const double sigma_2 = intensity - K_sigma.col(s).dot(K_sigma_solved.col(s));
+            const double sigma   = sigma_2 < 0 ? 0.0 : std::sqrt(sigma_2);
+
+            VectorXd mu_derivative;
+            VectorXd sigma_derivative = VectorXd::Zero(num_dims);
+            if (derivatives != nullptr)
             {
-                const VectorXd x_best = orig_regressor->PredictMaximumPointFromData();
+                const MatrixXd k_mu_x_derivative = CalcSmallKSmallXDerivative(
+                    X.col(s), X_mu, theta_mu, mu_regressor.GetKernelFirstArgDerivative());
+
+                mu_derivative = k_mu_x_derivative * alpha;
 
-                if (!grad.empty())
+                if (sigma > 0.0)
                 {
-                    const VectorXd derivative = mathtoolbox::GetExpectedImprovementDerivative(
-                        eigen_x, mu, sigma, x_best, mu_derivative, sigma_derivative);
+                    const MatrixXd k_sigma_x_derivative = CalcSmallKSmallXDerivative(
+                        X.col(s), X_sigma, theta_sigma, sigma_regressor.GetKernelFirstArgDerivative());
 
-                    std::memcpy(grad.data(), derivative.data(), sizeof(double) * derivative.size());
+                    sigma_derivative = -(1.0 / sigma) * k_sigma_x_derivative * K_sigma_solved.col(s);
                 }
+            }
 
-                return mathtoolbox::GetExpectedImprovement(eigen_x, mu, sigma, x_best);
+            double mu_weight;
+            double sigma_weight;
+
+            values(s) = CalcAcquisitionValueFromPrediction(mu(s),
+                                                           sigma,
+                                                           y_best,
+                                                           func_type,
+                                                           gaussian_process_upper_confidence_bound_hyperparam,
+                                                           &mu_weight,
+                                                           &sigma_weight);
+            if (derivatives != nullptr)
+            {
+                derivatives->col(s) = mu_weight * mu_derivative + sigma_weight * sigma_derivative;
             }
-            case AcquisitionFuncType::GaussianProcessUpperConfidenceBound:
+        }
+
+        return values;
+    }
+
+#ifdef SEQUENTIAL_LINE_SEARCH_USE_PARALLELIZED_MULTI_START_SEARCH
+    /// \brief Collect the incumbent and the data points (the newest first) as candidate starting points.
+    vector<VectorXd> CollectDataSeeds(const Regressor& regressor)
+    {
+        const MatrixXd& X = regressor.GetLargeX();
+
+        vector<VectorXd> seeds;
+        seeds.push_back(regressor.PredictMaximumPointFromData());
+        for (int i = X.cols() - 1; i >= 0; --i)
+        {
+            seeds.push_back(X.col(i));
+        }
+
+        return seeds;
+    }
+
+    /// \brief Keep the best distinct local maxima for warm-starting the next search.
+    void UpdateWarmStartState(const batched_lbfgs::Result& result, acquisition_func::WarmStartState& warm_start_state)
+    {
+        vector<int> indices(result.values.size());
+        std::iota(indices.begin(), indices.end(), 0);
+        std::sort(indices.begin(), indices.end(), [&](int i, int j) { return result.values(i) > result.values(j); });
+
+        warm_start_state.local_maxima.clear();
+        for (const int index : indices)
+        {
+            if (warm_start_state.local_maxima.size() >= warm_start_state.num_kept_local_maxima)
             {
-                if (!grad.empty())
-                {
-                    const VectorXd derivative = mathtoolbox::GetGaussianProcessUpperConfidenceBoundDerivative(
-                        eigen_x, mu, sigma, hyperparam, mu_derivative, sigma_derivative);
+                break;
+            }
 
-                    std::memcpy(grad.data(), derivative.data(), sizeof(double) * derivative.size());
-                }
+            const VectorXd x = result.X.col(index);
 
-                return mathtoolbox::GetGaussianProcessUpperConfidenceBound(eigen_x, mu, sigma, hyperparam);
+            const bool is_duplicate = std::any_of(warm_start_state.local_maxima.begin(),
+                                                  warm_start_state.local_maxima.end(),
+                                                  [&](const VectorXd& x_kept) { return (x - x_kept).norm() < 1e-03; });
+            if (!is_duplicate)
+            {
+                warm_start_state.local_maxima.push_back(x);
             }
-            default:
-                assert(false);
         }
     }
+#endif
 
-    VectorXd FindGlobalSolution(nlopt::vfunc   objective,
-                                void*          data,
-                                const unsigned num_dim,
-                                const unsigned num_global_search_iters,
-                                const unsigned num_local_search_iters)
+    /// \brief Find the global maximizer of an acquisition function in the box [lower, upper].
+    ///
+    /// \param objective The nlopt-style objective function, used by the DIRECT-based search.
+    ///
+    /// \param batch_objective The same objective function evaluating multiple points at once, used by the multi-start
+    /// search.
+    ///
+    /// \param warm_start_state The state for warm-starting the multi-start search. Can be null.
+    ///
+    /// \param executor The executor that the batch evaluations are split over. Not used by the DIRECT-based search.
+    ///
+    /// \param cancellation_token The token for abandoning the search. Can be null.
+    ///
+    /// \param data_seeds Additional candidate starting points used together with `warm_start_state`.
+    VectorXd FindGlobalSolution(nlopt::vfunc                      objective,
+                                void*                             data,
+                                const BatchObjectiveFunc&         batch_objective,
+                                const VectorXd&                   lower,
+                                const VectorXd&                   upper,
+                                const unsigned                    num_global_search_iters,
+                                const unsigned                    num_local_search_iters,
+                                Executor*                         executor,
+                                const CancellationToken*          cancellation_token,
+                                acquisition_func::WarmStartState* warm_start_state = nullptr,
+                                const vector<VectorXd>&           data_seeds       = {})
     {
-        const VectorXd upper = VectorXd::Constant(num_dim, 1.0);
-        const VectorXd lower = VectorXd::Constant(num_dim, 0.0);
+        const unsigned num_dim = lower.size();
 
 #ifdef SEQUENTIAL_LINE_SEARCH_USE_PARALLELIZED_MULTI_START_SEARCH
-        MatrixXd x_stars(num_dim, num_global_search_iters);
-        VectorXd y_stars(num_global_search_iters);
+        const unsigned num_starts = num_global_search_iters;
+
+        const MatrixXd U = 0.5 * (MatrixXd::Random(num_dim, num_starts) + MatrixXd::Ones(num_dim, num_starts));
+
+        MatrixXd X_ini = (U.array().colwise() * (upper - lower).array()).colwise() + lower.array();
+
+        // Replace a part of the random initializations by the seeds: the previous local maxima first, followed by the
+        // incumbent and the data points. The seeds are slightly perturbed since the acquisition function is often flat
+        // at observed data points.
+        if (warm_start_state != nullptr)
+        {
+            vector<VectorXd> seeds = warm_start_state->local_maxima;
+            seeds.insert(seeds.end(), data_seeds.begin(), data_seeds.end());
+
+            const double random_start_fraction =
+                std::max(0.0, std::min(1.0, warm_start_state->random_start_fraction));
+            const unsigned num_random_starts =
+                static_cast<unsigned>(std::ceil(random_start_fraction * static_cast<double>(num_starts)));
+            const unsigned num_seeded_starts =
+                std::min(num_starts - num_random_starts, static_cast<unsigned>(seeds.size()));
 
-        const auto perform_local_optimization_from_random_initialization = [&](const int i)
+            for (unsigned i = 0; i < num_seeded_starts; ++i)
+            {
+                const VectorXd perturbation = 0.025 * (upper - lower).cwiseProduct(VectorXd::Random(num_dim));
+
+                X_ini.col(i) = (seeds[i] + perturbation).cwiseMax(lower).cwiseMin(upper);
+            }
+        }
+
+        // Each evaluation of the active starts is split into column blocks, which are evaluated in parallel
+        const auto parallel_batch_objective = [&](const MatrixXd& X, MatrixXd* derivatives) -> VectorXd
         {
-            const VectorXd x_ini = 0.5 * (VectorXd::Random(num_dim) + VectorXd::Ones(num_dim));
-            const VectorXd x_star =
-                nloptutil::solve(x_ini, upper, lower, objective, nlopt::LD_LBFGS, data, true, num_local_search_iters);
-            const double y_star = [&]()
+            const int num_points = X.cols();
+            const int num_tasks  = std::min(executor->GetConcurrency(), num_points / min_num_points_per_task);
+
+            if (num_tasks <= 1)
+            {
+                return batch_objective(X, derivatives);
+            }
+
+            VectorXd values(num_points);
+            if (derivatives != nullptr)
             {
-                vector<double> x_star_std(num_dim);
-                vector<double> grad_std;
-                std::memcpy(x_star_std.data(), x_star.data(), sizeof(double) * num_dim);
+                derivatives->resize(X.rows(), num_points);
+            }
 
-                return objective(x_star_std, grad_std, data);
-            }();
+            const auto evaluate_block = [&](const int task_index)
+            {
+                const int begin = task_index * num_points / num_tasks;
+                const int size  = (task_index + 1) * num_points / num_tasks - begin;
 
-            x_stars.col(i) = x_star;
-            y_stars(i)     = y_star;
+                MatrixXd block_derivatives;
+
+                values.segment(begin, size) =
+                    batch_objective(X.middleCols(begin, size), derivatives != nullptr ? &block_derivatives : nullptr);
+
+                if (derivatives != nullptr)
+                {
+                    derivatives->middleCols(begin, size) = block_derivatives;
+                }
+            };
+
+            ParallelFor(executor, num_tasks, evaluate_block);
+
+            return values;
         };
 
-        parallelutil::queue_based_parallel_for(num_global_search_iters,
-                                               perform_local_optimization_from_random_initialization);
+        // All the initializations are advanced together by the batched L-BFGS so that each evaluation of the
+        // acquisition function handles every active start at once
+        const batched_lbfgs::Result result = batched_lbfgs::Maximize(
+            parallel_batch_objective, X_ini, lower, upper, num_local_search_iters, 6, 1e-06, cancellation_token);
 
         const int best_index = [&]()
         {
             int index;
-            y_stars.maxCoeff(&index);
+            result.values.maxCoeff(&index);
             return index;
         }();
 
-        return x_stars.col(best_index);
+        if (warm_start_state != nullptr && !IsCancelled(cancellation_token))
+        {
+            UpdateWarmStartState(result, *warm_start_state);
+        }
+
+        return result.X.col(best_index);
 #else
-        const VectorXd x_ini = 0.5 * (VectorXd::Random(num_dim) + VectorXd::Ones(num_dim));
+        const VectorXd u     = 0.5 * (VectorXd::Random(num_dim) + VectorXd::Ones(num_dim));
+        const VectorXd x_ini = lower + (upper - lower).cwiseProduct(u);
+
+        CancellableObjectiveWrapper wrapper{objective, data, cancellation_token};
 
         // Find a global solution by the DIRECT method
-        const VectorXd x_global =
-            nloptutil::solve(x_ini, upper, lower, objective, nlopt::GN_DIRECT, data, true, num_global_search_iters);
+        const VectorXd x_global = nloptutil::solve(
+            x_ini, upper, lower, cancellable_objective, nlopt::GN_DIRECT, &wrapper, true, num_global_search_iters);
+
+        if (IsCancelled(cancellation_token))
+        {
+            return x_global;
+        }
 
         // Refine the solution by a quasi-Newton method
-        const VectorXd x_local =
-            nloptutil::solve(x_global, upper, lower, objective, nlopt::LD_LBFGS, data, true, num_local_search_iters);
+        const VectorXd x_local = nloptutil::solve(
+            x_global, upper, lower, cancellable_objective, nlopt::LD_LBFGS, &wrapper, true, num_local_search_iters);
 
         return x_local;
 #endif
@@ -178,23 +550,8 @@ double sequential_line_search::acquisition_func::CalcAcquisitionValue(
         return 0.0;
     }
 
-    const auto mu    = [&](const VectorXd& x) { return regressor.PredictMu(x); };
-    const auto sigma = [&](const VectorXd& x) { return regressor.PredictSigma(x); };
-
-    switch (func_type)
-    {
-        case AcquisitionFuncType::ExpectedImprovement:
-        {
-            const VectorXd x_best = regressor.PredictMaximumPointFromData();
-
-            return mathtoolbox::GetExpectedImprovement(x, mu, sigma, x_best);
-        }
-        case AcquisitionFuncType::GaussianProcessUpperConfidenceBound:
-        {
-            return mathtoolbox::GetGaussianProcessUpperConfidenceBound(
-                x, mu, sigma, gaussian_process_upper_confidence_bound_hyperparam);
-        }
-    }
+    return CalcAcquisitionValueWithRegressorPair(
+        regressor, regressor, x, func_type, gaussian_process_upper_confidence_bound_hyperparam, nullptr);
 }
 
 VectorXd sequential_line_search::acquisition_func::CalcAcquisitionValueDerivative(
@@ -208,25 +565,43 @@ VectorXd sequential_line_search::acquisition_func::CalcAcquisitionValueDerivativ
         return VectorXd::Zero(x.size());
     }
 
-    const auto mu               = [&](const VectorXd& x) { return regressor.PredictMu(x); };
-    const auto sigma            = [&](const VectorXd& x) { return regressor.PredictSigma(x); };
-    const auto mu_derivative    = [&](const VectorXd& x) { return regressor.PredictMuDerivative(x); };
-    const auto sigma_derivative = [&](const VectorXd& x) { return regressor.PredictSigmaDerivative(x); };
+    VectorXd derivative;
+    CalcAcquisitionValueWithRegressorPair(
+        regressor, regressor, x, func_type, gaussian_process_upper_confidence_bound_hyperparam, &derivative);
 
-    switch (func_type)
-    {
-        case AcquisitionFuncType::ExpectedImprovement:
-        {
-            const VectorXd x_best = regressor.PredictMaximumPointFromData();
+    return derivative;
+}
 
-            return mathtoolbox::GetExpectedImprovementDerivative(x, mu, sigma, x_best, mu_derivative, sigma_derivative);
-        }
-        case AcquisitionFuncType::GaussianProcessUpperConfidenceBound:
-        {
-            return mathtoolbox::GetGaussianProcessUpperConfidenceBoundDerivative(
-                x, mu, sigma, gaussian_process_upper_confidence_bound_hyperparam, mu_derivative, sigma_derivative);
-        }
+VectorXd sequential_line_search::acquisition_func::CalcAcquisitionValuesInBatch(
+    const Regressor&          regressor,
+    const MatrixXd&           X,
+    const AcquisitionFuncType func_type,
+    const double              gaussian_process_upper_confidence_bound_hyperparam,
+    MatrixXd*                 derivatives)
+{
+    return CalcAcquisitionValuesInBatchWithRegressorPair(
+        regressor, regressor, X, func_type, gaussian_process_upper_confidence_bound_hyperparam, derivatives);
+}
+
+VectorXd sequential_line_search::acquisition_func::CalcAcquisitionValuesFromPredictions(
+    const Regressor&          regressor,
+    const VectorXd&           mu,
+    const VectorXd&           sigma,
+    const AcquisitionFuncType func_type,
+    const double              gaussian_process_upper_confidence_bound_hyperparam)
+{
+    const unsigned num_points = mu.size();
+
+    const double y_best = PredictIncumbentMean(regressor, func_type);
+
+    VectorXd values(num_points);
+    for (unsigned s = 0; s < num_points; ++s)
+    {
+        values(s) = CalcAcquisitionValueFromPrediction(
+            mu(s), sigma(s), y_best, func_type, gaussian_process_upper_confidence_bound_hyperparam);
     }
+
+    return values;
 }
 
 VectorXd
@@ -234,13 +609,72 @@ sequential_line_search::acquisition_func::FindNextPoint(const Regressor&
                                                         const unsigned            num_global_search_iters,
                                                         const unsigned            num_local_search_iters,
                                                         const AcquisitionFuncType func_type,
-                                                        const double gaussian_process_upper_confidence_bound_hyperparam)
+                                                        const double gaussian_process_upper_confidence_bound_hyperparam,
+                                                        WarmStartState*        warm_start_state,
+                                                        const Eigen::VectorXd&   lower,
+                                                        const Eigen::VectorXd&   upper,
+                                                        Executor*                executor,
+                                                        const CancellationToken* cancellation_token,
+                                                        std::mt19937*            random_engine)
 {
     const unsigned num_dim = regressor.GetNumDims();
 
+    if (executor == nullptr)
+    {
+        executor = GetDefaultExecutor().get();
+    }
+
+    // Empty bounds mean the whole search space
+    const VectorXd search_lower = (lower.size() == 0) ? VectorXd::Zero(num_dim) : lower;
+    const VectorXd search_upper = (upper.size() == 0) ? VectorXd::Ones(num_dim) : upper;
+
+#ifdef SEQUENTIAL_LINE_SEARCH_USE_PARALLELIZED_MULTI_START_SEARCH
+    const vector<VectorXd> data_seeds =
+        (warm_start_state != nullptr) ? CollectDataSeeds(regressor) : vector<VectorXd>();
+#else
+    // The DIRECT-based search does not take starting points
+    const vector<VectorXd> data_seeds;
+#endif
+
+    if (func_type == AcquisitionFuncType::ThompsonSampling)
+    {
+        PosteriorFunctionSample sample(regressor, num_posterior_sample_features, DrawSeed(random_engine));
+
+        const auto batch_objective = [&](const MatrixXd& X, MatrixXd* derivatives)
+        { return sample.EvaluateInBatch(X, derivatives); };
+
+        return FindGlobalSolution(objective_for_posterior_sample,
+                                  &sample,
+                                  batch_objective,
+                                  search_lower,
+                                  search_upper,
+                                  num_global_search_iters,
+                                  num_local_search_iters,
+                                  executor,
+                                  cancellation_token,
+                                  warm_start_state,
+                                  data_seeds);
+    }
+
     RegressorWrapper data{&regressor, func_type, gaussian_process_upper_confidence_bound_hyperparam};
 
-    return FindGlobalSolution(objective, &data, num_dim, num_global_search_iters, num_local_search_iters);
+    const auto batch_objective = [&](const MatrixXd& X, MatrixXd* derivatives)
+    {
+        return CalcAcquisitionValuesInBatchWithRegressorPair(
+            regressor, regressor, X, func_type, gaussian_process_upper_confidence_bound_hyperparam, derivatives);
+    };
+
+    return FindGlobalSolution(objective,
+                              &data,
+                              batch_objective,
+                              search_lower,
+                              search_upper,
+                              num_global_search_iters,
+                              num_local_search_iters,
+                              executor,
+                              cancellation_token,
+                              warm_start_state,
+                              data_seeds);
 }
 
 vector<VectorXd> sequential_line_search::acquisition_func::FindNextPoints(
@@ -249,48 +683,86 @@ vector<VectorXd> sequential_line_search::acquisition_func::FindNextPoints(
     const unsigned            num_global_search_iters,
     const unsigned            num_local_search_iters,
     const AcquisitionFuncType func_type,
-    const double              gaussian_process_upper_confidence_bound_hyperparam)
+    const double              gaussian_process_upper_confidence_bound_hyperparam,
+    Executor*                 executor,
+    const CancellationToken*  cancellation_token,
+    std::mt19937*             random_engine)
 {
     const unsigned num_dim = regressor.GetNumDims();
 
+    if (executor == nullptr)
+    {
+        executor = GetDefaultExecutor().get();
+    }
+
     vector<VectorXd> points;
 
+    // Thompson sampling is naturally parallel: each point maximizes its own independent posterior function sample
+    if (func_type == AcquisitionFuncType::ThompsonSampling)
+    {
+        for (unsigned i = 0; i < num_points && !IsCancelled(cancellation_token); ++i)
+        {
+            PosteriorFunctionSample sample(regressor, num_posterior_sample_features, DrawSeed(random_engine));
+
+            const auto batch_objective = [&](const MatrixXd& X, MatrixXd* derivatives)
+            { return sample.EvaluateInBatch(X, derivatives); };
+
+            points.push_back(FindGlobalSolution(objective_for_posterior_sample,
+                                                &sample,
+                                                batch_objective,
+                                                VectorXd::Zero(num_dim),
+                                                VectorXd::Ones(num_dim),
+                                                num_global_search_iters,
+                                                num_local_search_iters,
+                                                executor,
+                                                cancellation_token));
+        }
+
+        return points;
+    }
+
     const VectorXd kernel_hyperparams = regressor.GetKernelHyperparams();
 
     // Instantiate a dummy regressor object for calculating variances
     GaussianProcessRegressor temp_regressor(
         regressor.GetLargeX(), regressor.GetSmallY(), kernel_hyperparams, regressor.GetNoiseHyperparam());
 
-    for (unsigned i = 0; i < num_points; ++i)
+    for (unsigned i = 0; i < num_points && !IsCancelled(cancellation_token); ++i)
     {
         // Create a data object for the nlopt-style objective function
         RegressorPairWrapper data{
             &regressor, &temp_regressor, func_type, gaussian_process_upper_confidence_bound_hyperparam};
 
+        const auto batch_objective = [&](const MatrixXd& X, MatrixXd* derivatives)
+        {
+            return CalcAcquisitionValuesInBatchWithRegressorPair(regressor,
+                                                                 temp_regressor,
+                                                                 X,
+                                                                 func_type,
+                                                                 gaussian_process_upper_confidence_bound_hyperparam,
+                                                                 derivatives);
+        };
+
         // Find a global solution that maximizes the acquisition function
-        const VectorXd x_star = FindGlobalSolution(
-            objective_for_multiple_points, &data, num_dim, num_global_search_iters, num_local_search_iters);
+        const VectorXd x_star = FindGlobalSolution(objective_for_multiple_points,
+                                                   &data,
+                                                   batch_objective,
+                                                   VectorXd::Zero(num_dim),
+                                                   VectorXd::Ones(num_dim),
+                                                   num_global_search_iters,
+                                                   num_local_search_iters,
+                                                   executor,
+                                                   cancellation_token);
 
         // Register the found solution
         points.push_back(x_star);
 
-        // If this is not the final iteration, prepare data for the next iteration
+        // If this is not the final iteration, add the newly sampled point to the dummy regressor with the predicted
+        // value (actually, this value will not be used in predicting variances and thus it can be arbitrary). The
+        // inverse of the kernel matrix is extended in O(N^2) rather than recomputed.
         if (points.size() != num_points)
         {
-            const unsigned N = temp_regressor.GetLargeX().cols();
-
-            // Add the newly sampled point
-            MatrixXd new_X(num_dim, N + 1);
-            new_X.block(0, 0, num_dim, N) = temp_regressor.GetLargeX();
-            new_X.col(N)                  = x_star;
-
-            // Add the predicted value of the newly sampled point (actually, this value will not be used in predicting
-            // variances and thus it can be arbitrary)
-            VectorXd new_y(temp_regressor.GetSmallY().rows() + 1);
-            new_y << temp_regressor.GetSmallY(), temp_regressor.PredictMu(x_star);
-
-            // Override the dummy regressor
-            temp_regressor = GaussianProcessRegressor(new_X, new_y, kernel_hyperparams, regressor.GetNoiseHyperparam());
+            temp_regressor.AddDataPoint(x_star, temp_regressor.PredictMu(x_star));
         }
     }
 
@@ -0,0 +1,234 @@
+#include <cmath>
+#include <deque>
+#include <sequential-line-search/batched-lbfgs.hpp>
+#include <vector>
+
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+
+namespace
+{
+    /// \brief Correction pairs of a single start.
+    struct Memory
+    {
+        std::deque<VectorXd> s_list;
+        std::deque<VectorXd> y_list;
+    };
+
+    constexpr unsigned max_line_search_trials = 20;
+    constexpr double   armijo_coeff           = 1e-04;
+
+    inline VectorXd Project(const VectorXd& x, const VectorXd& lower, const VectorXd& upper)
+    {
+        return x.cwiseMax(lower).cwiseMin(upper);
+    }
+
+    /// \brief Apply the L-BFGS approximation of the inverse Hessian to a vector by the two-loop recursion.
+    VectorXd ApplyInverseHessian(const Memory& memory, const VectorXd& g)
+    {
+        const int m = memory.s_list.size();
+
+        std::vector<double> alpha(m);
+        std::vector<double> rho(m);
+
+        VectorXd q = g;
+        for (int i = m - 1; i >= 0; --i)
+        {
+            rho[i]   = 1.0 / memory.y_list[i].dot(memory.s_list[i]);
+            alpha[i] = rho[i] * memory.s_list[i].dot(q);
+            q -= alpha[i] * memory.y_list[i];
+        }
+
+        const double gamma =
+            (m > 0) ? memory.s_list.back().dot(memory.y_list.back()) / memory.y_list.back().squaredNorm() : 1.0;
+
+        VectorXd r = gamma * q;
+        for (int i = 0; i < m; ++i)
+        {
+            const double beta = rho[i] * memory.y_list[i].dot(r);
+            r += (alpha[i] - beta) * memory.s_list[i];
+        }
+
+        return r;
+    }
+} // namespace
+
+sequential_line_search::batched_lbfgs::Result
+sequential_line_search::batched_lbfgs::Maximize(const BatchObjectiveFunc& objective,
+                                                const MatrixXd&           X_ini,
+                                                const VectorXd&           lower,
+                                                const VectorXd&           upper,
+                                                const unsigned            max_iters,
+                                                const unsigned            memory_size,
+                                                const double              tolerance,
+                                                const CancellationToken*  cancellation_token)
+{
+    const int num_dims   = X_ini.rows();
+    const int num_starts = X_ini.cols();
+
+    // In this function, the negated objective is minimized
+    MatrixXd X(num_dims, num_starts);
+    for (int s = 0; s < num_starts; ++s)
+    {
+        X.col(s) = Project(X_ini.col(s), lower, upper);
+    }
+    if (IsCancelled(cancellation_token))
+    {
+        return Result{X, VectorXd::Zero(num_starts)};
+    }
+    MatrixXd G;
+    VectorXd f = -objective(X, &G);
+    G          = -G;
+
+    std::vector<bool>   is_active(num_starts, true);
+    std::vector<Memory> memories(num_starts);
+
+    MatrixXd D(num_dims, num_starts);
+
+    for (unsigned iter = 0; iter < max_iters && !IsCancelled(cancellation_token); ++iter)
+    {
+        std::vector<int> active_indices;
+
+        // Determine a search direction for each active start
+        for (int s = 0; s < num_starts; ++s)
+        {
+            if (!is_active[s])
+            {
+                continue;
+            }
+
+            const VectorXd x = X.col(s);
+            const VectorXd g = G.col(s);
+
+            // Check the projected gradient for convergence
+            if ((x - Project(x - g, lower, upper)).lpNorm<Eigen::Infinity>() < tolerance)
+            {
+                is_active[s] = false;
+                continue;
+            }
+
+            // Variables at a bound whose gradient points outward are held fixed in this iteration
+            VectorXd free_mask = VectorXd::Ones(num_dims);
+            for (int i = 0; i < num_dims; ++i)
+            {
+                if ((x(i) <= lower(i) && g(i) > 0.0) || (x(i) >= upper(i) && g(i) < 0.0))
+                {
+                    free_mask(i) = 0.0;
+                }
+            }
+            const VectorXd g_free = g.cwiseProduct(free_mask);
+
+            VectorXd d = -ApplyInverseHessian(memories[s], g_free).cwiseProduct(free_mask);
+
+            // Fall back to the steepest descent when the quasi-Newton direction is not a descent direction
+            if (d.dot(g_free) >= 0.0)
+            {
+                memories[s] = Memory();
+                d           = -g_free;
+            }
+
+            // Without curvature information, scale the first step so that it moves at most the box size
+            if (memories[s].s_list.empty())
+            {
+                d *= (upper - lower).maxCoeff() / d.lpNorm<Eigen::Infinity>();
+            }
+
+            D.col(s) = d;
+            active_indices.push_back(s);
+        }
+
+        if (active_indices.empty())
+        {
+            break;
+        }
+
+        // Backtracking line search performed for all the active starts in lockstep
+        MatrixXd X_new = X;
+        MatrixXd G_new = G;
+        VectorXd f_new = f;
+
+        VectorXd         steps          = VectorXd::Ones(num_starts);
+        std::vector<int> search_indices = active_indices;
+        std::vector<int> accepted_indices;
+        for (unsigned trial = 0; trial < max_line_search_trials && !search_indices.empty(); ++trial)
+        {
+            // The starts still searching keep their current points
+            if (IsCancelled(cancellation_token))
+            {
+                break;
+            }
+
+            const int num_trial_points = search_indices.size();
+
+            MatrixXd X_trial(num_dims, num_trial_points);
+            for (int k = 0; k < num_trial_points; ++k)
+            {
+                const int s    = search_indices[k];
+                X_trial.col(k) = Project(X.col(s) + steps(s) * D.col(s), lower, upper);
+            }
+
+            MatrixXd       G_trial;
+            const VectorXd f_trial = -objective(X_trial, &G_trial);
+
+            std::vector<int> rejected_indices;
+            for (int k = 0; k < num_trial_points; ++k)
+            {
+                const int    s        = search_indices[k];
+                const double decrease = G.col(s).dot(X_trial.col(k) - X.col(s));
+
+                if (f_trial(k) <= f(s) + armijo_coeff * decrease)
+                {
+                    X_new.col(s) = X_trial.col(k);
+                    G_new.col(s) = -G_trial.col(k);
+                    f_new(s)     = f_trial(k);
+
+                    accepted_indices.push_back(s);
+                }
+                else
+                {
+                    steps(s) *= 0.5;
+                    rejected_indices.push_back(s);
+                }
+            }
+            search_indices.swap(rejected_indices);
+        }
+
+        // Starts that could not make sufficient progress are regarded as converged
+        for (const int s : search_indices)
+        {
+            is_active[s] = false;
+        }
+
+        for (const int s : accepted_indices)
+        {
+            const VectorXd s_vec = X_new.col(s) - X.col(s);
+            const VectorXd y_vec = G_new.col(s) - G.col(s);
+
+            if (s_vec.dot(y_vec) > 1e-10)
+            {
+                memories[s].s_list.push_back(s_vec);
+                memories[s].y_list.push_back(y_vec);
+
+                if (memories[s].s_list.size() > memory_size)
+                {
+                    memories[s].s_list.pop_front();
+                    memories[s].y_list.pop_front();
+                }
+            }
+
+            const bool is_f_converged = std::abs(f_new(s) - f(s)) <= tolerance * std::abs(f(s));
+            const bool is_x_converged =
+                s_vec.lpNorm<Eigen::Infinity>() <= tolerance * X.col(s).lpNorm<Eigen::Infinity>();
+            if (is_f_converged || is_x_converged)
+            {
+                is_active[s] = false;
+            }
+        }
+
+        X = X_new;
+        G = G_new;
+        f = f_new;
+    }
+
+    return Result{X, -f};
+}
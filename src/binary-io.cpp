@@ -0,0 +1,271 @@
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <sequential-line-search/binary-io.hpp>
+#include <stdexcept>
+
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+
+namespace
+{
+    void WriteBytes(std::ostream& stream, const std::uint64_t value, const int num_bytes)
+    {
+        char bytes[8];
+        for (int i = 0; i < num_bytes; ++i)
+        {
+            bytes[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+        }
+        stream.write(bytes, num_bytes);
+    }
+
+    std::uint64_t ReadBytes(std::istream& stream, const int num_bytes)
+    {
+        char bytes[8];
+        if (!stream.read(bytes, num_bytes))
+        {
+            throw std::runtime_error("Unexpected end of a binary snapshot.");
+        }
+
+        std::uint64_t value = 0;
+        for (int i = 0; i < num_bytes; ++i)
+        {
+            value |= static_cast<std::uint64_t>(static_cast<unsigned char>(bytes[i])) << (8 * i);
+        }
+        return value;
+    }
+
+    /// \brief Read a size and check it against a sanity limit so that a corrupted stream does not cause a huge
+    /// allocation.
+    std::uint64_t ReadSize(std::istream& stream)
+    {
+        constexpr std::uint64_t max_size = std::numeric_limits<std::int32_t>::max();
+
+        const std::uint64_t size = ReadBytes(stream, 8);
+        if (size > max_size)
+        {
+            throw std::runtime_error("Invalid size in a binary snapshot.");
+        }
+        return size;
+    }
+
+    /// \brief Check the number of elements to be read against the rest of the stream before allocating them, so that
+    /// a corrupted size does not cause a huge allocation.
+    ///
+    /// \details If the stream is not seekable (e.g., a pipe), the number is checked against a fixed limit instead.
+    void CheckNumElements(std::istream& stream, const std::uint64_t num_elements, const std::uint64_t element_size)
+    {
+        // 1 GiB of doubles
+        constexpr std::uint64_t max_num_elements = std::uint64_t(1) << 27;
+
+        std::uint64_t limit = max_num_elements;
+
+        const std::streampos position = stream.tellg();
+        if (position != std::streampos(-1) && stream.seekg(0, std::ios::end))
+        {
+            limit = static_cast<std::uint64_t>(stream.tellg() - position) / element_size;
+            stream.seekg(position);
+        }
+        else
+        {
+            stream.clear();
+        }
+
+        if (num_elements > limit)
+        {
+            throw std::runtime_error("Invalid size in a binary snapshot.");
+        }
+    }
+} // namespace
+
+void sequential_line_search::binary_io::WriteHeader(std::ostream&       stream,
+                                                    const std::string&  magic,
+                                                    const std::uint32_t version)
+{
+    assert(magic.size() == 4);
+
+    stream.write(magic.data(), 4);
+    WriteUInt32(stream, version);
+}
+
+std::uint32_t sequential_line_search::binary_io::ReadHeader(std::istream&       stream,
+                                                            const std::string&  magic,
+                                                            const std::uint32_t latest_version)
+{
+    assert(magic.size() == 4);
+
+    char read_magic[4];
+    if (!stream.read(read_magic, 4) || std::memcmp(read_magic, magic.data(), 4) != 0)
+    {
+        throw std::runtime_error("Not a binary snapshot of the expected type.");
+    }
+
+    const std::uint32_t version = ReadUInt32(stream);
+    if (version == 0 || version > latest_version)
+    {
+        throw std::runtime_error("Unsupported version of a binary snapshot.");
+    }
+    return version;
+}
+
+void sequential_line_search::binary_io::WriteUInt32(std::ostream& stream, const std::uint32_t value)
+{
+    WriteBytes(stream, value, 4);
+}
+
+void sequential_line_search::binary_io::WriteUInt64(std::ostream& stream, const std::uint64_t value)
+{
+    WriteBytes(stream, value, 8);
+}
+
+void sequential_line_search::binary_io::WriteInt32(std::ostream& stream, const std::int32_t value)
+{
+    WriteBytes(stream, static_cast<std::uint32_t>(value), 4);
+}
+
+void sequential_line_search::binary_io::WriteBool(std::ostream& stream, const bool value)
+{
+    WriteBytes(stream, value ? 1 : 0, 1);
+}
+
+void sequential_line_search::binary_io::WriteDouble(std::ostream& stream, const double value)
+{
+    static_assert(sizeof(double) == sizeof(std::uint64_t), "IEEE 754 double precision is assumed.");
+
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(double));
+    WriteBytes(stream, bits, 8);
+}
+
+void sequential_line_search::binary_io::WriteVector(std::ostream& stream, const VectorXd& vector)
+{
+    WriteUInt64(stream, vector.size());
+    for (int i = 0; i < vector.size(); ++i)
+    {
+        WriteDouble(stream, vector(i));
+    }
+}
+
+void sequential_line_search::binary_io::WriteMatrix(std::ostream& stream, const MatrixXd& matrix)
+{
+    WriteUInt64(stream, matrix.rows());
+    WriteUInt64(stream, matrix.cols());
+    for (int j = 0; j < matrix.cols(); ++j)
+    {
+        for (int i = 0; i < matrix.rows(); ++i)
+        {
+            WriteDouble(stream, matrix(i, j));
+        }
+    }
+}
+
+void sequential_line_search::binary_io::WritePreferences(std::ostream&                  stream,
+                                                         const std::vector<Preference>& preferences)
+{
+    WriteUInt64(stream, preferences.size());
+    for (const Preference& preference : preferences)
+    {
+        WriteUInt64(stream, preference.size());
+        for (const unsigned index : preference)
+        {
+            WriteUInt32(stream, index);
+        }
+    }
+}
+
+std::uint32_t sequential_line_search::binary_io::ReadUInt32(std::istream& stream)
+{
+    return static_cast<std::uint32_t>(ReadBytes(stream, 4));
+}
+
+std::uint64_t sequential_line_search::binary_io::ReadUInt64(std::istream& stream)
+{
+    return ReadBytes(stream, 8);
+}
+
+std::int32_t sequential_line_search::binary_io::ReadInt32(std::istream& stream)
+{
+    return static_cast<std::int32_t>(static_cast<std::uint32_t>(ReadBytes(stream, 4)));
+}
+
+bool sequential_line_search::binary_io::ReadBool(std::istream& stream)
+{
+    return ReadBytes(stream, 1) != 0;
+}
+
+double sequential_line_search::binary_io::ReadDouble(std::istream& stream)
+{
+    const std::uint64_t bits = ReadBytes(stream, 8);
+
+    double value;
+    std::memcpy(&value, &bits, sizeof(double));
+    return value;
+}
+
+VectorXd sequential_line_search::binary_io::ReadVector(std::istream& stream)
+{
+    const int size = ReadSize(stream);
+
+    CheckNumElements(stream, size, 8);
+
+    VectorXd vector(size);
+    for (int i = 0; i < size; ++i)
+    {
+        vector(i) = ReadDouble(stream);
+    }
+    return vector;
+}
+
+MatrixXd sequential_line_search::binary_io::ReadMatrix(std::istream& stream)
+{
+    const std::uint64_t rows = ReadSize(stream);
+    const std::uint64_t cols = ReadSize(stream);
+
+    // Each size is at most 2^31 - 1, so the product does not overflow
+    CheckNumElements(stream, rows * cols, 8);
+
+    MatrixXd matrix(rows, cols);
+    for (int j = 0; j < matrix.cols(); ++j)
+    {
+        for (int i = 0; i < matrix.rows(); ++i)
+        {
+            matrix(i, j) = ReadDouble(stream);
+        }
+    }
+    return matrix;
+}
+
+std::vector<sequential_line_search::Preference> sequential_line_search::binary_io::ReadPreferences(std::istream& stream)
+{
+    const std::uint64_t num_preferences = ReadSize(stream);
+
+    // Each preference has at least its size
+    CheckNumElements(stream, num_preferences, 8);
+
+    std::vector<Preference> preferences;
+    preferences.reserve(num_preferences);
+    for (std::uint64_t p = 0; p < num_preferences; ++p)
+    {
+        const std::uint64_t num_indices = ReadSize(stream);
+
+        CheckNumElements(stream, num_indices, 4);
+
+        std::vector<unsigned> indices(num_indices);
+        for (unsigned& index : indices)
+        {
+            index = ReadUInt32(stream);
+        }
+        preferences.push_back(Preference(indices));
+    }
+    return preferences;
+}
+
+std::uint32_t sequential_line_search::binary_io::ReadEnum(std::istream& stream, const std::uint32_t num_values)
+{
+    const std::uint32_t value = ReadUInt32(stream);
+    if (value >= num_values)
+    {
+        throw std::runtime_error("Invalid enum value in a binary snapshot.");
+    }
+    return value;
+}
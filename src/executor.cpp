@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <atomic>
+#include <sequential-line-search/executor.hpp>
+#include <sequential-line-search/thread-pool.hpp>
+
+std::shared_ptr<sequential_line_search::Executor> sequential_line_search::GetDefaultExecutor()
+{
+    // Created on first use (thread-safely) and shared by all the instances in the process
+    static const std::shared_ptr<Executor> executor = std::make_shared<ThreadPool>();
+
+    return executor;
+}
+
+void sequential_line_search::ParallelFor(Executor*                       executor,
+                                         const int                       num_iters,
+                                         const std::function<void(int)>& func)
+{
+    const int num_helpers = (executor == nullptr) ? 0 : std::min(executor->GetConcurrency(), num_iters) - 1;
+
+    if (num_helpers <= 0)
+    {
+        // As in the parallel case, the remaining iterations still run after an exception
+        std::exception_ptr exception;
+        for (int i = 0; i < num_iters; ++i)
+        {
+            try
+            {
+                func(i);
+            }
+            catch (...)
+            {
+                if (!exception)
+                {
+                    exception = std::current_exception();
+                }
+            }
+        }
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+        return;
+    }
+
+    struct State
+    {
+        std::atomic<int>        next_iter;
+        std::mutex              mutex;
+        std::condition_variable condition;
+        int                     num_finished_iters;
+        std::exception_ptr      exception;
+    };
+
+    const auto state = std::make_shared<State>();
+
+    state->next_iter          = 0;
+    state->num_finished_iters = 0;
+
+    // A helper may start after all the iterations have been taken, even after this function returns; it touches `func`
+    // only when it takes an iteration, which this function waits for
+    const auto run_iters = [state, num_iters, &func]()
+    {
+        int i;
+        while ((i = state->next_iter++) < num_iters)
+        {
+            std::exception_ptr exception;
+            try
+            {
+                func(i);
+            }
+            catch (...)
+            {
+                exception = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(state->mutex);
+
+            if (exception && !state->exception)
+            {
+                state->exception = exception;
+            }
+            if (++state->num_finished_iters == num_iters)
+            {
+                state->condition.notify_all();
+            }
+        }
+    };
+
+    for (int k = 0; k < num_helpers; ++k)
+    {
+        executor->Submit(run_iters);
+    }
+
+    run_iters();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->condition.wait(lock, [&]() { return state->num_finished_iters == num_iters; });
+
+    if (state->exception)
+    {
+        std::rethrow_exception(state->exception);
+    }
+}
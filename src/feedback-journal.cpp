@@ -0,0 +1,275 @@
+#include <cassert>
+#include <cstdint>
+#include <fstream>
+#include <sequential-line-search/binary-io.hpp>
+#include <sequential-line-search/feedback-journal.hpp>
+#include <sequential-line-search/preference-data-manager.hpp>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using Eigen::VectorXd;
+
+namespace
+{
+    const std::string   journal_magic   = "SLSJ";
+    const std::uint32_t journal_version = 1;
+
+    constexpr int header_size = 8;
+
+    /// \brief Sanity limits so that a corrupted record does not cause a huge allocation.
+    constexpr std::uint32_t max_num_dims   = 1 << 16;
+    constexpr std::uint32_t max_num_points = 1 << 16;
+
+    std::uint32_t CalcCrc32(const std::string& bytes)
+    {
+        // CRC-32 (IEEE 802.3) computed bitwise; records are small, so a lookup table is not worth it
+        std::uint32_t crc = 0xffffffff;
+        for (const char byte : bytes)
+        {
+            crc ^= static_cast<unsigned char>(byte);
+            for (int k = 0; k < 8; ++k)
+            {
+                crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+            }
+        }
+        return ~crc;
+    }
+
+    /// \brief Read the valid records and return the length of the valid part of the file in bytes.
+    std::uint64_t ReadValidRecords(std::istream& stream, std::vector<sequential_line_search::FeedbackRecord>* records)
+    {
+        using namespace sequential_line_search;
+
+        binary_io::ReadHeader(stream, journal_magic, journal_version);
+
+        std::uint64_t valid_length = header_size;
+        while (true)
+        {
+            std::string record_bytes(8, '\0');
+            if (!stream.read(&record_bytes[0], 8))
+            {
+                break;
+            }
+
+            std::istringstream  sizes(record_bytes);
+            const std::uint32_t num_dims   = binary_io::ReadUInt32(sizes);
+            const std::uint32_t num_points = binary_io::ReadUInt32(sizes);
+            if (num_dims == 0 || num_dims > max_num_dims || num_points == 0 || num_points > max_num_points)
+            {
+                break;
+            }
+
+            const std::uint64_t payload_size = 8 * static_cast<std::uint64_t>(num_dims) * num_points;
+
+            std::string payload_bytes(payload_size + 4, '\0');
+            if (!stream.read(&payload_bytes[0], payload_size + 4))
+            {
+                break;
+            }
+            record_bytes += payload_bytes.substr(0, payload_size);
+
+            std::istringstream checksum(payload_bytes.substr(payload_size));
+            if (binary_io::ReadUInt32(checksum) != CalcCrc32(record_bytes))
+            {
+                break;
+            }
+
+            std::istringstream payload(payload_bytes);
+            FeedbackRecord     record;
+            for (std::uint32_t p = 0; p < num_points; ++p)
+            {
+                VectorXd x(num_dims);
+                for (std::uint32_t i = 0; i < num_dims; ++i)
+                {
+                    x(i) = binary_io::ReadDouble(payload);
+                }
+
+                if (p == 0)
+                {
+                    record.x_preferable = x;
+                }
+                else
+                {
+                    record.xs_other.push_back(x);
+                }
+            }
+
+            if (records != nullptr)
+            {
+                records->push_back(record);
+            }
+            valid_length += record_bytes.size() + 4;
+        }
+
+        return valid_length;
+    }
+} // namespace
+
+sequential_line_search::FeedbackJournal::FeedbackJournal(const std::string&      file_path,
+                                                         const JournalSyncPolicy sync_policy,
+                                                         const int               sync_interval)
+    : m_file(nullptr), m_sync_policy(sync_policy), m_sync_interval(sync_interval), m_num_unsynced_records(0)
+{
+    // Find the valid part of the existing journal (if any)
+    std::uint64_t valid_length = 0;
+    {
+        std::ifstream stream(file_path, std::ios::binary);
+        if (stream && stream.peek() != std::ifstream::traits_type::eof())
+        {
+            valid_length = ReadValidRecords(stream, nullptr);
+        }
+    }
+
+    m_file = std::fopen(file_path.c_str(), "ab");
+    if (m_file == nullptr)
+    {
+        throw std::runtime_error("Failed to open " + file_path + ".");
+    }
+
+    // Discard a torn record left by a crash so that the records appended from now on remain readable
+#ifdef _WIN32
+    const int result = _chsize_s(_fileno(m_file), valid_length);
+#else
+    const int result = ftruncate(fileno(m_file), valid_length);
+#endif
+    if (result != 0)
+    {
+        std::fclose(m_file);
+        throw std::runtime_error("Failed to truncate " + file_path + ".");
+    }
+
+    if (valid_length == 0)
+    {
+        std::ostringstream header;
+        binary_io::WriteHeader(header, journal_magic, journal_version);
+
+        const std::string bytes = header.str();
+        if (std::fwrite(bytes.data(), 1, bytes.size(), m_file) != bytes.size())
+        {
+            std::fclose(m_file);
+            throw std::runtime_error("Failed to write " + file_path + ".");
+        }
+
+        try
+        {
+            Sync();
+        }
+        catch (...)
+        {
+            std::fclose(m_file);
+            throw;
+        }
+    }
+}
+
+sequential_line_search::FeedbackJournal::~FeedbackJournal()
+{
+    // A destructor must not throw; a failure here cannot be reported anyway
+    try
+    {
+        Sync();
+    }
+    catch (const std::runtime_error&)
+    {
+    }
+    std::fclose(m_file);
+}
+
+void sequential_line_search::FeedbackJournal::Append(const VectorXd&              x_preferable,
+                                                     const std::vector<VectorXd>& xs_other)
+{
+    const std::uint32_t num_dims = x_preferable.size();
+
+    std::ostringstream record;
+    binary_io::WriteUInt32(record, num_dims);
+    binary_io::WriteUInt32(record, 1 + xs_other.size());
+    for (int i = 0; i < x_preferable.size(); ++i)
+    {
+        binary_io::WriteDouble(record, x_preferable(i));
+    }
+    for (const VectorXd& x : xs_other)
+    {
+        assert(static_cast<std::uint32_t>(x.size()) == num_dims);
+
+        for (int i = 0; i < x.size(); ++i)
+        {
+            binary_io::WriteDouble(record, x(i));
+        }
+    }
+    binary_io::WriteUInt32(record, CalcCrc32(record.str()));
+
+    const std::string bytes = record.str();
+    if (std::fwrite(bytes.data(), 1, bytes.size(), m_file) != bytes.size() || std::fflush(m_file) != 0)
+    {
+        throw std::runtime_error("Failed to write a journal record.");
+    }
+
+    ++m_num_unsynced_records;
+
+    switch (m_sync_policy)
+    {
+        case JournalSyncPolicy::EveryRecord:
+            Sync();
+            break;
+        case JournalSyncPolicy::EveryNRecords:
+            if (m_num_unsynced_records >= m_sync_interval)
+            {
+                Sync();
+            }
+            break;
+        case JournalSyncPolicy::OnClose:
+            break;
+    }
+}
+
+void sequential_line_search::FeedbackJournal::Sync()
+{
+#ifdef _WIN32
+    const bool is_synced = std::fflush(m_file) == 0 && _commit(_fileno(m_file)) == 0;
+#else
+    const bool is_synced = std::fflush(m_file) == 0 && fsync(fileno(m_file)) == 0;
+#endif
+    if (!is_synced)
+    {
+        throw std::runtime_error("Failed to sync a journal.");
+    }
+
+    m_num_unsynced_records = 0;
+}
+
+std::vector<sequential_line_search::FeedbackRecord>
+sequential_line_search::FeedbackJournal::Read(const std::string& file_path)
+{
+    std::ifstream stream(file_path, std::ios::binary);
+    if (!stream)
+    {
+        throw std::runtime_error("Failed to open " + file_path + ".");
+    }
+
+    std::vector<FeedbackRecord> records;
+    ReadValidRecords(stream, &records);
+
+    return records;
+}
+
+void sequential_line_search::AddFeedbackRecords(const std::vector<FeedbackRecord>& records,
+                                                PreferenceDataManager*             data)
+{
+    int num_points = data->GetNumDataPoints();
+    for (const FeedbackRecord& record : records)
+    {
+        num_points += 1 + record.xs_other.size();
+    }
+    data->Reserve(num_points, data->GetD().size() + records.size());
+
+    for (const FeedbackRecord& record : records)
+    {
+        data->AddNewPoints(record.x_preferable, record.xs_other, true);
+    }
+}
@@ -15,13 +15,9 @@ namespace
 {
     using namespace sequential_line_search;
 
-    const bool   use_log_normal_prior  = true;
-    const double a_prior_mu            = std::log(0.500);
-    const double a_prior_sigma_squared = 0.50;
-    const double b_prior_mu            = std::log(1e-04);
-    const double b_prior_sigma_squared = 0.50;
-    const double r_prior_mu            = std::log(0.500);
-    const double r_prior_sigma_squared = 0.50;
+    /// \brief The number of data points from which the derivatives with respect to the hyperparameters are computed
+    /// in parallel. Each derivative involves O(N^3) products, which do not pay off the dispatch for small N.
+    constexpr unsigned min_num_data_points_for_parallel_derivatives = 64;
 
     inline VectorXd Concat(const double scalar, const VectorXd& vector)
     {
@@ -33,121 +29,146 @@ namespace
         return result;
     }
 
-    double calc_grad_a_prior(const double a)
+    double calc_grad_a_prior(const double a, const GaussianProcessHyperparamsPrior& prior)
     {
-        return mathtoolbox::GetLogOfLogNormalDistDerivative(a, a_prior_mu, a_prior_sigma_squared);
+        return mathtoolbox::GetLogOfLogNormalDistDerivative(a, prior.signal_var_mu, prior.signal_var_sigma_squared);
     }
 
-    double calc_grad_b_prior(const double b)
+    double calc_grad_b_prior(const double b, const GaussianProcessHyperparamsPrior& prior)
     {
-        return mathtoolbox::GetLogOfLogNormalDistDerivative(b, b_prior_mu, b_prior_sigma_squared);
+        return mathtoolbox::GetLogOfLogNormalDistDerivative(b, prior.noise_level_mu, prior.noise_level_sigma_squared);
     }
 
-    double calc_grad_r_i_prior(const Eigen::VectorXd& r, const int index)
+    double calc_grad_r_i_prior(const Eigen::VectorXd& r, const int index, const GaussianProcessHyperparamsPrior& prior)
     {
-        return mathtoolbox::GetLogOfLogNormalDistDerivative(r(index), r_prior_mu, r_prior_sigma_squared);
+        return mathtoolbox::GetLogOfLogNormalDistDerivative(
+            r(index), prior.length_scale_mu, prior.length_scale_sigma_squared);
     }
 
-    double calc_a_prior(const double a)
+    double calc_a_prior(const double a, const GaussianProcessHyperparamsPrior& prior)
     {
-        return mathtoolbox::GetLogOfLogNormalDist(a, a_prior_mu, a_prior_sigma_squared);
+        return mathtoolbox::GetLogOfLogNormalDist(a, prior.signal_var_mu, prior.signal_var_sigma_squared);
     }
 
-    double calc_b_prior(const double b)
+    double calc_b_prior(const double b, const GaussianProcessHyperparamsPrior& prior)
     {
-        return mathtoolbox::GetLogOfLogNormalDist(b, b_prior_mu, b_prior_sigma_squared);
+        return mathtoolbox::GetLogOfLogNormalDist(b, prior.noise_level_mu, prior.noise_level_sigma_squared);
     }
 
-    double calc_r_i_prior(const Eigen::VectorXd& r, const int index)
+    double calc_r_i_prior(const Eigen::VectorXd& r, const int index, const GaussianProcessHyperparamsPrior& prior)
     {
-        return mathtoolbox::GetLogOfLogNormalDist(r(index), r_prior_mu, r_prior_sigma_squared);
+        return mathtoolbox::GetLogOfLogNormalDist(r(index), prior.length_scale_mu, prior.length_scale_sigma_squared);
     }
 
-    double calc_grad_b(const MatrixXd& X,
-                       const MatrixXd& K_y_inv,
-                       const VectorXd& y,
-                       const double    a,
-                       const double    b,
-                       const VectorXd& r)
+    double calc_grad_b(const MatrixXd&                        X,
+                       const MatrixXd&                        K_y_inv,
+                       const VectorXd&                        y,
+                       const double                           a,
+                       const double                           b,
+                       const VectorXd&                        r,
+                       const GaussianProcessHyperparamsPrior& prior)
     {
         const MatrixXd K_y_grad_b = CalcLargeKYNoiseLevelDerivative(X, Concat(a, r), b);
         const double   term1      = +0.5 * y.transpose() * K_y_inv * K_y_grad_b * K_y_inv * y;
         const double   term2      = -0.5 * (K_y_inv * K_y_grad_b).trace();
-        return term1 + term2 + (use_log_normal_prior ? calc_grad_b_prior(b) : 0.0);
+        return term1 + term2 + (prior.use_log_normal_prior ? calc_grad_b_prior(b, prior) : 0.0);
     }
 
-    VectorXd calc_grad_theta(const MatrixXd&             X,
-                             const MatrixXd&             K_y_inv,
-                             const VectorXd&             y,
-                             const VectorXd&             kernel_hyperparams,
-                             const KernelThetaDerivative kernel_theta_derivative)
+    VectorXd calc_grad_theta(const MatrixXd&                        X,
+                             const MatrixXd&                        K_y_inv,
+                             const VectorXd&                        y,
+                             const VectorXd&                        kernel_hyperparams,
+                             const KernelThetaDerivative            kernel_theta_derivative,
+                             const GaussianProcessHyperparamsPrior& prior,
+                             Executor*                              executor)
     {
         const std::vector<MatrixXd> tensor = CalcLargeKYThetaDerivative(X, kernel_hyperparams, kernel_theta_derivative);
 
         VectorXd grad(kernel_hyperparams.size());
-        for (unsigned i = 0; i < kernel_hyperparams.size(); ++i)
+
+        const auto calc_grad_theta_i = [&](const int i)
         {
             const MatrixXd& K_y_grad_r_i = tensor[i];
 
             const double term1 = +0.5 * y.transpose() * K_y_inv * K_y_grad_r_i * K_y_inv * y;
             const double term2 = -0.5 * (K_y_inv * K_y_grad_r_i).trace();
 
-            const double prior =
-                use_log_normal_prior
-                    ? (i == 0
-                           ? calc_grad_a_prior(kernel_hyperparams(i))
-                           : calc_grad_r_i_prior(kernel_hyperparams.segment(1, kernel_hyperparams.size() - 1), i - 1))
+            const double term3 =
+                prior.use_log_normal_prior
+                    ? (i == 0 ? calc_grad_a_prior(kernel_hyperparams(i), prior)
+                              : calc_grad_r_i_prior(
+                                    kernel_hyperparams.segment(1, kernel_hyperparams.size() - 1), i - 1, prior))
                     : 0.0;
 
-            grad(i) = term1 + term2 + prior;
-        }
+            grad(i) = term1 + term2 + term3;
+        };
+
+        ParallelFor(X.cols() >= min_num_data_points_for_parallel_derivatives ? executor : nullptr,
+                    kernel_hyperparams.size(),
+                    calc_grad_theta_i);
 
         return grad;
     }
 
-    VectorXd calc_grad(const MatrixXd&             X,
-                       const MatrixXd&             K_y_inv,
-                       const VectorXd&             y,
-                       const double                a,
-                       const double                b,
-                       const VectorXd&             r,
-                       const KernelThetaDerivative kernel_theta_derivative)
+    VectorXd calc_grad(const MatrixXd&                        X,
+                       const MatrixXd&                        K_y_inv,
+                       const VectorXd&                        y,
+                       const double                           a,
+                       const double                           b,
+                       const VectorXd&                        r,
+                       const KernelThetaDerivative            kernel_theta_derivative,
+                       const GaussianProcessHyperparamsPrior& prior,
+                       Executor*                              executor)
     {
         const unsigned D = X.rows();
 
         VectorXd grad(D + 2);
 
-        const VectorXd grad_theta = calc_grad_theta(X, K_y_inv, y, Concat(a, r), kernel_theta_derivative);
+        const VectorXd grad_theta =
+            calc_grad_theta(X, K_y_inv, y, Concat(a, r), kernel_theta_derivative, prior, executor);
 
         grad(0)            = grad_theta(0);
-        grad(1)            = calc_grad_b(X, K_y_inv, y, a, b, r);
+        grad(1)            = calc_grad_b(X, K_y_inv, y, a, b, r, prior);
         grad.segment(2, D) = grad_theta.segment(1, D);
 
         return grad;
     }
 
+    /// \brief The state of a single MAP estimation. Each estimation has its own instance, so concurrent estimations
+    /// do not interfere with each other.
     struct Data
     {
-        const MatrixXd              X;
-        const VectorXd              y;
-        const Kernel                kernel;
-        const KernelThetaDerivative kernel_theta_derivative;
+        const MatrixXd                        X;
+        const VectorXd                        y;
+        const Kernel                          kernel;
+        const KernelThetaDerivative           kernel_theta_derivative;
+        const GaussianProcessHyperparamsPrior prior;
+        Executor* const                       executor;
+        const CancellationToken* const        cancellation_token;
+
+        /// \brief The number of objective evaluations so far.
+        unsigned num_evaluations;
     };
 
-    // For counting the number of function evaluations
-    unsigned count;
-
     // Log likelihood that will be maximized
     double objective(const std::vector<double>& x, std::vector<double>& grad, void* data)
     {
+        // Throwing this makes nlopt force-stop the estimation, which then returns the best solution found so far
+        if (IsCancelled(static_cast<const Data*>(data)->cancellation_token))
+        {
+            throw nlopt::forced_stop();
+        }
+
         // For counting the number of function evaluations
-        ++count;
+        ++static_cast<Data*>(data)->num_evaluations;
 
         const MatrixXd& X = static_cast<const Data*>(data)->X;
         const VectorXd& y = static_cast<const Data*>(data)->y;
 
-        const auto kernel                  = static_cast<const Data*>(data)->kernel;
-        const auto kernel_theta_derivative = static_cast<const Data*>(data)->kernel_theta_derivative;
+        const auto  kernel                  = static_cast<const Data*>(data)->kernel;
+        const auto  kernel_theta_derivative = static_cast<const Data*>(data)->kernel_theta_derivative;
+        const auto& prior                   = static_cast<const Data*>(data)->prior;
+        const auto  executor                = static_cast<const Data*>(data)->executor;
 
         const unsigned N = X.cols();
 
@@ -161,7 +182,7 @@ namespace
         // When the algorithm is gradient-based, compute the gradient vector
         if (grad.size() == x.size())
         {
-            const VectorXd g = calc_grad(X, K_y_inv, y, a, b, r, kernel_theta_derivative);
+            const VectorXd g = calc_grad(X, K_y_inv, y, a, b, r, kernel_theta_derivative, prior, executor);
             for (unsigned i = 0; i < g.rows(); ++i)
             {
                 grad[i] = g(i);
@@ -176,18 +197,18 @@ namespace
         const double term3 = -0.5 * N * std::log(prod_of_two_and_pi);
 
         // Computing the regularization terms from a prior assumptions
-        const double a_prior = calc_a_prior(a);
-        const double b_prior = calc_b_prior(b);
-        const double r_prior = [&r]()
+        const double a_prior = calc_a_prior(a, prior);
+        const double b_prior = calc_b_prior(b, prior);
+        const double r_prior = [&r, &prior]()
         {
             double sum = 0.0;
             for (unsigned i = 0; i < r.rows(); ++i)
             {
-                sum += calc_r_i_prior(r, i);
+                sum += calc_r_i_prior(r, i, prior);
             }
             return sum;
         }();
-        const double regularization = use_log_normal_prior ? (a_prior + b_prior + r_prior) : 0.0;
+        const double regularization = prior.use_log_normal_prior ? (a_prior + b_prior + r_prior) : 0.0;
 
         return term1 + term2 + term3 + regularization;
     }
@@ -195,9 +216,12 @@ namespace
 
 namespace sequential_line_search
 {
-    GaussianProcessRegressor::GaussianProcessRegressor(const MatrixXd&  X,
-                                                       const VectorXd&  y,
-                                                       const KernelType kernel_type)
+    GaussianProcessRegressor::GaussianProcessRegressor(const MatrixXd&                        X,
+                                                       const VectorXd&                        y,
+                                                       const KernelType                       kernel_type,
+                                                       const GaussianProcessHyperparamsPrior& prior,
+                                                       const std::shared_ptr<Executor>&       executor,
+                                                       const CancellationToken*               cancellation_token)
         : Regressor(kernel_type), m_X(X), m_y(y)
     {
         if (X.rows() == 0)
@@ -205,7 +229,8 @@ namespace sequential_line_search
             return;
         }
 
-        PerformMapEstimation();
+        m_map_estimation_stats = PerformMapEstimation(
+            prior, executor != nullptr ? executor.get() : GetDefaultExecutor().get(), cancellation_token);
 
         m_K_y     = CalcLargeKY(X, m_kernel_hyperparams, m_noise_hyperparam, m_kernel);
         m_K_y_inv = m_K_y.inverse();
@@ -271,19 +296,50 @@ namespace sequential_line_search
         return -(1.0 / sigma) * k_x_derivative * m_K_y_inv * k;
     }
 
-    void GaussianProcessRegressor::PerformMapEstimation()
+    void GaussianProcessRegressor::AddDataPoint(const Eigen::VectorXd& x, const double y)
+    {
+        const unsigned N = m_X.cols();
+
+        const VectorXd k     = CalcSmallK(x, m_X, m_kernel_hyperparams, m_kernel);
+        const double   kappa = m_kernel(x, x, m_kernel_hyperparams) + m_noise_hyperparam;
+
+        // K_y_new^{-1} = [K_y^{-1} + v v^T / s, -v / s; -v^T / s, 1 / s], where v = K_y^{-1} k and s = kappa - k^T v
+        const VectorXd v = m_K_y_inv * k;
+        const double   s = kappa - k.dot(v);
+
+        m_X.conservativeResize(Eigen::NoChange, N + 1);
+        m_X.col(N) = x;
+
+        m_y.conservativeResize(N + 1);
+        m_y(N) = y;
+
+        m_K_y.conservativeResize(N + 1, N + 1);
+        m_K_y.block(0, N, N, 1) = k;
+        m_K_y.block(N, 0, 1, N) = k.transpose();
+        m_K_y(N, N)             = kappa;
+
+        m_K_y_inv.conservativeResize(N + 1, N + 1);
+        m_K_y_inv.block(0, 0, N, N) += (v * v.transpose()) / s;
+        m_K_y_inv.block(0, N, N, 1) = -v / s;
+        m_K_y_inv.block(N, 0, 1, N) = -v.transpose() / s;
+        m_K_y_inv(N, N)             = 1.0 / s;
+    }
+
+    MapEstimationStats GaussianProcessRegressor::PerformMapEstimation(const GaussianProcessHyperparamsPrior& prior,
+                                                                      Executor*                              executor,
+                                                                      const CancellationToken* cancellation_token)
     {
         const unsigned D = m_X.rows();
 
-        Data data{m_X, m_y, m_kernel, m_kernel_theta_derivative};
+        Data data{m_X, m_y, m_kernel, m_kernel_theta_derivative, prior, executor, cancellation_token, 0};
 
         const VectorXd x_ini = [&]()
         {
             VectorXd x(D + 2);
 
-            x(0)            = std::exp(a_prior_mu);
-            x(1)            = std::exp(b_prior_mu);
-            x.segment(2, D) = VectorXd::Constant(D, std::exp(r_prior_mu));
+            x(0)            = std::exp(prior.signal_var_mu);
+            x(1)            = std::exp(prior.noise_level_mu);
+            x.segment(2, D) = VectorXd::Constant(D, std::exp(prior.length_scale_mu));
 
             return x;
         }();
@@ -291,10 +347,23 @@ namespace sequential_line_search
         const VectorXd upper = VectorXd::Constant(D + 2, 5e+01);
         const VectorXd lower = VectorXd::Constant(D + 2, 1e-08);
 
+        MapEstimationStats stats;
+
         const VectorXd x_glo = nloptutil::solve(x_ini, upper, lower, objective, nlopt::GN_DIRECT, &data, true, 300);
-        const VectorXd x_loc = nloptutil::solve(x_glo, upper, lower, objective, nlopt::LD_TNEWTON, &data, true, 1000);
+
+        stats.num_global_search_evaluations = data.num_evaluations;
+
+        // The local refinement is skipped if the estimation has been cancelled during the global search
+        const VectorXd x_loc =
+            IsCancelled(cancellation_token)
+                ? x_glo
+                : nloptutil::solve(x_glo, upper, lower, objective, nlopt::LD_TNEWTON, &data, true, 1000);
+
+        stats.num_local_search_evaluations = data.num_evaluations - stats.num_global_search_evaluations;
 
         m_kernel_hyperparams = Concat(x_loc(0), x_loc.segment(2, D));
         m_noise_hyperparam   = x_loc(1);
+
+        return stats;
     }
 } // namespace sequential_line_search
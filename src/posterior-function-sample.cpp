@@ -0,0 +1,102 @@
+#include <Eigen/Cholesky>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <mathtoolbox/constants.hpp>
+#include <random>
+#include <sequential-line-search/posterior-function-sample.hpp>
+
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+
+sequential_line_search::PosteriorFunctionSample::PosteriorFunctionSample(const Regressor& regressor,
+                                                                         const unsigned   num_features,
+                                                                         const unsigned   seed)
+{
+    const MatrixXd& X     = regressor.GetLargeX();
+    const VectorXd& y     = regressor.GetSmallY();
+    const VectorXd& theta = regressor.GetKernelHyperparams();
+
+    const unsigned d = X.rows();
+    const unsigned m = num_features;
+
+    // This code assumes that the kernel is either ARD squared exponential or ARD Matern and the first hyperparameter
+    // represents the intensity of the kernel.
+    assert(theta.size() == d + 1);
+    const double   signal_var    = theta(0);
+    const VectorXd length_scales = theta.segment(1, d);
+
+    std::mt19937                           engine(seed);
+    std::normal_distribution<double>       normal_dist(0.0, 1.0);
+    std::uniform_real_distribution<double> uniform_dist(0.0, 2.0 * mathtoolbox::constants::pi);
+    std::chi_squared_distribution<double>  chi_squared_dist(5.0);
+
+    // Draw frequencies from the spectral density of the kernel: a Gaussian for the squared exponential kernel and a
+    // Student's t with five degrees of freedom (i.e., 2 * nu) for the Matern 5/2 kernel.
+    m_Omega  = MatrixXd(m, d);
+    m_phases = VectorXd(m);
+    for (unsigned i = 0; i < m; ++i)
+    {
+        const double scale = (regressor.GetKernelType() == KernelType::ArdMatern52Kernel)
+                                 ? std::sqrt(5.0 / chi_squared_dist(engine))
+                                 : 1.0;
+
+        for (unsigned j = 0; j < d; ++j)
+        {
+            m_Omega(i, j) = scale * normal_dist(engine) / length_scales(j);
+        }
+        m_phases(i) = uniform_dist(engine);
+    }
+
+    const double feature_scale = std::sqrt(2.0 * signal_var / static_cast<double>(m));
+
+    // Feature matrix (N x m)
+    const MatrixXd Phi =
+        feature_scale * ((X.transpose() * m_Omega.transpose()).rowwise() + m_phases.transpose()).array().cos().matrix();
+
+    // Note: The noise level can be zero when the noiseless formulation is used; a small jitter keeps the system
+    // well-conditioned.
+    const double noise_level = std::max(regressor.GetNoiseHyperparam(), 1e-08);
+
+    // Posterior of the weights: N(A^{-1} Phi^T y, noise_level * A^{-1}) where A = Phi^T Phi + noise_level * I
+    MatrixXd A = Phi.transpose() * Phi;
+    A.diagonal().array() += noise_level;
+
+    const Eigen::LLT<MatrixXd> A_llt(A);
+    const VectorXd             w_mean = A_llt.solve(Phi.transpose() * y);
+
+    VectorXd z(m);
+    for (unsigned i = 0; i < m; ++i)
+    {
+        z(i) = normal_dist(engine);
+    }
+
+    // A = L L^T, so L^{-T} z follows N(0, A^{-1})
+    const VectorXd w = w_mean + std::sqrt(noise_level) * VectorXd(A_llt.matrixU().solve(z));
+
+    m_weights = feature_scale * w;
+}
+
+double sequential_line_search::PosteriorFunctionSample::Evaluate(const VectorXd& x) const
+{
+    return m_weights.dot(((m_Omega * x) + m_phases).array().cos().matrix());
+}
+
+VectorXd sequential_line_search::PosteriorFunctionSample::EvaluateDerivative(const VectorXd& x) const
+{
+    const VectorXd s = ((m_Omega * x) + m_phases).array().sin().matrix();
+    return -m_Omega.transpose() * m_weights.cwiseProduct(s);
+}
+
+VectorXd sequential_line_search::PosteriorFunctionSample::EvaluateInBatch(const MatrixXd& X,
+                                                                          MatrixXd*       derivatives) const
+{
+    const MatrixXd Z = (m_Omega * X).colwise() + m_phases;
+
+    if (derivatives != nullptr)
+    {
+        *derivatives = -m_Omega.transpose() * (Z.array().sin().colwise() * m_weights.array()).matrix();
+    }
+
+    return Z.array().cos().matrix().transpose() * m_weights;
+}
@@ -1,141 +1,675 @@
-#include <map>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <sequential-line-search/binary-io.hpp>
 #include <sequential-line-search/preference-data-manager.hpp>
+#include <sequential-line-search/utils.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
 
 using Eigen::MatrixXd;
 using Eigen::VectorXd;
 
-namespace internal
+namespace
 {
-    /// \brief Merge sampled points that are sufficiently closer.
-    /// \param epsilon The threshold of the distance between sampled points to be merged
-    void MergeClosePoints(const double epsilon, Eigen::MatrixXd& X, std::vector<sequential_line_search::Preference>& D);
-} // namespace internal
+    /// \brief The number of leading coordinates used for the hash grid. Using only a few coordinates keeps the number
+    /// of neighboring cells (3^k) small even in high-dimensional spaces; the grid is only for finding candidates and
+    /// the actual distances are checked afterward.
+    constexpr int max_num_grid_dims = 3;
 
-void internal::MergeClosePoints(const double                                     epsilon,
-                                Eigen::MatrixXd&                                 X,
-                                std::vector<sequential_line_search::Preference>& D)
+    std::vector<std::int64_t> CalcCell(const VectorXd& x, const double cell_size)
+    {
+        const int num_grid_dims = std::min(static_cast<int>(x.size()), max_num_grid_dims);
+
+        std::vector<std::int64_t> cell(num_grid_dims);
+        for (int i = 0; i < num_grid_dims; ++i)
+        {
+            cell[i] = static_cast<std::int64_t>(std::floor(x(i) / cell_size));
+        }
+        return cell;
+    }
+
+    std::uint64_t CalcCellKey(const std::vector<std::int64_t>& cell)
+    {
+        // Spatial hashing [Teschner et al. 2003]; collisions only add candidates
+        constexpr std::uint64_t primes[max_num_grid_dims] = {73856093, 19349663, 83492791};
+
+        std::uint64_t key = 0;
+        for (unsigned i = 0; i < cell.size(); ++i)
+        {
+            key ^= static_cast<std::uint64_t>(cell[i]) * primes[i];
+        }
+        return key;
+    }
+
+    /// \brief Throw `std::invalid_argument` if the points are to be merged with a non-positive threshold, which is also
+    /// the cell size of the hash grid (i.e., a divisor).
+    void CheckMergeThreshold(const bool merge_close_points, const double epsilon)
+    {
+        if (merge_close_points && !(epsilon > 0.0 && std::isfinite(epsilon)))
+        {
+            throw std::invalid_argument("epsilon must be positive and finite.");
+        }
+    }
+
+    std::vector<sequential_line_search::Preference> ImportPreferencesFromCsv(const std::string& file_path)
+    {
+        std::ifstream file(file_path);
+        if (!file)
+        {
+            throw std::runtime_error("Failed to open " + file_path + ".");
+        }
+
+        std::vector<sequential_line_search::Preference> preferences;
+
+        std::string line;
+        while (std::getline(file, line))
+        {
+            if (line.empty())
+            {
+                continue;
+            }
+
+            std::vector<unsigned> indices;
+
+            std::istringstream line_stream(line);
+            std::string        token;
+            while (std::getline(line_stream, token, ','))
+            {
+                std::istringstream token_stream(token);
+
+                unsigned index;
+                if (!(token_stream >> index))
+                {
+                    throw std::runtime_error("Invalid index in " + file_path + ".");
+                }
+                indices.push_back(index);
+            }
+            preferences.push_back(sequential_line_search::Preference(indices));
+        }
+
+        return preferences;
+    }
+} // namespace
+
+sequential_line_search::PreferenceDataManager::PreferenceDataManager()
+    : m_num_data_points(0),
+      m_reserved_capacity(0),
+      m_grid_cell_size(0.0),
+      m_num_indexed_points(0),
+      m_retention_policy(RetentionPolicy::KeepAll),
+      m_max_num_data_points(0)
+{
+}
+
+void sequential_line_search::PreferenceDataManager::AddNewPoints(const Eigen::VectorXd&              x_preferable,
+                                                                 const std::vector<Eigen::VectorXd>& xs_other,
+                                                                 const bool                          merge_close_points,
+                                                                 const double                        epsilon)
+{
+    CheckMergeThreshold(merge_close_points, epsilon);
+
+    const unsigned d = x_preferable.rows();
+    const unsigned N = m_num_data_points;
+
+    EnsureCapacity(d, N + xs_other.size() + 1);
+
+    // X
+    m_X.col(N) = x_preferable;
+    for (unsigned i = 0; i < xs_other.size(); ++i)
+    {
+        m_X.col(N + i + 1) = xs_other[i];
+    }
+    m_num_data_points = N + xs_other.size() + 1;
+
+    // D
+    std::vector<unsigned> indices(xs_other.size() + 1);
+    for (unsigned i = 0; i < xs_other.size() + 1; ++i)
+    {
+        indices[i] = N + i;
+    }
+    m_D.push_back(Preference(indices));
+
+    // Merge
+    if (merge_close_points && N != 0)
+    {
+        MergeClosePoints(epsilon);
+    }
+
+    // Retention
+    ApplyRetentionPolicy();
+}
+
+void sequential_line_search::PreferenceDataManager::Reserve(const int num_data_points, const int num_preferences)
+{
+    if (m_X.rows() == 0)
+    {
+        m_reserved_capacity = std::max(m_reserved_capacity, num_data_points);
+    }
+    else
+    {
+        EnsureCapacity(m_X.rows(), num_data_points);
+    }
+
+    m_D.reserve(num_preferences);
+}
+
+void sequential_line_search::PreferenceDataManager::AddData(const MatrixXd&                X,
+                                                            const std::vector<Preference>& D,
+                                                            const bool                     merge_close_points,
+                                                            const double                   epsilon)
+{
+    CheckMergeThreshold(merge_close_points, epsilon);
+
+    // Copying columns between matrices of different heights would corrupt the memory
+    if (m_num_data_points != 0 && X.cols() != 0 && X.rows() != m_X.rows())
+    {
+        throw std::runtime_error("Inconsistent number of dimensions of the data points.");
+    }
+
+    for (const Preference& preference : D)
+    {
+        if (preference.size() < 2)
+        {
+            throw std::runtime_error("A preference must have two or more data points.");
+        }
+        for (const unsigned index : preference)
+        {
+            if (index >= static_cast<unsigned>(X.cols()))
+            {
+                throw std::runtime_error("Invalid index in a preference.");
+            }
+        }
+    }
+
+    if (X.cols() == 0)
+    {
+        return;
+    }
+
+    const unsigned N = m_num_data_points;
+
+    // X
+    EnsureCapacity(X.rows(), N + X.cols());
+    m_X.middleCols(N, X.cols()) = X;
+    m_num_data_points = N + X.cols();
+
+    // D
+    m_D.reserve(m_D.size() + D.size());
+    for (const Preference& preference : D)
+    {
+        std::vector<unsigned> indices(preference.size());
+        for (unsigned i = 0; i < preference.size(); ++i)
+        {
+            indices[i] = N + preference[i];
+        }
+        m_D.push_back(Preference(indices));
+    }
+
+    // Merge
+    if (merge_close_points)
+    {
+        MergeClosePoints(epsilon);
+    }
+
+    // Retention
+    if (!m_D.empty())
+    {
+        ApplyRetentionPolicy();
+    }
+}
+
+void sequential_line_search::PreferenceDataManager::ImportCsv(const std::string& directory_path,
+                                                              const std::string& prefix)
+{
+    const MatrixXd                X = utils::ImportMatrixFromCsv(directory_path + "/" + prefix + "X.csv");
+    const std::vector<Preference> D = ImportPreferencesFromCsv(directory_path + "/" + prefix + "D.csv");
+
+    AddData(X, D);
+}
+
+void sequential_line_search::PreferenceDataManager::SetRetentionPolicy(const RetentionPolicy policy,
+                                                                       const int             max_num_data_points)
+{
+    if (policy != RetentionPolicy::KeepAll && max_num_data_points <= 0)
+    {
+        throw std::invalid_argument("max_num_data_points must be positive.");
+    }
+
+    m_retention_policy    = policy;
+    m_max_num_data_points = max_num_data_points;
+
+    if (!m_D.empty())
+    {
+        ApplyRetentionPolicy();
+    }
+}
+
+void sequential_line_search::PreferenceDataManager::Save(std::ostream& stream) const
+{
+    binary_io::WriteUInt32(stream, static_cast<std::uint32_t>(m_retention_policy));
+    binary_io::WriteInt32(stream, m_max_num_data_points);
+
+    binary_io::WriteMatrix(stream, GetX());
+    binary_io::WritePreferences(stream, m_D);
+}
+
+std::shared_ptr<sequential_line_search::PreferenceDataManager>
+sequential_line_search::PreferenceDataManager::Load(std::istream& stream)
+{
+    const auto data = std::make_shared<PreferenceDataManager>();
+
+    data->m_retention_policy    = static_cast<RetentionPolicy>(
+        binary_io::ReadEnum(stream, static_cast<std::uint32_t>(RetentionPolicy::Thinning) + 1));
+    data->m_max_num_data_points = binary_io::ReadInt32(stream);
+
+    if (data->m_retention_policy != RetentionPolicy::KeepAll && data->m_max_num_data_points <= 0)
+    {
+        throw std::runtime_error("Invalid retention policy in a binary snapshot.");
+    }
+
+    data->m_X               = binary_io::ReadMatrix(stream);
+    data->m_num_data_points = data->m_X.cols();
+    data->m_D               = binary_io::ReadPreferences(stream);
+
+    for (const Preference& preference : data->m_D)
+    {
+        for (const unsigned index : preference)
+        {
+            if (index >= static_cast<unsigned>(data->m_num_data_points))
+            {
+                throw std::runtime_error("Invalid preference in a binary snapshot.");
+            }
+        }
+    }
+
+    // The hash grid is empty (with the cell size of zero), so all the points are indexed on the next addition
+    return data;
+}
+
+void sequential_line_search::PreferenceDataManager::EnsureCapacity(const int num_dims, const int num_data_points)
+{
+    if (m_X.rows() == num_dims && m_X.cols() >= num_data_points)
+    {
+        return;
+    }
+
+    // Grow the capacity geometrically so that the cost of copying is amortized
+    const int new_capacity = std::max({num_data_points, 2 * static_cast<int>(m_X.cols()), m_reserved_capacity, 8});
+
+    MatrixXd new_X(num_dims, new_capacity);
+    if (m_num_data_points != 0)
+    {
+        new_X.leftCols(m_num_data_points) = m_X.leftCols(m_num_data_points);
+    }
+    m_X.swap(new_X);
+}
+
+void sequential_line_search::PreferenceDataManager::MergeClosePoints(const double epsilon)
+{
+    // The indexed points are free of close pairs only with respect to the epsilon used for indexing them
+    if (epsilon != m_grid_cell_size)
+    {
+        m_grid_cell_size = epsilon;
+        RebuildGrid(0);
+    }
+
+    const int M = m_num_data_points;
+
+    // The index of the point that each point has been merged into, or its own index if it is kept
+    std::vector<int> merged_into(M);
+    std::iota(merged_into.begin(), merged_into.end(), 0);
+
+    bool has_merged_points = false;
+    for (int k = m_num_indexed_points; k < M; ++k)
+    {
+        int index = k;
+        int j     = FindIndexedClosePoint(m_X.col(index), epsilon);
+
+        // Replace the indexed point j by the midpoint. If the midpoint has moved close to another indexed point, which
+        // rarely happens, merge them in turn.
+        while (j >= 0)
+        {
+            RemoveFromGrid(j);
+            m_X.col(j)         = 0.5 * (m_X.col(j) + m_X.col(index));
+            merged_into[index] = j;
+            has_merged_points  = true;
+
+            index = j;
+            j     = FindIndexedClosePoint(m_X.col(index), epsilon);
+        }
+
+        AddToGrid(index);
+    }
+    m_num_indexed_points = M;
+
+    if (!has_merged_points)
+    {
+        return;
+    }
+
+    // Compact the kept points in place, and then map each merged point to the new index of the point that it has been
+    // (possibly transitively) merged into
+    std::vector<int> mapping(M);
+    int              new_index = 0;
+    for (int old_index = 0; old_index < M; ++old_index)
+    {
+        if (merged_into[old_index] == old_index)
+        {
+            if (new_index != old_index)
+            {
+                m_X.col(new_index) = m_X.col(old_index);
+            }
+            mapping[old_index] = new_index++;
+        }
+    }
+    for (int old_index = 0; old_index < M; ++old_index)
+    {
+        int target = old_index;
+        while (merged_into[target] != target)
+        {
+            target = merged_into[target];
+        }
+        mapping[old_index] = mapping[target];
+    }
+    m_num_data_points    = new_index;
+    m_num_indexed_points = new_index;
+
+    // Update the indices in the preference pairs and the hash grid
+    for (Preference& p : m_D)
+    {
+        for (unsigned i = 0; i < p.size(); ++i)
+        {
+            p[i] = mapping[p[i]];
+        }
+    }
+    for (auto& cell : m_grid)
+    {
+        for (int& index : cell.second)
+        {
+            index = mapping[index];
+        }
+    }
+}
+
+int sequential_line_search::PreferenceDataManager::FindIndexedClosePoint(const VectorXd& x, const double epsilon) const
 {
     const double eps_squared = epsilon * epsilon;
 
-    while (true)
+    const std::vector<std::int64_t> cell          = CalcCell(x, m_grid_cell_size);
+    const int                       num_grid_dims = cell.size();
+
+    // Visit all the 3^k neighboring cells
+    int num_neighbors = 1;
+    for (int i = 0; i < num_grid_dims; ++i)
     {
-        bool is_dirty = false;
+        num_neighbors *= 3;
+    }
 
-        const unsigned N = X.rows();
-        const unsigned M = X.cols();
+    std::vector<std::int64_t> neighbor(num_grid_dims);
+    for (int n = 0; n < num_neighbors; ++n)
+    {
+        int code = n;
+        for (int i = 0; i < num_grid_dims; ++i)
+        {
+            neighbor[i] = cell[i] + (code % 3) - 1;
+            code /= 3;
+        }
+
+        const auto iter = m_grid.find(CalcCellKey(neighbor));
+        if (iter == m_grid.end())
+        {
+            continue;
+        }
 
-        // Distance matrix (upper triangle only)
-        MatrixXd distance_matrix(M, M);
-        for (unsigned i = 0; i < M; ++i)
+        for (const int index : iter->second)
         {
-            for (unsigned j = i + 1; j < M; ++j)
+            if ((m_X.col(index) - x).squaredNorm() < eps_squared)
             {
-                distance_matrix(i, j) = (X.col(i) - X.col(j)).squaredNorm();
+                return index;
             }
         }
+    }
+
+    return -1;
+}
 
-        for (unsigned i = 0; i < M; ++i)
+void sequential_line_search::PreferenceDataManager::AddToGrid(const int index)
+{
+    m_grid[CalcCellKey(CalcCell(m_X.col(index), m_grid_cell_size))].push_back(index);
+}
+
+void sequential_line_search::PreferenceDataManager::RemoveFromGrid(const int index)
+{
+    std::vector<int>& bucket = m_grid[CalcCellKey(CalcCell(m_X.col(index), m_grid_cell_size))];
+    bucket.erase(std::remove(bucket.begin(), bucket.end(), index), bucket.end());
+}
+
+void sequential_line_search::PreferenceDataManager::RebuildGrid(const int num_indexed_points)
+{
+    m_grid.clear();
+    for (int index = 0; index < num_indexed_points; ++index)
+    {
+        AddToGrid(index);
+    }
+    m_num_indexed_points = num_indexed_points;
+}
+
+void sequential_line_search::PreferenceDataManager::ApplyRetentionPolicy()
+{
+    if (m_retention_policy == RetentionPolicy::KeepAll || m_num_data_points <= m_max_num_data_points)
+    {
+        return;
+    }
+
+    // The points in the last observation (including the last selected point) are kept
+    const auto is_protected = [&](const int index)
+    {
+        const Preference& last = GetLastDataSample();
+        return std::find(last.begin(), last.end(), static_cast<unsigned>(index)) != last.end();
+    };
+
+    // Drop the oldest observation; returns false if it is the only one
+    const auto drop_oldest_observation = [&]()
+    {
+        if (m_D.size() <= 1)
         {
-            for (unsigned j = i + 1; j < M; ++j)
+            return false;
+        }
+        m_D.erase(m_D.begin());
+        RemoveUnreferencedDataPoints();
+        return true;
+    };
+
+    while (m_num_data_points > m_max_num_data_points)
+    {
+        switch (m_retention_policy)
+        {
+            case RetentionPolicy::KeepAll:
+            {
+                return;
+            }
+            case RetentionPolicy::SlidingWindow:
+            {
+                if (!drop_oldest_observation())
+                {
+                    return;
+                }
+                break;
+            }
+            case RetentionPolicy::DropDominatedFar:
             {
-                if (!is_dirty && distance_matrix(i, j) < eps_squared)
+                std::vector<bool> is_preferred(m_num_data_points, false);
+                for (const Preference& p : m_D)
                 {
-                    // Construct a mapping from the old indices to the new one
-                    std::map<unsigned, unsigned> mapping;
-                    unsigned                     new_index = 0;
-                    for (unsigned old_index = 0; old_index < M; ++old_index)
+                    is_preferred[p[0]] = true;
+                }
+
+                const VectorXd x_center =
+                    (m_retention_center.size() == m_X.rows()) ? m_retention_center : GetLastSelectedDataPoint();
+
+                int    target_index    = -1;
+                double target_distance = -1.0;
+                for (int index = 0; index < m_num_data_points; ++index)
+                {
+                    if (is_preferred[index] || is_protected(index))
                     {
-                        if (old_index != i && old_index != j)
-                        {
-                            mapping[old_index] = new_index++;
-                        }
+                        continue;
                     }
-                    mapping[i] = M - 2;
-                    mapping[j] = M - 2;
 
-                    // Construct a new matrix
-                    MatrixXd new_X(N, M - 1);
-                    for (unsigned old_index = 0; old_index < M; ++old_index)
+                    const double distance = (m_X.col(index) - x_center).squaredNorm();
+                    if (distance > target_distance)
                     {
-                        new_X.col(mapping[old_index]) = X.col(old_index);
+                        target_index    = index;
+                        target_distance = distance;
                     }
-                    new_X.col(M - 2) = 0.5 * (X.col(i) + X.col(j));
+                }
 
-                    // Replace the data
-                    X = new_X;
+                if (target_index < 0)
+                {
+                    if (!drop_oldest_observation())
+                    {
+                        return;
+                    }
+                    break;
+                }
 
-                    // Update the indices in the preference pairs
-                    for (sequential_line_search::Preference& p : D)
+                std::vector<bool> is_removed(m_num_data_points, false);
+                is_removed[target_index] = true;
+                RemoveDataPoints(is_removed);
+                RemoveUnreferencedDataPoints();
+                break;
+            }
+            case RetentionPolicy::Thinning:
+            {
+                // Find the unprotected point whose nearest neighbor is the closest
+                int    target_index    = -1;
+                int    neighbor_index  = -1;
+                double target_distance = std::numeric_limits<double>::infinity();
+                for (int i = 0; i < m_num_data_points; ++i)
+                {
+                    if (is_protected(i))
                     {
-                        for (unsigned i = 0; i < p.size(); ++i)
+                        continue;
+                    }
+
+                    for (int j = 0; j < m_num_data_points; ++j)
+                    {
+                        const double distance = (m_X.col(i) - m_X.col(j)).squaredNorm();
+                        if (j != i && distance < target_distance)
                         {
-                            p[i] = mapping[p[i]];
+                            target_index    = i;
+                            neighbor_index  = j;
+                            target_distance = distance;
                         }
                     }
+                }
 
-                    is_dirty = true;
+                if (target_index < 0)
+                {
+                    return;
                 }
+
+                ReplaceReferences(target_index, neighbor_index);
+                RemoveUnreferencedDataPoints();
+                break;
             }
         }
+    }
+}
+
+void sequential_line_search::PreferenceDataManager::RemoveDataPoints(const std::vector<bool>& is_removed)
+{
+    const int M = m_num_data_points;
+
+    // Construct a mapping from the old indices to the new one, where -1 means removal
+    std::vector<int> mapping(M);
+    int              new_index = 0;
+    for (int old_index = 0; old_index < M; ++old_index)
+    {
+        mapping[old_index] = is_removed[old_index] ? -1 : new_index++;
+    }
 
-        if (!is_dirty)
+    // Compact the points in place
+    for (int old_index = 0; old_index < M; ++old_index)
+    {
+        if (mapping[old_index] >= 0 && mapping[old_index] != old_index)
         {
-            return;
+            m_X.col(mapping[old_index]) = m_X.col(old_index);
         }
     }
-}
+    m_num_data_points = new_index;
 
-void sequential_line_search::PreferenceDataManager::AddNewPoints(const Eigen::VectorXd&              x_preferable,
-                                                                 const std::vector<Eigen::VectorXd>& xs_other,
-                                                                 const bool                          merge_close_points,
-                                                                 const double                        epsilon)
-{
-    if (m_X.rows() == 0)
+    // Update the indices in the preference pairs
+    std::vector<Preference> new_D;
+    for (const Preference& p : m_D)
     {
-        // X
-        const unsigned d = xs_other[0].rows();
-        m_X              = MatrixXd(d, xs_other.size() + 1);
-        m_X.col(0)       = x_preferable;
-        for (unsigned i = 0; i < xs_other.size(); ++i)
+        if (mapping[p[0]] < 0)
         {
-            m_X.col(i + 1) = xs_other[i];
+            continue;
         }
 
-        // D
-        std::vector<unsigned> indices(xs_other.size() + 1);
-        for (unsigned i = 0; i < xs_other.size() + 1; ++i)
+        std::vector<unsigned> indices;
+        for (const unsigned index : p)
         {
-            indices[i] = i;
+            if (mapping[index] >= 0)
+            {
+                indices.push_back(mapping[index]);
+            }
         }
-        m_D.push_back(Preference(indices));
 
-        return;
+        if (indices.size() >= 2)
+        {
+            new_D.push_back(Preference(indices));
+        }
     }
+    m_D.swap(new_D);
 
-    const unsigned d = m_X.rows();
-    const unsigned N = m_X.cols();
+    // The remaining indexed points are still free of close pairs and stay at the beginning
+    RebuildGrid(std::count(is_removed.begin(), is_removed.begin() + m_num_indexed_points, false));
+}
 
-    // X
-    MatrixXd new_X(d, N + xs_other.size() + 1);
-    new_X.block(0, 0, d, N) = m_X;
-    new_X.col(N)            = x_preferable;
-    for (unsigned i = 0; i < xs_other.size(); ++i)
+void sequential_line_search::PreferenceDataManager::RemoveUnreferencedDataPoints()
+{
+    std::vector<bool> is_removed(m_num_data_points, true);
+    for (const Preference& p : m_D)
     {
-        new_X.col(N + i + 1) = xs_other[i];
+        for (const unsigned index : p)
+        {
+            is_removed[index] = false;
+        }
     }
-    m_X = new_X;
 
-    // D
-    std::vector<unsigned> indices(xs_other.size() + 1);
-    for (unsigned i = 0; i < xs_other.size() + 1; ++i)
+    if (std::find(is_removed.begin(), is_removed.end(), true) != is_removed.end())
     {
-        indices[i] = N + i;
+        RemoveDataPoints(is_removed);
     }
-    m_D.push_back(Preference(indices));
+}
 
-    // Merge
-    if (merge_close_points)
+void sequential_line_search::PreferenceDataManager::ReplaceReferences(const unsigned index, const unsigned new_index)
+{
+    std::vector<Preference> new_D;
+    for (const Preference& p : m_D)
     {
-        internal::MergeClosePoints(epsilon, m_X, m_D);
+        std::vector<unsigned> indices;
+        for (const unsigned old_index : p)
+        {
+            const unsigned replaced_index = (old_index == index) ? new_index : old_index;
+
+            // The preferred point is always the first, so duplicates among the others are simply skipped
+            if (std::find(indices.begin(), indices.end(), replaced_index) == indices.end())
+            {
+                indices.push_back(replaced_index);
+            }
+        }
+
+        if (indices.size() >= 2)
+        {
+            new_D.push_back(Preference(indices));
+        }
     }
+    m_D.swap(new_D);
 }
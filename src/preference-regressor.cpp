@@ -5,8 +5,10 @@
 #include <mathtoolbox/log-determinant.hpp>
 #include <mathtoolbox/probability-distributions.hpp>
 #include <nlopt-util.hpp>
+#include <sequential-line-search/binary-io.hpp>
 #include <sequential-line-search/preference-regressor.hpp>
 #include <sequential-line-search/utils.hpp>
+#include <stdexcept>
 
 using Eigen::LLT;
 using Eigen::MatrixXd;
@@ -74,6 +76,10 @@ namespace
     }
 #endif
 
+    /// \brief The number of data points from which the derivatives with respect to the hyperparameters are computed
+    /// in parallel. Each derivative requires an O(N^3) solve, which does not pay off the dispatch for small N.
+    constexpr unsigned min_num_data_points_for_parallel_derivatives = 64;
+
     inline VectorXd CalcObjectiveThetaDerivative(const VectorXd&             y,
                                                  const LLT<MatrixXd>&        K_llt,
                                                  const VectorXd&             K_inv_y,
@@ -83,13 +89,15 @@ namespace
                                                  const double                a_prior_variance,
                                                  const double                r_prior_mean,
                                                  const double                r_prior_variance,
-                                                 const KernelThetaDerivative kernel_theta_derivative)
+                                                 const KernelThetaDerivative kernel_theta_derivative,
+                                                 Executor*                   executor)
     {
         VectorXd grad = VectorXd::Zero(kernel_hyperparams.size());
 
         const std::vector<MatrixXd> K_y_grad_r =
             CalcLargeKYThetaDerivative(X, kernel_hyperparams, kernel_theta_derivative);
-        for (unsigned i = 0; i < kernel_hyperparams.size(); ++i)
+
+        const auto calc_grad_theta_i = [&](const int i)
         {
             const MatrixXd& K_y_grad_theta_i = K_y_grad_r[i];
 
@@ -99,7 +107,11 @@ namespace
             const double log_p_f_theta_grad_theta_i = term_1 + term_2;
 
             grad(i) += log_p_f_theta_grad_theta_i;
-        }
+        };
+
+        ParallelFor(X.cols() >= min_num_data_points_for_parallel_derivatives ? executor : nullptr,
+                    kernel_hyperparams.size(),
+                    calc_grad_theta_i);
         for (unsigned i = 0; i < kernel_hyperparams.size(); ++i)
         {
             const double prior_mean     = (i == 0) ? a_prior_mean : r_prior_mean;
@@ -125,10 +137,25 @@ namespace
         return std::log(utils::CalcBtl(tmp, btl_scale));
     }
 
+    /// \brief A wrapper struct for an nlopt-style objective function
+    struct RegressorWrapper
+    {
+        const PreferenceRegressor* regressor;
+        const CancellationToken*   cancellation_token;
+    };
+
     // Log likelihood that will be maximized
     double objective(const std::vector<double>& x, std::vector<double>& grad, void* data)
     {
-        const PreferenceRegressor* regressor = static_cast<PreferenceRegressor*>(data);
+        const auto casted_data = static_cast<RegressorWrapper*>(data);
+
+        // Throwing this makes nlopt force-stop the estimation, which then returns the best solution found so far
+        if (IsCancelled(casted_data->cancellation_token))
+        {
+            throw nlopt::forced_stop();
+        }
+
+        const PreferenceRegressor* regressor = casted_data->regressor;
 
         const MatrixXd&                X = regressor->m_X;
         const std::vector<Preference>& D = regressor->m_D;
@@ -231,7 +258,8 @@ namespace
                                                                          regressor->m_kernel_hyperparams_prior_var,
                                                                          regressor->m_default_kernel_length_scale,
                                                                          regressor->m_kernel_hyperparams_prior_var,
-                                                                         regressor->GetKernelThetaDerivative());
+                                                                         regressor->GetKernelThetaDerivative(),
+                                                                         regressor->m_executor.get());
 
                 grad[M + 0] = grad_theta(0);
 #ifdef SEQUENTIAL_LINE_SEARCH_USE_NOISELESS_FORMULATION
@@ -268,7 +296,9 @@ sequential_line_search::PreferenceRegressor::PreferenceRegressor(const MatrixXd&
                                                                  const double     kernel_hyperparams_prior_var,
                                                                  const double     btl_scale,
                                                                  const unsigned   num_map_estimation_iters,
-                                                                 const KernelType kernel_type)
+                                                                 const KernelType kernel_type,
+                                                                 const std::shared_ptr<Executor>& executor,
+                                                                 const CancellationToken*         cancellation_token)
     : Regressor(kernel_type),
       m_use_map_hyperparams(use_map_hyperparams),
       m_X(X),
@@ -277,19 +307,54 @@ sequential_line_search::PreferenceRegressor::PreferenceRegressor(const MatrixXd&
       m_default_kernel_length_scale(default_kernel_length_scale),
       m_default_noise_level(default_noise_level),
       m_kernel_hyperparams_prior_var(kernel_hyperparams_prior_var),
-      m_btl_scale(btl_scale)
+      m_btl_scale(btl_scale),
+      m_executor(executor != nullptr ? executor : GetDefaultExecutor())
 {
     if (X.cols() == 0 || D.size() == 0)
     {
         return;
     }
 
-    PerformMapEstimation(num_map_estimation_iters);
+    PerformMapEstimation(num_map_estimation_iters, cancellation_token);
 
     m_K     = CalcLargeKY(X, m_kernel_hyperparams, m_noise_hyperparam, m_kernel);
     m_K_llt = LLT<MatrixXd>(m_K);
 }
 
+sequential_line_search::PreferenceRegressor::PreferenceRegressor(const MatrixXd&                X,
+                                                                 const std::vector<Preference>& D,
+                                                                 const VectorXd&                y,
+                                                                 const VectorXd&                kernel_hyperparams,
+                                                                 const double                   noise_hyperparam,
+                                                                 const MatrixXd&                K,
+                                                                 const bool                     use_map_hyperparams,
+                                                                 const double     default_kernel_signal_var,
+                                                                 const double     default_kernel_length_scale,
+                                                                 const double     default_noise_level,
+                                                                 const double     kernel_hyperparams_prior_var,
+                                                                 const double     btl_scale,
+                                                                 const KernelType kernel_type)
+    : Regressor(kernel_type),
+      m_use_map_hyperparams(use_map_hyperparams),
+      m_X(X),
+      m_D(D),
+      m_noise_hyperparam(noise_hyperparam),
+      m_kernel_hyperparams(kernel_hyperparams),
+      m_K(K),
+      m_default_kernel_signal_var(default_kernel_signal_var),
+      m_default_kernel_length_scale(default_kernel_length_scale),
+      m_default_noise_level(default_noise_level),
+      m_kernel_hyperparams_prior_var(kernel_hyperparams_prior_var),
+      m_btl_scale(btl_scale),
+      m_executor(GetDefaultExecutor()),
+      m_y(y)
+{
+    if (m_K.size() != 0)
+    {
+        m_K_llt = LLT<MatrixXd>(m_K);
+    }
+}
+
 double sequential_line_search::PreferenceRegressor::PredictMu(const VectorXd& x) const
 {
     const VectorXd k = CalcSmallK(x, m_X, m_kernel_hyperparams, m_kernel);
@@ -329,7 +394,8 @@ VectorXd sequential_line_search::PreferenceRegressor::PredictSigmaDerivative(con
     return -(1.0 / sigma) * k_x_derivative * m_K_llt.solve(k);
 }
 
-void sequential_line_search::PreferenceRegressor::PerformMapEstimation(const unsigned num_iters)
+void sequential_line_search::PreferenceRegressor::PerformMapEstimation(const unsigned           num_iters,
+                                                                        const CancellationToken* cancellation_token)
 {
     const unsigned M = m_X.cols();
     const unsigned d = m_X.rows();
@@ -374,7 +440,9 @@ void sequential_line_search::PreferenceRegressor::PerformMapEstimation(const uns
     timer::Timer t("PreferenceRegressor::PerformMapEstimation");
 #endif
 
-    const VectorXd x_opt = nloptutil::solve(x_ini, upper, lower, objective, nlopt::LD_TNEWTON, this, true, num_iters);
+    RegressorWrapper data{this, cancellation_token};
+
+    const VectorXd x_opt = nloptutil::solve(x_ini, upper, lower, objective, nlopt::LD_TNEWTON, &data, true, num_iters);
 
     if (m_use_map_hyperparams)
     {
@@ -430,3 +498,74 @@ void sequential_line_search::PreferenceRegressor::DampData(const std::string& di
         ofs_D << std::endl;
     }
 }
+
+void sequential_line_search::PreferenceRegressor::Save(std::ostream& stream) const
+{
+    binary_io::WriteUInt32(stream, static_cast<std::uint32_t>(m_kernel_type));
+    binary_io::WriteBool(stream, m_use_map_hyperparams);
+    binary_io::WriteDouble(stream, m_default_kernel_signal_var);
+    binary_io::WriteDouble(stream, m_default_kernel_length_scale);
+    binary_io::WriteDouble(stream, m_default_noise_level);
+    binary_io::WriteDouble(stream, m_kernel_hyperparams_prior_var);
+    binary_io::WriteDouble(stream, m_btl_scale);
+
+    binary_io::WriteMatrix(stream, m_X);
+    binary_io::WritePreferences(stream, m_D);
+
+    binary_io::WriteVector(stream, m_y);
+    binary_io::WriteVector(stream, m_kernel_hyperparams);
+    binary_io::WriteDouble(stream, m_noise_hyperparam);
+    binary_io::WriteMatrix(stream, m_K);
+}
+
+std::shared_ptr<sequential_line_search::PreferenceRegressor>
+sequential_line_search::PreferenceRegressor::Load(std::istream& stream)
+{
+    const auto   kernel_type                  = static_cast<KernelType>(
+        binary_io::ReadEnum(stream, static_cast<std::uint32_t>(KernelType::ArdMatern52Kernel) + 1));
+    const bool   use_map_hyperparams          = binary_io::ReadBool(stream);
+    const double default_kernel_signal_var    = binary_io::ReadDouble(stream);
+    const double default_kernel_length_scale  = binary_io::ReadDouble(stream);
+    const double default_noise_level          = binary_io::ReadDouble(stream);
+    const double kernel_hyperparams_prior_var = binary_io::ReadDouble(stream);
+    const double btl_scale                    = binary_io::ReadDouble(stream);
+
+    const MatrixXd                X = binary_io::ReadMatrix(stream);
+    const std::vector<Preference> D = binary_io::ReadPreferences(stream);
+
+    const VectorXd y                  = binary_io::ReadVector(stream);
+    const VectorXd kernel_hyperparams = binary_io::ReadVector(stream);
+    const double   noise_hyperparam   = binary_io::ReadDouble(stream);
+    const MatrixXd K                  = binary_io::ReadMatrix(stream);
+
+    if (y.size() != X.cols() || K.rows() != X.cols() || K.cols() != X.cols() ||
+        kernel_hyperparams.size() != X.rows() + 1)
+    {
+        throw std::runtime_error("Inconsistent regressor in a binary snapshot.");
+    }
+    for (const Preference& preference : D)
+    {
+        for (const unsigned index : preference)
+        {
+            if (index >= static_cast<unsigned>(X.cols()))
+            {
+                throw std::runtime_error("Invalid preference in a binary snapshot.");
+            }
+        }
+    }
+
+    // Note: std::make_shared cannot access the private constructor
+    return std::shared_ptr<PreferenceRegressor>(new PreferenceRegressor(X,
+                                                                        D,
+                                                                        y,
+                                                                        kernel_hyperparams,
+                                                                        noise_hyperparam,
+                                                                        K,
+                                                                        use_map_hyperparams,
+                                                                        default_kernel_signal_var,
+                                                                        default_kernel_length_scale,
+                                                                        default_noise_level,
+                                                                        kernel_hyperparams_prior_var,
+                                                                        btl_scale,
+                                                                        kernel_type));
+}
@@ -1,13 +1,23 @@
+#include <fstream>
 #include <sequential-line-search/acquisition-function.hpp>
+#include <sequential-line-search/binary-io.hpp>
+#include <sequential-line-search/feedback-journal.hpp>
 #include <sequential-line-search/preference-data-manager.hpp>
 #include <sequential-line-search/preference-regressor.hpp>
 #include <sequential-line-search/preferential-bayesian-optimizer.hpp>
 #include <sequential-line-search/utils.hpp>
 #include <stdexcept>
+#include <string>
 
 using Eigen::MatrixXd;
 using Eigen::VectorXd;
 
+namespace
+{
+    const std::string   snapshot_magic   = "PBOO";
+    const std::uint32_t snapshot_version = 1;
+} // namespace
+
 std::vector<VectorXd> sequential_line_search::GenerateRandomPoints(const int num_dims, const int num_options)
 {
     std::vector<VectorXd> options;
@@ -37,13 +47,19 @@ sequential_line_search::PreferentialBayesianOptimizer::PreferentialBayesianOptim
       m_btl_scale(0.010),
       m_kernel_type(kernel_type),
       m_acquisition_func_type(acquisition_func_type),
-      m_gaussian_process_upper_confidence_bound_hyperparam(1.0)
+      m_gaussian_process_upper_confidence_bound_hyperparam(1.0),
+      m_executor(GetDefaultExecutor())
 {
-    m_data            = std::make_shared<PreferenceDataManager>();
-    m_regressor       = nullptr;
-    m_current_options = initial_query_generator(num_dims, num_options);
+    PublishSnapshot(
+        Snapshot{std::make_shared<PreferenceDataManager>(), nullptr, initial_query_generator(num_dims, num_options)});
+
+    assert(LoadSnapshot()->current_options.size() == m_num_options);
+}
 
-    assert(m_current_options.size() == m_num_options);
+sequential_line_search::PreferentialBayesianOptimizer::~PreferentialBayesianOptimizer()
+{
+    // The worker refers to this instance, so it must finish before the members are destroyed
+    WaitForPendingUpdate();
 }
 
 void sequential_line_search::PreferentialBayesianOptimizer::SetHyperparams(const double kernel_signal_var,
@@ -52,6 +68,8 @@ void sequential_line_search::PreferentialBayesianOptimizer::SetHyperparams(const
                                                                            const double kernel_hyperparams_prior_var,
                                                                            const double btl_scale)
 {
+    WaitForPendingUpdate();
+
     m_kernel_signal_var            = kernel_signal_var;
     m_kernel_length_scale          = kernel_length_scale;
     m_noise_level                  = noise_level;
@@ -62,18 +80,27 @@ void sequential_line_search::PreferentialBayesianOptimizer::SetHyperparams(const
 void sequential_line_search::PreferentialBayesianOptimizer::SubmitFeedbackData(const int option_index,
                                                                                const int num_map_estimation_iters)
 {
-    assert(option_index >= 0 && option_index < m_current_options.size());
+    assert(option_index >= 0 && option_index < m_num_options);
 
-    const auto& x_chosen = m_current_options[option_index];
+    WaitForPendingUpdate();
 
-    std::vector<VectorXd> x_others = m_current_options;
+    const auto  snapshot = LoadSnapshot();
+    const auto& x_chosen = snapshot->current_options[option_index];
+
+    std::vector<VectorXd> x_others = snapshot->current_options;
     x_others.erase(x_others.begin() + option_index);
 
-    // Update the data
-    m_data->AddNewPoints(x_chosen, x_others, true);
+    if (m_journal != nullptr)
+    {
+        m_journal->Append(x_chosen, x_others);
+    }
+
+    // Update a copy of the data so that the getters called from other threads can keep reading the published one
+    const auto data = CopyData();
+    data->AddNewPoints(x_chosen, x_others, true);
 
     // Perform MAP estimation of the goodness values
-    PerformMapEstimation(num_map_estimation_iters);
+    PerformMapEstimation(data, num_map_estimation_iters);
 }
 
 void sequential_line_search::PreferentialBayesianOptimizer::SubmitCustomFeedbackData(
@@ -81,100 +108,459 @@ void sequential_line_search::PreferentialBayesianOptimizer::SubmitCustomFeedback
     const std::vector<VectorXd>& other_options,
     const int                    num_map_estimation_iters)
 {
-    // Update the data
-    m_data->AddNewPoints(chosen_option, other_options, true);
+    WaitForPendingUpdate();
+
+    if (m_journal != nullptr)
+    {
+        m_journal->Append(chosen_option, other_options);
+    }
+
+    // Update a copy of the data so that the getters called from other threads can keep reading the published one
+    const auto data = CopyData();
+    data->AddNewPoints(chosen_option, other_options, true);
 
     // Perform MAP estimation of the goodness values
-    PerformMapEstimation(num_map_estimation_iters);
+    PerformMapEstimation(data, num_map_estimation_iters);
 }
 
-void sequential_line_search::PreferentialBayesianOptimizer::DetermineNextQuery(int num_global_search_iters,
-                                                                               int num_local_search_iters)
+void sequential_line_search::PreferentialBayesianOptimizer::DetermineNextQuery(const int num_global_search_iters,
+                                                                               const int num_local_search_iters)
 {
-    // Note: A heuristics to set the computational effort for solving the maximization of the acquisition function. This
-    // is not justified or validated at all.
-    const int num_dims = GetMaximizer().size();
-#ifdef SEQUENTIAL_LINE_SEARCH_USE_PARALLELIZED_MULTI_START_SEARCH
-    num_global_search_iters = num_global_search_iters > 0 ? num_global_search_iters : 500 * num_dims;
-#else
-    num_global_search_iters = num_global_search_iters > 0 ? num_global_search_iters : 50 * num_dims * num_dims;
-#endif
-    num_local_search_iters = num_local_search_iters > 0 ? num_local_search_iters : 10 * num_dims;
+    WaitForPendingUpdate();
 
-    // Find the next search space
-    const auto x_plus = [&]() -> VectorXd
+    const auto snapshot = LoadSnapshot();
+
+    const auto options =
+        CalcNextOptions(*snapshot->regressor, *snapshot->data, num_global_search_iters, num_local_search_iters);
+
+    PublishSnapshot(Snapshot{snapshot->data, snapshot->regressor, options});
+}
+
+std::shared_future<void> sequential_line_search::PreferentialBayesianOptimizer::SubmitFeedbackDataAsync(
+    const int                    option_index,
+    const int                    num_map_estimation_iters,
+    const int                    num_global_search_iters,
+    const int                    num_local_search_iters,
+    const std::function<void()>& on_completed)
+{
+    assert(option_index >= 0 && option_index < m_num_options);
+
+    WaitForPendingUpdate();
+
+    const auto     snapshot = LoadSnapshot();
+    const VectorXd x_chosen = snapshot->current_options[option_index];
+
+    std::vector<VectorXd> x_others = snapshot->current_options;
+    x_others.erase(x_others.begin() + option_index);
+
+    if (m_journal != nullptr)
     {
-        switch (m_current_best_selection_strategy)
+        m_journal->Append(x_chosen, x_others);
+    }
+
+    // The worker updates a copy of the data so that the getters can keep reading the published one
+    const auto data = CopyData();
+
+    const auto task = [this,
+                       data,
+                       x_chosen,
+                       x_others,
+                       num_map_estimation_iters,
+                       num_global_search_iters,
+                       num_local_search_iters,
+                       on_completed]()
+    {
+        // The callback is called even if the update fails, in which case nothing is published and the exception is
+        // rethrown by the future
+        try
         {
-            case CurrentBestSelectionStrategy::LargestExpectValue:
-                return m_regressor->FindArgMax();
-            case CurrentBestSelectionStrategy::LastSelection:
-                // Retrieve the latest preferential feedback data and its selected option
-                const auto x_chosen = m_data->GetLastSelectedDataPoint();
+            data->AddNewPoints(x_chosen, x_others, true);
 
-                return x_chosen;
+            const auto regressor = FitRegressor(*data, num_map_estimation_iters);
+            const auto options   = CalcNextOptions(*regressor, *data, num_global_search_iters, num_local_search_iters);
+
+            PublishSnapshot(Snapshot{data, regressor, options});
+        }
+        catch (...)
+        {
+            if (on_completed)
+            {
+                on_completed();
+            }
+            throw;
         }
-    }();
 
-    const auto next_points = acquisition_func::FindNextPoints(*m_regressor,
-                                                              m_num_options - 1,
-                                                              num_global_search_iters,
-                                                              num_local_search_iters,
-                                                              m_acquisition_func_type,
-                                                              m_gaussian_process_upper_confidence_bound_hyperparam);
+        if (on_completed)
+        {
+            on_completed();
+        }
+    };
 
-    // This code assumes that `m_current_options` has been appropriately allocated.
-    assert(m_current_options.size() == m_num_options);
+    m_pending_update = ExecuteAsync(*m_executor, task);
 
-    m_current_options[0] = x_plus;
-    for (int i = 1; i < m_num_options; ++i)
+    return m_pending_update;
+}
+
+void sequential_line_search::PreferentialBayesianOptimizer::EnableFeedbackJournal(const std::string&      file_path,
+                                                                                  const JournalSyncPolicy sync_policy,
+                                                                                  const int               sync_interval)
+{
+    WaitForPendingUpdate();
+
+    // Close the previous journal first in case the same file is specified
+    m_journal = nullptr;
+    m_journal = std::make_shared<FeedbackJournal>(file_path, sync_policy, sync_interval);
+}
+
+void sequential_line_search::PreferentialBayesianOptimizer::DisableFeedbackJournal()
+{
+    WaitForPendingUpdate();
+
+    m_journal = nullptr;
+}
+
+int sequential_line_search::PreferentialBayesianOptimizer::ReplayFeedbackJournal(const std::string& file_path,
+                                                                                 const int num_map_estimation_iters)
+{
+    const auto records = FeedbackJournal::Read(file_path);
+
+    if (records.empty())
+    {
+        return 0;
+    }
+
+    WaitForPendingUpdate();
+
+    const auto data = CopyData();
+    AddFeedbackRecords(records, data.get());
+
+    // Perform the MAP estimation only once for all the records
+    PerformMapEstimation(data, num_map_estimation_iters);
+
+    return records.size();
+}
+
+void sequential_line_search::PreferentialBayesianOptimizer::ImportData(const MatrixXd&                X,
+                                                                       const std::vector<Preference>& D,
+                                                                       const int num_map_estimation_iters)
+{
+    WaitForPendingUpdate();
+
+    const auto data = CopyData();
+    data->AddData(X, D);
+
+    if (data->GetNumDataPoints() != 0 && data->GetX().rows() != LoadSnapshot()->current_options[0].size())
+    {
+        throw std::runtime_error("Inconsistent number of dimensions of the imported data.");
+    }
+
+    if (data->GetD().empty())
+    {
+        const auto snapshot = LoadSnapshot();
+        PublishSnapshot(Snapshot{data, snapshot->regressor, snapshot->current_options});
+        return;
+    }
+
+    PerformMapEstimation(data, num_map_estimation_iters);
+}
+
+void sequential_line_search::PreferentialBayesianOptimizer::ImportData(const std::string& directory_path,
+                                                                       const int          num_map_estimation_iters)
+{
+    WaitForPendingUpdate();
+
+    const auto data = CopyData();
+    data->ImportCsv(directory_path);
+
+    if (data->GetNumDataPoints() != 0 && data->GetX().rows() != LoadSnapshot()->current_options[0].size())
+    {
+        throw std::runtime_error("Inconsistent number of dimensions of the imported data.");
+    }
+
+    if (data->GetD().empty())
     {
-        m_current_options[i] = next_points[i - 1];
+        const auto snapshot = LoadSnapshot();
+        PublishSnapshot(Snapshot{data, snapshot->regressor, snapshot->current_options});
+        return;
     }
+
+    PerformMapEstimation(data, num_map_estimation_iters);
+}
+
+void sequential_line_search::PreferentialBayesianOptimizer::WaitForPendingUpdate() const
+{
+    if (m_pending_update.valid())
+    {
+        m_pending_update.wait();
+    }
+}
+
+std::vector<VectorXd> sequential_line_search::PreferentialBayesianOptimizer::GetCurrentOptions() const
+{
+    return LoadSnapshot()->current_options;
 }
 
 VectorXd sequential_line_search::PreferentialBayesianOptimizer::GetMaximizer() const
 {
     // This code assumes that the first option always represents the current-best data point
-    return m_current_options[0];
+    return LoadSnapshot()->current_options[0];
 }
 
 double sequential_line_search::PreferentialBayesianOptimizer::GetPreferenceValueMean(const VectorXd& point) const
 {
-    return (m_regressor == nullptr) ? 0.0 : m_regressor->PredictMu(point);
+    const auto regressor = LoadSnapshot()->regressor;
+
+    return (regressor == nullptr) ? 0.0 : regressor->PredictMu(point);
 }
 
 double sequential_line_search::PreferentialBayesianOptimizer::GetPreferenceValueStdev(const VectorXd& point) const
 {
-    return (m_regressor == nullptr) ? 0.0 : m_regressor->PredictSigma(point);
+    const auto regressor = LoadSnapshot()->regressor;
+
+    return (regressor == nullptr) ? 0.0 : regressor->PredictSigma(point);
 }
 
 double sequential_line_search::PreferentialBayesianOptimizer::GetAcquisitionFuncValue(const VectorXd& point) const
 {
-    return (m_regressor == nullptr)
+    const auto regressor = LoadSnapshot()->regressor;
+
+    return (regressor == nullptr)
                ? 0.0
-               : acquisition_func::CalcAcquisitionValue(*m_regressor,
+               : acquisition_func::CalcAcquisitionValue(*regressor,
                                                         point,
                                                         m_acquisition_func_type,
                                                         m_gaussian_process_upper_confidence_bound_hyperparam);
 }
 
-const MatrixXd& sequential_line_search::PreferentialBayesianOptimizer::GetRawDataPoints() const
+void sequential_line_search::PreferentialBayesianOptimizer::PredictPreferenceValues(
+    const Eigen::Ref<const Eigen::MatrixXd>& points, VectorXd* mu, VectorXd* sigma) const
 {
-    return m_data->GetX();
+    const auto snapshot  = LoadSnapshot();
+    const auto regressor = snapshot->regressor;
+    const int  num_dims  = snapshot->current_options[0].size();
+
+    if (points.rows() != num_dims)
+    {
+        throw std::invalid_argument("The points have " + std::to_string(points.rows()) + " rows, but " +
+                                    std::to_string(num_dims) + " dimensions are expected.");
+    }
+
+    if (regressor == nullptr)
+    {
+        if (mu != nullptr)
+        {
+            *mu = VectorXd::Zero(points.cols());
+        }
+        if (sigma != nullptr)
+        {
+            *sigma = VectorXd::Zero(points.cols());
+        }
+        return;
+    }
+
+    regressor->PredictInBatch(points, mu, sigma);
+}
+
+MatrixXd sequential_line_search::PreferentialBayesianOptimizer::GetRawDataPoints() const
+{
+    return LoadSnapshot()->data->GetX();
+}
+
+void sequential_line_search::PreferentialBayesianOptimizer::SetDataRetentionPolicy(const RetentionPolicy policy,
+                                                                                   const int max_num_data_points)
+{
+    WaitForPendingUpdate();
+
+    // The policy may discard points, so it is applied to a copy that replaces the published data
+    const auto data = CopyData();
+    data->SetRetentionPolicy(policy, max_num_data_points);
+
+    const auto snapshot = LoadSnapshot();
+    PublishSnapshot(Snapshot{data, snapshot->regressor, snapshot->current_options});
+}
+
+void sequential_line_search::PreferentialBayesianOptimizer::SetExecutor(const std::shared_ptr<Executor>& executor)
+{
+    WaitForPendingUpdate();
+
+    m_executor = (executor != nullptr) ? executor : GetDefaultExecutor();
 }
 
 void sequential_line_search::PreferentialBayesianOptimizer::DampData(const std::string& directory_path) const
 {
-    if (m_regressor == nullptr)
+    const auto regressor = LoadSnapshot()->regressor;
+
+    if (regressor == nullptr)
     {
         return;
     }
 
-    m_regressor->DampData(directory_path);
+    regressor->DampData(directory_path);
+}
+
+void sequential_line_search::PreferentialBayesianOptimizer::Save(std::ostream& stream) const
+{
+    WaitForPendingUpdate();
+
+    const auto snapshot = LoadSnapshot();
+
+    binary_io::WriteHeader(stream, snapshot_magic, snapshot_version);
+
+    // Configuration
+    binary_io::WriteInt32(stream, snapshot->current_options[0].size());
+    binary_io::WriteInt32(stream, m_num_options);
+    binary_io::WriteBool(stream, m_use_map_hyperparams);
+    binary_io::WriteUInt32(stream, static_cast<std::uint32_t>(m_current_best_selection_strategy));
+    binary_io::WriteUInt32(stream, static_cast<std::uint32_t>(m_kernel_type));
+    binary_io::WriteUInt32(stream, static_cast<std::uint32_t>(m_acquisition_func_type));
+
+    // Hyperparameters
+    binary_io::WriteDouble(stream, m_kernel_signal_var);
+    binary_io::WriteDouble(stream, m_kernel_length_scale);
+    binary_io::WriteDouble(stream, m_noise_level);
+    binary_io::WriteDouble(stream, m_kernel_hyperparams_prior_var);
+    binary_io::WriteDouble(stream, m_btl_scale);
+    binary_io::WriteDouble(stream, m_gaussian_process_upper_confidence_bound_hyperparam);
+
+    // Data and surrogate model
+    snapshot->data->Save(stream);
+    binary_io::WriteBool(stream, snapshot->regressor != nullptr);
+    if (snapshot->regressor != nullptr)
+    {
+        snapshot->regressor->Save(stream);
+    }
+
+    // Options
+    for (const VectorXd& option : snapshot->current_options)
+    {
+        binary_io::WriteVector(stream, option);
+    }
+}
+
+void sequential_line_search::PreferentialBayesianOptimizer::Save(const std::string& file_path) const
+{
+    std::ofstream file(file_path, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Failed to open " + file_path + ".");
+    }
+
+    Save(file);
+
+    // A snapshot that is not completely written is useless, so failures in writing (e.g., a full disk) are reported
+    file.close();
+    if (file.fail())
+    {
+        throw std::runtime_error("Failed to write " + file_path + ".");
+    }
+}
+
+std::shared_ptr<sequential_line_search::PreferentialBayesianOptimizer>
+sequential_line_search::PreferentialBayesianOptimizer::Load(std::istream&                stream,
+                                                            const InitialQueryGenerator& initial_query_generator)
+{
+    binary_io::ReadHeader(stream, snapshot_magic, snapshot_version);
+
+    // Configuration
+    const int  num_dims            = binary_io::ReadInt32(stream);
+    const int  num_options         = binary_io::ReadInt32(stream);
+    const bool use_map_hyperparams = binary_io::ReadBool(stream);
+    const auto current_best_selection_strategy = static_cast<CurrentBestSelectionStrategy>(
+        binary_io::ReadEnum(stream, static_cast<std::uint32_t>(CurrentBestSelectionStrategy::LastSelection) + 1));
+    const auto kernel_type           = static_cast<KernelType>(
+        binary_io::ReadEnum(stream, static_cast<std::uint32_t>(KernelType::ArdMatern52Kernel) + 1));
+    const auto acquisition_func_type = static_cast<AcquisitionFuncType>(
+        binary_io::ReadEnum(stream, static_cast<std::uint32_t>(AcquisitionFuncType::ThompsonSampling) + 1));
+
+    if (num_dims <= 0 || num_options < 2)
+    {
+        throw std::runtime_error("Invalid configuration in a binary snapshot.");
+    }
+
+    const auto optimizer = std::make_shared<PreferentialBayesianOptimizer>(num_dims,
+                                                                           use_map_hyperparams,
+                                                                           kernel_type,
+                                                                           acquisition_func_type,
+                                                                           initial_query_generator,
+                                                                           current_best_selection_strategy,
+                                                                           num_options);
+
+    // Hyperparameters
+    optimizer->m_kernel_signal_var                                  = binary_io::ReadDouble(stream);
+    optimizer->m_kernel_length_scale                                = binary_io::ReadDouble(stream);
+    optimizer->m_noise_level                                        = binary_io::ReadDouble(stream);
+    optimizer->m_kernel_hyperparams_prior_var                       = binary_io::ReadDouble(stream);
+    optimizer->m_btl_scale                                          = binary_io::ReadDouble(stream);
+    optimizer->m_gaussian_process_upper_confidence_bound_hyperparam = binary_io::ReadDouble(stream);
+
+    // Data and surrogate model
+    const auto data      = PreferenceDataManager::Load(stream);
+    const auto regressor = binary_io::ReadBool(stream) ? PreferenceRegressor::Load(stream) : nullptr;
+
+    if (data->GetNumDataPoints() != 0 && data->GetX().rows() != num_dims)
+    {
+        throw std::runtime_error("Inconsistent data in a binary snapshot.");
+    }
+    if (regressor != nullptr && regressor->GetLargeX().rows() != num_dims)
+    {
+        throw std::runtime_error("Inconsistent regressor in a binary snapshot.");
+    }
+
+    // Options
+    std::vector<VectorXd> current_options(num_options);
+    for (int i = 0; i < num_options; ++i)
+    {
+        current_options[i] = binary_io::ReadVector(stream);
+        if (current_options[i].size() != num_dims)
+        {
+            throw std::runtime_error("Inconsistent option in a binary snapshot.");
+        }
+    }
+    optimizer->PublishSnapshot(Snapshot{data, regressor, current_options});
+
+    return optimizer;
 }
 
-void sequential_line_search::PreferentialBayesianOptimizer::PerformMapEstimation(int num_map_estimation_iters)
+std::shared_ptr<sequential_line_search::PreferentialBayesianOptimizer>
+sequential_line_search::PreferentialBayesianOptimizer::Load(const std::string&           file_path,
+                                                            const InitialQueryGenerator& initial_query_generator)
+{
+    std::ifstream file(file_path, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Failed to open " + file_path + ".");
+    }
+
+    return Load(file, initial_query_generator);
+}
+
+std::shared_ptr<const sequential_line_search::PreferentialBayesianOptimizer::Snapshot>
+sequential_line_search::PreferentialBayesianOptimizer::LoadSnapshot() const
+{
+    return std::atomic_load(&m_snapshot);
+}
+
+void sequential_line_search::PreferentialBayesianOptimizer::PublishSnapshot(const Snapshot& snapshot)
+{
+    // Readers holding the previous snapshot keep using it; it is destroyed when the last of them releases it
+    std::atomic_store(&m_snapshot, std::make_shared<const Snapshot>(snapshot));
+}
+
+std::shared_ptr<sequential_line_search::PreferenceDataManager>
+sequential_line_search::PreferentialBayesianOptimizer::CopyData() const
+{
+    const auto snapshot = LoadSnapshot();
+    const auto data     = std::make_shared<PreferenceDataManager>(*snapshot->data);
+
+    // The retention policy keeps the points around the current-best option
+    data->SetRetentionCenter(snapshot->current_options[0]);
+
+    return data;
+}
+
+std::shared_ptr<const sequential_line_search::PreferenceRegressor>
+sequential_line_search::PreferentialBayesianOptimizer::FitRegressor(const PreferenceDataManager& data,
+                                                                    int num_map_estimation_iters) const
 {
     if (num_map_estimation_iters <= 0)
     {
@@ -182,18 +568,77 @@ void sequential_line_search::PreferentialBayesianOptimizer::PerformMapEstimation
 
         // A heuristics to set the computational effort for solving the maximization of the acquisition function. This
         // is not justified or validated.
-        num_map_estimation_iters = 10 * (num_dims + m_data->GetNumDataPoints());
+        num_map_estimation_iters = 10 * (num_dims + data.GetNumDataPoints());
     }
 
     // Perform MAP estimation
-    m_regressor = std::make_shared<PreferenceRegressor>(m_data->GetX(),
-                                                        m_data->GetD(),
-                                                        m_use_map_hyperparams,
-                                                        m_kernel_signal_var,
-                                                        m_kernel_length_scale,
-                                                        m_noise_level,
-                                                        m_kernel_hyperparams_prior_var,
-                                                        m_btl_scale,
-                                                        num_map_estimation_iters,
-                                                        m_kernel_type);
+    return std::make_shared<PreferenceRegressor>(data.GetX(),
+                                                 data.GetD(),
+                                                 m_use_map_hyperparams,
+                                                 m_kernel_signal_var,
+                                                 m_kernel_length_scale,
+                                                 m_noise_level,
+                                                 m_kernel_hyperparams_prior_var,
+                                                 m_btl_scale,
+                                                 num_map_estimation_iters,
+                                                 m_kernel_type,
+                                                 m_executor);
+}
+
+std::vector<VectorXd>
+sequential_line_search::PreferentialBayesianOptimizer::CalcNextOptions(const PreferenceRegressor&   regressor,
+                                                                       const PreferenceDataManager& data,
+                                                                       int num_global_search_iters,
+                                                                       int num_local_search_iters) const
+{
+    // Note: A heuristics to set the computational effort for solving the maximization of the acquisition function. This
+    // is not justified or validated at all.
+    const int num_dims = GetMaximizer().size();
+#ifdef SEQUENTIAL_LINE_SEARCH_USE_PARALLELIZED_MULTI_START_SEARCH
+    num_global_search_iters = num_global_search_iters > 0 ? num_global_search_iters : 500 * num_dims;
+#else
+    num_global_search_iters = num_global_search_iters > 0 ? num_global_search_iters : 50 * num_dims * num_dims;
+#endif
+    num_local_search_iters = num_local_search_iters > 0 ? num_local_search_iters : 10 * num_dims;
+
+    // Find the next search space
+    const auto x_plus = [&]() -> VectorXd
+    {
+        switch (m_current_best_selection_strategy)
+        {
+            case CurrentBestSelectionStrategy::LargestExpectValue:
+                return regressor.FindArgMax();
+            case CurrentBestSelectionStrategy::LastSelection:
+                // Retrieve the latest preferential feedback data and its selected option
+                const auto x_chosen = data.GetLastSelectedDataPoint();
+
+                return x_chosen;
+        }
+    }();
+
+    const auto next_points = acquisition_func::FindNextPoints(regressor,
+                                                              m_num_options - 1,
+                                                              num_global_search_iters,
+                                                              num_local_search_iters,
+                                                              m_acquisition_func_type,
+                                                              m_gaussian_process_upper_confidence_bound_hyperparam,
+                                                              m_executor.get());
+
+    std::vector<VectorXd> options(m_num_options);
+
+    options[0] = x_plus;
+    for (int i = 1; i < m_num_options; ++i)
+    {
+        options[i] = next_points[i - 1];
+    }
+
+    return options;
+}
+
+void sequential_line_search::PreferentialBayesianOptimizer::PerformMapEstimation(
+    const std::shared_ptr<const PreferenceDataManager>& data, const int num_map_estimation_iters)
+{
+    const auto regressor = FitRegressor(*data, num_map_estimation_iters);
+
+    PublishSnapshot(Snapshot{data, regressor, LoadSnapshot()->current_options});
 }
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cmath>
 #include <mathtoolbox/kernel-functions.hpp>
 #include <sequential-line-search/regressor.hpp>
 #include <sequential-line-search/utils.hpp>
@@ -5,7 +7,7 @@
 using Eigen::MatrixXd;
 using Eigen::VectorXd;
 
-sequential_line_search::Regressor::Regressor(const KernelType kernel_type)
+sequential_line_search::Regressor::Regressor(const KernelType kernel_type) : m_kernel_type(kernel_type)
 {
     switch (kernel_type)
     {
@@ -42,6 +44,36 @@ VectorXd sequential_line_search::Regressor::PredictMaximumPointFromData() const
     return GetLargeX().col(best_index);
 }
 
+void sequential_line_search::Regressor::PredictFromLargeKStar(const MatrixXd& K_star,
+                                                              VectorXd*       mu,
+                                                              VectorXd*       sigma) const
+{
+    if (mu != nullptr)
+    {
+        *mu = K_star.transpose() * SolveLargeKY(GetSmallY());
+    }
+
+    if (sigma != nullptr)
+    {
+        // This code assumes that the kernel is either ARD squared exponential or ARD Matern and the first
+        // hyperparameter represents the intensity of the kernel.
+        const double intensity = GetKernelHyperparams()(0);
+
+        // Note: The variance values can be negative due to numerical errors.
+        const VectorXd quad_terms = K_star.cwiseProduct(SolveLargeKY(K_star)).colwise().sum().transpose();
+        const VectorXd sigma_2    = (intensity - quad_terms.array()).matrix();
+
+        *sigma = sigma_2.cwiseMax(0.0).cwiseSqrt();
+    }
+}
+
+void sequential_line_search::Regressor::PredictInBatch(const Eigen::Ref<const MatrixXd>& X_star,
+                                                       VectorXd*                         mu,
+                                                       VectorXd*                         sigma) const
+{
+    PredictFromLargeKStar(CalcLargeKStar(X_star, GetLargeX(), GetKernelHyperparams(), m_kernel), mu, sigma);
+}
+
 VectorXd sequential_line_search::CalcSmallK(const VectorXd& x,
                                             const MatrixXd& X,
                                             const VectorXd& kernel_hyperparameters,
@@ -58,6 +90,78 @@ VectorXd sequential_line_search::CalcSmallK(const VectorXd& x,
     return k;
 }
 
+MatrixXd sequential_line_search::CalcLargeKStar(const Eigen::Ref<const MatrixXd>& X_star,
+                                                const MatrixXd&                   X,
+                                                const VectorXd&                   kernel_hyperparameters,
+                                                const Kernel                      kernel)
+{
+    const unsigned N = X.cols();
+    const unsigned S = X_star.cols();
+
+    MatrixXd K_star(N, S);
+    for (unsigned s = 0; s < S; ++s)
+    {
+        for (unsigned i = 0; i < N; ++i)
+        {
+            K_star(i, s) = kernel(X_star.col(s), X.col(i), kernel_hyperparameters);
+        }
+    }
+
+    return K_star;
+}
+
+MatrixXd sequential_line_search::CalcLargeKStarOnLine(const VectorXd&  origin,
+                                                      const VectorXd&  direction,
+                                                      const VectorXd&  ts,
+                                                      const MatrixXd&  X,
+                                                      const VectorXd&  kernel_hyperparameters,
+                                                      const KernelType kernel_type)
+{
+    const unsigned N = X.cols();
+    const unsigned S = ts.size();
+    const unsigned D = X.rows();
+
+    // This code assumes that the first hyperparameter represents the intensity of the kernel and the others
+    // represent the length scales.
+    const double   sigma_squared_f        = kernel_hyperparameters(0);
+    const VectorXd inv_squared_len_scales = kernel_hyperparameters.segment(1, D).array().square().inverse();
+
+    // r^{2}(t) = a + 2 b t + c t^{2}
+    const double c = direction.cwiseProduct(direction).dot(inv_squared_len_scales);
+
+    MatrixXd K_star(N, S);
+    for (unsigned i = 0; i < N; ++i)
+    {
+        const VectorXd diff = origin - X.col(i);
+        const double   a    = diff.cwiseProduct(diff).dot(inv_squared_len_scales);
+        const double   b    = diff.cwiseProduct(direction).dot(inv_squared_len_scales);
+
+        for (unsigned s = 0; s < S; ++s)
+        {
+            const double t         = ts(s);
+            const double r_squared = std::max(0.0, a + 2.0 * b * t + c * t * t);
+
+            switch (kernel_type)
+            {
+                case KernelType::ArdSquaredExponentialKernel:
+                {
+                    K_star(i, s) = sigma_squared_f * std::exp(-0.5 * r_squared);
+                    break;
+                }
+                case KernelType::ArdMatern52Kernel:
+                {
+                    const double sqrt_5_r = std::sqrt(5.0 * r_squared);
+
+                    K_star(i, s) = sigma_squared_f * (1.0 + sqrt_5_r + (5.0 / 3.0) * r_squared) * std::exp(-sqrt_5_r);
+                    break;
+                }
+            }
+        }
+    }
+
+    return K_star;
+}
+
 MatrixXd sequential_line_search::CalcLargeKY(const MatrixXd& X,
                                              const VectorXd& kernel_hyperparameters,
                                              const double    noise_level,
@@ -1,13 +1,56 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <numeric>
 #include <sequential-line-search/acquisition-function.hpp>
+#include <sequential-line-search/binary-io.hpp>
+#include <sequential-line-search/feedback-journal.hpp>
 #include <sequential-line-search/preference-data-manager.hpp>
 #include <sequential-line-search/preference-regressor.hpp>
 #include <sequential-line-search/sequential-line-search.hpp>
 #include <sequential-line-search/slider.hpp>
+#include <sequential-line-search/trust-region.hpp>
 #include <sequential-line-search/utils.hpp>
 #include <stdexcept>
+#include <string>
+#include <tuple>
 
 using Eigen::VectorXd;
 
+namespace
+{
+    const std::string   snapshot_magic   = "SLSO";
+    const std::uint32_t snapshot_version = 1;
+
+    void WriteSlider(std::ostream& stream, const sequential_line_search::Slider& slider)
+    {
+        using namespace sequential_line_search;
+
+        binary_io::WriteVector(stream, slider.end_0);
+        binary_io::WriteVector(stream, slider.end_1);
+        binary_io::WriteVector(stream, slider.original_end_0);
+        binary_io::WriteVector(stream, slider.original_end_1);
+    }
+
+    std::shared_ptr<sequential_line_search::Slider> ReadSlider(std::istream& stream)
+    {
+        using namespace sequential_line_search;
+
+        const VectorXd end_0          = binary_io::ReadVector(stream);
+        const VectorXd end_1          = binary_io::ReadVector(stream);
+        const VectorXd original_end_0 = binary_io::ReadVector(stream);
+        const VectorXd original_end_1 = binary_io::ReadVector(stream);
+
+        // The enlarged end-points are restored as they are instead of being recomputed
+        const auto slider = std::make_shared<Slider>(original_end_0, original_end_1, false);
+
+        slider->end_0 = end_0;
+        slider->end_1 = end_1;
+
+        return slider;
+    }
+} // namespace
+
 std::pair<VectorXd, VectorXd> sequential_line_search::GenerateRandomSliderEnds(const int num_dims)
 {
     return {0.5 * (VectorXd::Random(num_dims) + VectorXd::Ones(num_dims)),
@@ -33,6 +76,7 @@ sequential_line_search::SequentialLineSearchOptimizer::SequentialLineSearchOptim
     : m_use_slider_enlargement(use_slider_enlargement),
       m_use_map_hyperparams(use_map_hyperparams),
       m_current_best_selection_strategy(current_best_selection_strategy),
+      m_initial_query_generator(initial_query_generator),
       m_kernel_signal_var(0.500),
       m_kernel_length_scale(0.500),
       m_noise_level(0.005),
@@ -40,13 +84,24 @@ sequential_line_search::SequentialLineSearchOptimizer::SequentialLineSearchOptim
       m_btl_scale(0.010),
       m_kernel_type(kernel_type),
       m_acquisition_func_type(acquisition_func_type),
-      m_gaussian_process_upper_confidence_bound_hyperparam(1.0)
+      m_gaussian_process_upper_confidence_bound_hyperparam(1.0),
+      m_has_pending_batch_feedback(false),
+      m_executor(GetDefaultExecutor()),
+      m_num_speculations(0),
+      m_speculation_tolerance(0.02)
 {
     const auto slider_ends = initial_query_generator(num_dims);
 
-    m_data      = std::make_shared<PreferenceDataManager>();
-    m_regressor = nullptr;
-    m_slider    = std::make_shared<Slider>(std::get<0>(slider_ends), std::get<1>(slider_ends), false);
+    PublishSnapshot(Snapshot{std::make_shared<PreferenceDataManager>(),
+                             nullptr,
+                             std::make_shared<Slider>(std::get<0>(slider_ends), std::get<1>(slider_ends), false)});
+}
+
+sequential_line_search::SequentialLineSearchOptimizer::~SequentialLineSearchOptimizer()
+{
+    // The workers refer to this instance, so they must finish before the members are destroyed
+    WaitForPendingUpdate();
+    StopSpeculations();
 }
 
 void sequential_line_search::SequentialLineSearchOptimizer::SetHyperparams(const double kernel_signal_var,
@@ -55,25 +110,25 @@ void sequential_line_search::SequentialLineSearchOptimizer::SetHyperparams(const
                                                                            const double kernel_hyperparams_prior_var,
                                                                            const double btl_scale)
 {
+    WaitForPendingUpdate();
+    StopSpeculations();
+
     m_kernel_signal_var            = kernel_signal_var;
     m_kernel_length_scale          = kernel_length_scale;
     m_noise_level                  = noise_level;
     m_kernel_hyperparams_prior_var = kernel_hyperparams_prior_var;
     m_btl_scale                    = btl_scale;
+
+    LaunchSpeculations();
 }
 
 void sequential_line_search::SequentialLineSearchOptimizer::SubmitFeedbackData(const double slider_position)
 {
-    // A heuristics to set the computational effort for solving the maximization of the acquisition function. This is
-    // not justified or validated.
-    const int num_dims                 = GetMaximizer().size();
-    const int num_map_estimation_iters = 100;
-#ifdef SEQUENTIAL_LINE_SEARCH_USE_PARALLELIZED_MULTI_START_SEARCH
-    const int num_global_search_iters = 10;
-#else
-    const int num_global_search_iters = 50 * num_dims;
-#endif
-    const int num_local_search_iters = 10 * num_dims;
+    int num_map_estimation_iters = 0;
+    int num_global_search_iters  = 0;
+    int num_local_search_iters   = 0;
+
+    SetDefaultComputationalEfforts(&num_map_estimation_iters, &num_global_search_iters, &num_local_search_iters);
 
     SubmitFeedbackData(slider_position, num_map_estimation_iters, num_global_search_iters, num_local_search_iters);
 }
@@ -83,92 +138,1165 @@ void sequential_line_search::SequentialLineSearchOptimizer::SubmitFeedbackData(c
                                                                                const int    num_global_search_iters,
                                                                                const int    num_local_search_iters)
 {
-    const auto  x_chosen   = CalcPointFromSliderPosition(slider_position);
-    const auto& x_prev_max = m_slider->original_end_0;
-    const auto& x_prev_ei  = m_slider->original_end_1;
+    WaitForPendingUpdate();
 
-    // Update the data
-    m_data->AddNewPoints(x_chosen, {x_prev_max, x_prev_ei}, true);
+    const auto slider      = LoadSnapshot()->slider;
+    const auto speculation = FindSpeculation(
+        slider_position, num_map_estimation_iters, num_global_search_iters, num_local_search_iters);
 
-    // Perform the MAP estimation
-    m_regressor = std::make_shared<PreferenceRegressor>(m_data->GetX(),
-                                                        m_data->GetD(),
-                                                        m_use_map_hyperparams,
-                                                        m_kernel_signal_var,
-                                                        m_kernel_length_scale,
-                                                        m_noise_level,
-                                                        m_kernel_hyperparams_prior_var,
-                                                        m_btl_scale,
-                                                        num_map_estimation_iters,
-                                                        m_kernel_type);
+    // Write the feedback to the journal before updating the surrogate model; note that the speculated position is
+    // what will be stored if a speculation is adopted
+    AppendToJournal(*slider, (speculation == nullptr) ? slider_position : speculation->slider_position);
 
-    // Find the next search subspace
-    const auto x_plus = [&]() -> VectorXd
+    // A copy of the data is updated so that the getters called from other threads can keep reading the published one
+    PublishSnapshot(ResolveNextSnapshot(CopyData(),
+                                        *slider,
+                                        slider_position,
+                                        num_map_estimation_iters,
+                                        num_global_search_iters,
+                                        num_local_search_iters,
+                                        speculation));
+
+    // The published surrogate model is now fit to the published data
+    m_has_pending_batch_feedback = false;
+
+    LaunchSpeculations();
+}
+
+std::shared_future<void> sequential_line_search::SequentialLineSearchOptimizer::SubmitFeedbackDataAsync(
+    const double                 slider_position,
+    int                          num_map_estimation_iters,
+    int                          num_global_search_iters,
+    int                          num_local_search_iters,
+    const std::function<void()>& on_completed)
+{
+    WaitForPendingUpdate();
+
+    SetDefaultComputationalEfforts(&num_map_estimation_iters, &num_global_search_iters, &num_local_search_iters);
+
+    const auto slider      = LoadSnapshot()->slider;
+    const auto speculation = FindSpeculation(
+        slider_position, num_map_estimation_iters, num_global_search_iters, num_local_search_iters);
+
+    // The feedback is written to the journal before returning, so that it is durable once it is acknowledged
+    AppendToJournal(*slider, (speculation == nullptr) ? slider_position : speculation->slider_position);
+
+    // The worker updates a copy of the data so that the getters can keep reading the published one. The speculations
+    // are not modified until the pending update finishes, so the pointer stays valid.
+    const auto data = CopyData();
+
+    const auto task = [this,
+                       data,
+                       slider,
+                       slider_position,
+                       num_map_estimation_iters,
+                       num_global_search_iters,
+                       num_local_search_iters,
+                       speculation,
+                       on_completed]()
     {
-        switch (m_current_best_selection_strategy)
+        // The callback is called even if the update fails, in which case nothing is published and the exception is
+        // rethrown by the future
+        try
         {
-            case CurrentBestSelectionStrategy::LargestExpectValue:
-                return m_regressor->FindArgMax();
-            case CurrentBestSelectionStrategy::LastSelection:
-                return x_chosen;
+            PublishSnapshot(ResolveNextSnapshot(data,
+                                                *slider,
+                                                slider_position,
+                                                num_map_estimation_iters,
+                                                num_global_search_iters,
+                                                num_local_search_iters,
+                                                speculation));
+
+            m_has_pending_batch_feedback = false;
+
+            LaunchSpeculations();
         }
-    }();
-    const auto x_acquisition = acquisition_func::FindNextPoint(*m_regressor,
-                                                               num_global_search_iters,
-                                                               num_local_search_iters,
-                                                               m_acquisition_func_type,
-                                                               m_gaussian_process_upper_confidence_bound_hyperparam);
+        catch (...)
+        {
+            if (on_completed)
+            {
+                on_completed();
+            }
+            throw;
+        }
+
+        if (on_completed)
+        {
+            on_completed();
+        }
+    };
+
+    m_pending_update = ExecuteAsync(*m_executor, task);
+
+    return m_pending_update;
+}
+
+void sequential_line_search::SequentialLineSearchOptimizer::WaitForPendingUpdate() const
+{
+    if (m_pending_update.valid())
+    {
+        m_pending_update.wait();
+    }
+}
+
+void sequential_line_search::SequentialLineSearchOptimizer::SetWarmStartAcquisitionSearch(
+    const bool use_warm_start, const double random_start_fraction)
+{
+    WaitForPendingUpdate();
+    StopSpeculations();
+
+    if (!use_warm_start)
+    {
+        m_warm_start_state = nullptr;
+    }
+    else
+    {
+        if (m_warm_start_state == nullptr)
+        {
+            m_warm_start_state = std::make_shared<acquisition_func::WarmStartState>();
+        }
+        m_warm_start_state->random_start_fraction = random_start_fraction;
+    }
+
+    LaunchSpeculations();
+}
+
+void sequential_line_search::SequentialLineSearchOptimizer::SetTrustRegionAcquisitionSearch(const bool use_trust_region)
+{
+    WaitForPendingUpdate();
+    StopSpeculations();
+
+    if (!use_trust_region)
+    {
+        m_trust_region = nullptr;
+    }
+    else if (m_trust_region == nullptr)
+    {
+        m_trust_region = std::make_shared<TrustRegion>(GetMaximizer().size());
+    }
+
+    LaunchSpeculations();
+}
+
+void sequential_line_search::SequentialLineSearchOptimizer::SetDataRetentionPolicy(const RetentionPolicy policy,
+                                                                                   const int max_num_data_points)
+{
+    WaitForPendingUpdate();
+
+    // The policy may discard points, so it is applied to a copy that replaces the published data. An invalid policy
+    // throws here, before anything is changed.
+    const auto data = CopyData();
+    data->SetRetentionPolicy(policy, max_num_data_points);
+
+    StopSpeculations();
+
+    const auto snapshot = LoadSnapshot();
+    PublishSnapshot(Snapshot{data, snapshot->regressor, snapshot->slider});
+
+    LaunchSpeculations();
+}
+
+void sequential_line_search::SequentialLineSearchOptimizer::SetGaussianProcessUpperConfidenceBoundHyperparam(
+    const double hyperparam)
+{
+    WaitForPendingUpdate();
+    StopSpeculations();
+
+    m_gaussian_process_upper_confidence_bound_hyperparam = hyperparam;
+
+    LaunchSpeculations();
+}
+
+void sequential_line_search::SequentialLineSearchOptimizer::SetSpeculativeSliderComputation(
+    const bool use_speculation, const int num_speculations, const double tolerance)
+{
+    WaitForPendingUpdate();
+    StopSpeculations();
+
+    m_num_speculations      = use_speculation ? num_speculations : 0;
+    m_speculation_tolerance = tolerance;
+
+    LaunchSpeculations();
+}
+
+void sequential_line_search::SequentialLineSearchOptimizer::SetExecutor(const std::shared_ptr<Executor>& executor)
+{
+    WaitForPendingUpdate();
+    StopSpeculations();
+
+    m_executor = (executor != nullptr) ? executor : GetDefaultExecutor();
+
+    LaunchSpeculations();
+}
+
+void sequential_line_search::SequentialLineSearchOptimizer::EnableFeedbackJournal(const std::string&      file_path,
+                                                                                  const JournalSyncPolicy sync_policy,
+                                                                                  const int               sync_interval)
+{
+    WaitForPendingUpdate();
+
+    // Close the previous journal first in case the same file is specified
+    m_journal = nullptr;
+    m_journal = std::make_shared<FeedbackJournal>(file_path, sync_policy, sync_interval);
+}
+
+void sequential_line_search::SequentialLineSearchOptimizer::DisableFeedbackJournal()
+{
+    WaitForPendingUpdate();
+
+    m_journal = nullptr;
+}
+
+int sequential_line_search::SequentialLineSearchOptimizer::ReplayFeedbackJournal(const std::string& file_path,
+                                                                                 int num_map_estimation_iters,
+                                                                                 int num_global_search_iters,
+                                                                                 int num_local_search_iters)
+{
+    const auto records = FeedbackJournal::Read(file_path);
+
+    if (records.empty())
+    {
+        return 0;
+    }
+
+    WaitForPendingUpdate();
+    StopSpeculations();
+
+    const auto data = CopyData();
+    AddFeedbackRecords(records, data.get());
+
+    UpdateModelAndSlider(data, num_map_estimation_iters, num_global_search_iters, num_local_search_iters);
 
-    m_slider = std::make_shared<Slider>(x_plus, x_acquisition, m_use_slider_enlargement);
+    return records.size();
+}
+
+void sequential_line_search::SequentialLineSearchOptimizer::ImportData(const Eigen::MatrixXd&         X,
+                                                                       const std::vector<Preference>& D,
+                                                                       const int num_map_estimation_iters,
+                                                                       const int num_global_search_iters,
+                                                                       const int num_local_search_iters)
+{
+    WaitForPendingUpdate();
+
+    const auto data = CopyData();
+    data->AddData(X, D);
+
+    if (data->GetNumDataPoints() != 0 && data->GetX().rows() != LoadSnapshot()->slider->original_end_0.size())
+    {
+        throw std::runtime_error("Inconsistent number of dimensions of the imported data.");
+    }
+
+    StopSpeculations();
+
+    UpdateModelAndSlider(data, num_map_estimation_iters, num_global_search_iters, num_local_search_iters);
+}
+
+void sequential_line_search::SequentialLineSearchOptimizer::ImportData(const std::string& directory_path,
+                                                                       const int          num_map_estimation_iters,
+                                                                       const int          num_global_search_iters,
+                                                                       const int          num_local_search_iters)
+{
+    WaitForPendingUpdate();
+
+    const auto data = CopyData();
+    data->ImportCsv(directory_path);
+
+    if (data->GetNumDataPoints() != 0 && data->GetX().rows() != LoadSnapshot()->slider->original_end_0.size())
+    {
+        throw std::runtime_error("Inconsistent number of dimensions of the imported data.");
+    }
+
+    StopSpeculations();
+
+    UpdateModelAndSlider(data, num_map_estimation_iters, num_global_search_iters, num_local_search_iters);
+}
+
+void sequential_line_search::SequentialLineSearchOptimizer::GenerateSliderBatch(const int num_sliders,
+                                                                                int       num_map_estimation_iters,
+                                                                                int       num_global_search_iters,
+                                                                                int       num_local_search_iters)
+{
+    assert(num_sliders > 0);
+
+    WaitForPendingUpdate();
+
+    // The speculations for the current slider become stale once the data is modified by the batch mode
+    CancelSpeculations();
+
+    m_batch_sliders.clear();
+
+    // Without any data, there is no surrogate model to derive sliders from
+    if (LoadSnapshot()->data->GetD().empty())
+    {
+        for (int i = 0; i < num_sliders; ++i)
+        {
+            const auto slider_ends = m_initial_query_generator(GetMaximizer().size());
+
+            m_batch_sliders.push_back(
+                std::make_shared<Slider>(std::get<0>(slider_ends), std::get<1>(slider_ends), false));
+        }
+
+        return;
+    }
+
+    SetDefaultComputationalEfforts(&num_map_estimation_iters, &num_global_search_iters, &num_local_search_iters);
+
+    // Refit the surrogate model only when responses have been submitted since the last fit
+    if (LoadSnapshot()->regressor == nullptr || m_has_pending_batch_feedback)
+    {
+        PerformMapEstimation(LoadSnapshot()->data, num_map_estimation_iters);
+    }
+
+    const auto snapshot = LoadSnapshot();
+
+    const VectorXd x_plus = FindCurrentBestPoint(*snapshot);
+
+    const auto xs_acquisition = acquisition_func::FindNextPoints(*snapshot->regressor,
+                                                                 num_sliders,
+                                                                 num_global_search_iters,
+                                                                 num_local_search_iters,
+                                                                 m_acquisition_func_type,
+                                                                 m_gaussian_process_upper_confidence_bound_hyperparam,
+                                                                 m_executor.get());
+
+    for (const VectorXd& x_acquisition : xs_acquisition)
+    {
+        m_batch_sliders.push_back(std::make_shared<Slider>(x_plus, x_acquisition, m_use_slider_enlargement));
+    }
+}
+
+void sequential_line_search::SequentialLineSearchOptimizer::SubmitBatchFeedbackData(const int    slider_index,
+                                                                                    const double slider_position)
+{
+    const Slider& slider = GetBatchSlider(slider_index);
+
+    WaitForPendingUpdate();
+    CancelSpeculations();
+
+    AppendToJournal(slider, slider_position);
+
+    // Update the data; the MAP estimation is deferred to the next batch generation, so the published surrogate model
+    // is fit to the previous data until then
+    const auto data = CopyData();
+    data->AddNewPoints(slider.GetValue(slider_position), {slider.original_end_0, slider.original_end_1}, true);
+
+    const auto snapshot = LoadSnapshot();
+    PublishSnapshot(Snapshot{data, snapshot->regressor, snapshot->slider});
+
+    m_has_pending_batch_feedback = true;
+}
+
+std::pair<VectorXd, VectorXd>
+sequential_line_search::SequentialLineSearchOptimizer::GetBatchSliderEnds(const int slider_index) const
+{
+    const Slider& slider = GetBatchSlider(slider_index);
+
+    return {slider.end_0, slider.end_1};
+}
+
+VectorXd sequential_line_search::SequentialLineSearchOptimizer::CalcPointFromBatchSliderPosition(
+    const int slider_index, const double slider_position) const
+{
+    return GetBatchSlider(slider_index).GetValue(slider_position);
 }
 
 std::pair<VectorXd, VectorXd> sequential_line_search::SequentialLineSearchOptimizer::GetSliderEnds() const
 {
-    return {m_slider->end_0, m_slider->end_1};
+    const auto slider = LoadSnapshot()->slider;
+
+    return {slider->end_0, slider->end_1};
 }
 
 VectorXd
 sequential_line_search::SequentialLineSearchOptimizer::CalcPointFromSliderPosition(const double slider_position) const
 {
-    return m_slider->GetValue(slider_position);
+    return LoadSnapshot()->slider->GetValue(slider_position);
+}
+
+Eigen::MatrixXd sequential_line_search::SequentialLineSearchOptimizer::CalcPointsFromSliderPositions(
+    const VectorXd& slider_positions) const
+{
+    const auto slider = LoadSnapshot()->slider;
+
+    // Each column is (1 - t) * end_0 + t * end_1 (see `Slider::GetValue`)
+    const VectorXd& ts = slider_positions;
+
+    return slider->end_0 * (1.0 - ts.array()).matrix().transpose() + slider->end_1 * ts.transpose();
 }
 
 VectorXd sequential_line_search::SequentialLineSearchOptimizer::GetMaximizer() const
 {
-    return m_slider->original_end_0;
+    return LoadSnapshot()->slider->original_end_0;
+}
+
+Eigen::MatrixXd sequential_line_search::SequentialLineSearchOptimizer::SampleSlider(const int num_samples,
+                                                                                   VectorXd* mu,
+                                                                                   VectorXd* sigma,
+                                                                                   VectorXd* acquisition_values) const
+{
+    const auto snapshot = LoadSnapshot();
+
+    const VectorXd  ts        = VectorXd::LinSpaced(num_samples, 0.0, 1.0);
+    const VectorXd& origin    = snapshot->slider->end_0;
+    const VectorXd  direction = snapshot->slider->end_1 - snapshot->slider->end_0;
+
+    const Eigen::MatrixXd X = (direction * ts.transpose()).colwise() + origin;
+
+    if (mu == nullptr && sigma == nullptr && acquisition_values == nullptr)
+    {
+        return X;
+    }
+
+    VectorXd mu_values    = VectorXd::Zero(num_samples);
+    VectorXd sigma_values = VectorXd::Zero(num_samples);
+    VectorXd acq_values   = VectorXd::Zero(num_samples);
+
+    if (snapshot->regressor != nullptr)
+    {
+        const PreferenceRegressor& regressor = *snapshot->regressor;
+
+        const Eigen::MatrixXd K_star = CalcLargeKStarOnLine(
+            origin, direction, ts, regressor.GetLargeX(), regressor.GetKernelHyperparams(), m_kernel_type);
+
+        const bool needs_sigma = sigma != nullptr || acquisition_values != nullptr;
+
+        regressor.PredictFromLargeKStar(K_star, &mu_values, needs_sigma ? &sigma_values : nullptr);
+
+        if (acquisition_values != nullptr)
+        {
+            acq_values = acquisition_func::CalcAcquisitionValuesFromPredictions(
+                regressor,
+                mu_values,
+                sigma_values,
+                m_acquisition_func_type,
+                m_gaussian_process_upper_confidence_bound_hyperparam);
+        }
+    }
+
+    if (mu != nullptr)
+    {
+        *mu = mu_values;
+    }
+    if (sigma != nullptr)
+    {
+        *sigma = sigma_values;
+    }
+    if (acquisition_values != nullptr)
+    {
+        *acquisition_values = acq_values;
+    }
+
+    return X;
 }
 
 double sequential_line_search::SequentialLineSearchOptimizer::GetPreferenceValueMean(const VectorXd& point) const
 {
-    return (m_regressor == nullptr) ? 0.0 : m_regressor->PredictMu(point);
+    const auto regressor = LoadSnapshot()->regressor;
+
+    return (regressor == nullptr) ? 0.0 : regressor->PredictMu(point);
 }
 
 double sequential_line_search::SequentialLineSearchOptimizer::GetPreferenceValueStdev(const VectorXd& point) const
 {
-    return (m_regressor == nullptr) ? 0.0 : m_regressor->PredictSigma(point);
+    const auto regressor = LoadSnapshot()->regressor;
+
+    return (regressor == nullptr) ? 0.0 : regressor->PredictSigma(point);
 }
 
 double sequential_line_search::SequentialLineSearchOptimizer::GetAcquisitionFuncValue(const VectorXd& point) const
 {
-    return (m_regressor == nullptr)
+    const auto regressor = LoadSnapshot()->regressor;
+
+    return (regressor == nullptr)
                ? 0.0
-               : acquisition_func::CalcAcquisitionValue(*m_regressor,
+               : acquisition_func::CalcAcquisitionValue(*regressor,
                                                         point,
                                                         m_acquisition_func_type,
                                                         m_gaussian_process_upper_confidence_bound_hyperparam);
 }
 
-const Eigen::MatrixXd& sequential_line_search::SequentialLineSearchOptimizer::GetRawDataPoints() const
+void sequential_line_search::SequentialLineSearchOptimizer::PredictPreferenceValues(
+    const Eigen::Ref<const Eigen::MatrixXd>& points, VectorXd* mu, VectorXd* sigma) const
 {
-    return m_data->GetX();
+    const auto snapshot  = LoadSnapshot();
+    const auto regressor = snapshot->regressor;
+    const int  num_dims  = snapshot->slider->original_end_0.size();
+
+    if (points.rows() != num_dims)
+    {
+        throw std::invalid_argument("The points have " + std::to_string(points.rows()) + " rows, but " +
+                                    std::to_string(num_dims) + " dimensions are expected.");
+    }
+
+    if (regressor == nullptr)
+    {
+        if (mu != nullptr)
+        {
+            *mu = VectorXd::Zero(points.cols());
+        }
+        if (sigma != nullptr)
+        {
+            *sigma = VectorXd::Zero(points.cols());
+        }
+        return;
+    }
+
+    regressor->PredictInBatch(points, mu, sigma);
+}
+
+Eigen::MatrixXd sequential_line_search::SequentialLineSearchOptimizer::GetRawDataPoints() const
+{
+    return LoadSnapshot()->data->GetX();
+}
+
+int sequential_line_search::SequentialLineSearchOptimizer::GetNumDims() const
+{
+    return LoadSnapshot()->slider->original_end_0.size();
+}
+
+int sequential_line_search::SequentialLineSearchOptimizer::GetNumDataPoints() const
+{
+    return LoadSnapshot()->data->GetNumDataPoints();
 }
 
 void sequential_line_search::SequentialLineSearchOptimizer::DampData(const std::string& directory_path) const
 {
-    if (m_regressor == nullptr)
+    const auto regressor = LoadSnapshot()->regressor;
+
+    if (regressor == nullptr)
+    {
+        return;
+    }
+
+    regressor->DampData(directory_path);
+}
+
+void sequential_line_search::SequentialLineSearchOptimizer::Save(std::ostream& stream) const
+{
+    WaitForPendingUpdate();
+
+    const auto snapshot = LoadSnapshot();
+
+    binary_io::WriteHeader(stream, snapshot_magic, snapshot_version);
+
+    // Configuration
+    binary_io::WriteInt32(stream, snapshot->slider->original_end_0.size());
+    binary_io::WriteBool(stream, m_use_slider_enlargement);
+    binary_io::WriteBool(stream, m_use_map_hyperparams);
+    binary_io::WriteUInt32(stream, static_cast<std::uint32_t>(m_current_best_selection_strategy));
+    binary_io::WriteUInt32(stream, static_cast<std::uint32_t>(m_kernel_type));
+    binary_io::WriteUInt32(stream, static_cast<std::uint32_t>(m_acquisition_func_type));
+    binary_io::WriteInt32(stream, m_num_speculations);
+    binary_io::WriteDouble(stream, m_speculation_tolerance);
+
+    // Hyperparameters
+    binary_io::WriteDouble(stream, m_kernel_signal_var);
+    binary_io::WriteDouble(stream, m_kernel_length_scale);
+    binary_io::WriteDouble(stream, m_noise_level);
+    binary_io::WriteDouble(stream, m_kernel_hyperparams_prior_var);
+    binary_io::WriteDouble(stream, m_btl_scale);
+    binary_io::WriteDouble(stream, m_gaussian_process_upper_confidence_bound_hyperparam);
+
+    // Data and surrogate model
+    snapshot->data->Save(stream);
+    binary_io::WriteBool(stream, snapshot->regressor != nullptr);
+    if (snapshot->regressor != nullptr)
+    {
+        snapshot->regressor->Save(stream);
+    }
+
+    // Sliders
+    WriteSlider(stream, *snapshot->slider);
+    binary_io::WriteUInt64(stream, m_batch_sliders.size());
+    for (const auto& batch_slider : m_batch_sliders)
+    {
+        WriteSlider(stream, *batch_slider);
+    }
+    binary_io::WriteBool(stream, m_has_pending_batch_feedback);
+
+    // States carried between iterations
+    binary_io::WriteBool(stream, m_warm_start_state != nullptr);
+    if (m_warm_start_state != nullptr)
+    {
+        binary_io::WriteDouble(stream, m_warm_start_state->random_start_fraction);
+        binary_io::WriteUInt32(stream, m_warm_start_state->num_kept_local_maxima);
+        binary_io::WriteUInt64(stream, m_warm_start_state->local_maxima.size());
+        for (const VectorXd& local_maximum : m_warm_start_state->local_maxima)
+        {
+            binary_io::WriteVector(stream, local_maximum);
+        }
+    }
+    binary_io::WriteBool(stream, m_trust_region != nullptr);
+    if (m_trust_region != nullptr)
+    {
+        m_trust_region->Save(stream);
+    }
+}
+
+void sequential_line_search::SequentialLineSearchOptimizer::Save(const std::string& file_path) const
+{
+    std::ofstream file(file_path, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Failed to open " + file_path + ".");
+    }
+
+    Save(file);
+
+    // A snapshot that is not completely written is useless, so failures in writing (e.g., a full disk) are reported
+    file.close();
+    if (file.fail())
+    {
+        throw std::runtime_error("Failed to write " + file_path + ".");
+    }
+}
+
+std::shared_ptr<sequential_line_search::SequentialLineSearchOptimizer>
+sequential_line_search::SequentialLineSearchOptimizer::Load(
+    std::istream&                                                  stream,
+    const std::function<std::pair<VectorXd, VectorXd>(const int)>& initial_query_generator)
+{
+    binary_io::ReadHeader(stream, snapshot_magic, snapshot_version);
+
+    // Configuration
+    const int  num_dims               = binary_io::ReadInt32(stream);
+    const bool use_slider_enlargement = binary_io::ReadBool(stream);
+    const bool use_map_hyperparams    = binary_io::ReadBool(stream);
+    const auto current_best_selection_strategy = static_cast<CurrentBestSelectionStrategy>(
+        binary_io::ReadEnum(stream, static_cast<std::uint32_t>(CurrentBestSelectionStrategy::LastSelection) + 1));
+    const auto   kernel_type           = static_cast<KernelType>(
+        binary_io::ReadEnum(stream, static_cast<std::uint32_t>(KernelType::ArdMatern52Kernel) + 1));
+    const auto   acquisition_func_type = static_cast<AcquisitionFuncType>(
+        binary_io::ReadEnum(stream, static_cast<std::uint32_t>(AcquisitionFuncType::ThompsonSampling) + 1));
+    const int    num_speculations      = binary_io::ReadInt32(stream);
+    const double speculation_tolerance = binary_io::ReadDouble(stream);
+
+    if (num_dims <= 0 || num_speculations < 0)
+    {
+        throw std::runtime_error("Invalid configuration in a binary snapshot.");
+    }
+
+    const auto optimizer = std::make_shared<SequentialLineSearchOptimizer>(num_dims,
+                                                                           use_slider_enlargement,
+                                                                           use_map_hyperparams,
+                                                                           kernel_type,
+                                                                           acquisition_func_type,
+                                                                           initial_query_generator,
+                                                                           current_best_selection_strategy);
+
+    // Hyperparameters
+    optimizer->m_kernel_signal_var                                  = binary_io::ReadDouble(stream);
+    optimizer->m_kernel_length_scale                                = binary_io::ReadDouble(stream);
+    optimizer->m_noise_level                                        = binary_io::ReadDouble(stream);
+    optimizer->m_kernel_hyperparams_prior_var                       = binary_io::ReadDouble(stream);
+    optimizer->m_btl_scale                                          = binary_io::ReadDouble(stream);
+    optimizer->m_gaussian_process_upper_confidence_bound_hyperparam = binary_io::ReadDouble(stream);
+
+    // Data and surrogate model
+    const auto data      = PreferenceDataManager::Load(stream);
+    const auto regressor = binary_io::ReadBool(stream) ? PreferenceRegressor::Load(stream) : nullptr;
+
+    if (data->GetNumDataPoints() != 0 && data->GetX().rows() != num_dims)
+    {
+        throw std::runtime_error("Inconsistent data in a binary snapshot.");
+    }
+    if (regressor != nullptr && regressor->GetLargeX().rows() != num_dims)
+    {
+        throw std::runtime_error("Inconsistent regressor in a binary snapshot.");
+    }
+
+    // Sliders
+    const auto slider = ReadSlider(stream);
+    if (slider->original_end_0.size() != num_dims)
     {
+        throw std::runtime_error("Inconsistent slider in a binary snapshot.");
+    }
+    optimizer->PublishSnapshot(Snapshot{data, regressor, slider});
+
+    const std::uint64_t num_batch_sliders = binary_io::ReadUInt64(stream);
+    for (std::uint64_t i = 0; i < num_batch_sliders; ++i)
+    {
+        const auto batch_slider = ReadSlider(stream);
+        if (batch_slider->original_end_0.size() != num_dims)
+        {
+            throw std::runtime_error("Inconsistent slider in a binary snapshot.");
+        }
+        optimizer->m_batch_sliders.push_back(batch_slider);
+    }
+    optimizer->m_has_pending_batch_feedback = binary_io::ReadBool(stream);
+
+    // States carried between iterations
+    if (binary_io::ReadBool(stream))
+    {
+        optimizer->m_warm_start_state = std::make_shared<acquisition_func::WarmStartState>();
+        optimizer->m_warm_start_state->random_start_fraction = binary_io::ReadDouble(stream);
+        optimizer->m_warm_start_state->num_kept_local_maxima = binary_io::ReadUInt32(stream);
+
+        const std::uint64_t num_local_maxima = binary_io::ReadUInt64(stream);
+        for (std::uint64_t i = 0; i < num_local_maxima; ++i)
+        {
+            optimizer->m_warm_start_state->local_maxima.push_back(binary_io::ReadVector(stream));
+        }
+    }
+    if (binary_io::ReadBool(stream))
+    {
+        optimizer->m_trust_region = TrustRegion::Load(stream);
+    }
+
+    optimizer->m_num_speculations      = num_speculations;
+    optimizer->m_speculation_tolerance = speculation_tolerance;
+    optimizer->LaunchSpeculations();
+
+    return optimizer;
+}
+
+std::shared_ptr<sequential_line_search::SequentialLineSearchOptimizer>
+sequential_line_search::SequentialLineSearchOptimizer::Load(
+    const std::string&                                             file_path,
+    const std::function<std::pair<VectorXd, VectorXd>(const int)>& initial_query_generator)
+{
+    std::ifstream file(file_path, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Failed to open " + file_path + ".");
+    }
+
+    return Load(file, initial_query_generator);
+}
+
+std::shared_ptr<const sequential_line_search::SequentialLineSearchOptimizer::Snapshot>
+sequential_line_search::SequentialLineSearchOptimizer::LoadSnapshot() const
+{
+    return std::atomic_load(&m_snapshot);
+}
+
+void sequential_line_search::SequentialLineSearchOptimizer::PublishSnapshot(const Snapshot& snapshot)
+{
+    // Readers holding the previous snapshot keep using it; it is destroyed when the last of them releases it
+    std::atomic_store(&m_snapshot, std::make_shared<const Snapshot>(snapshot));
+}
+
+void sequential_line_search::SequentialLineSearchOptimizer::SetDefaultComputationalEfforts(
+    int* num_map_estimation_iters, int* num_global_search_iters, int* num_local_search_iters) const
+{
+    // A heuristics to set the computational effort for solving the maximization of the acquisition function. This is
+    // not justified or validated.
+    const int num_dims = GetMaximizer().size();
+
+    if (*num_map_estimation_iters <= 0)
+    {
+        *num_map_estimation_iters = 100;
+    }
+    if (*num_global_search_iters <= 0)
+    {
+#ifdef SEQUENTIAL_LINE_SEARCH_USE_PARALLELIZED_MULTI_START_SEARCH
+        *num_global_search_iters = 10;
+#else
+        *num_global_search_iters = 50 * num_dims;
+#endif
+    }
+    if (*num_local_search_iters <= 0)
+    {
+        *num_local_search_iters = 10 * num_dims;
+    }
+}
+
+sequential_line_search::SequentialLineSearchOptimizer::Snapshot
+sequential_line_search::SequentialLineSearchOptimizer::CalcNextSnapshot(
+    const std::shared_ptr<PreferenceDataManager>& data,
+    const Slider&                                 slider,
+    const double                                  slider_position,
+    const int                                     num_map_estimation_iters,
+    const int                                     num_global_search_iters,
+    const int                                     num_local_search_iters,
+    acquisition_func::WarmStartState*             warm_start_state,
+    TrustRegion*                                  trust_region,
+    const CancellationToken*                      cancellation_token) const
+{
+    const auto  x_chosen   = slider.GetValue(slider_position);
+    const auto& x_prev_max = slider.original_end_0;
+    const auto& x_prev_ei  = slider.original_end_1;
+
+    // Update the data
+    data->AddNewPoints(x_chosen, {x_prev_max, x_prev_ei}, true);
+
+    // Perform the MAP estimation
+    const auto regressor = FitRegressor(*data, num_map_estimation_iters, cancellation_token);
+
+    if (IsCancelled(cancellation_token))
+    {
+        return Snapshot();
+    }
+
+    // Find the next search subspace
+    const auto x_plus = [&]() -> VectorXd
+    {
+        switch (m_current_best_selection_strategy)
+        {
+            case CurrentBestSelectionStrategy::LargestExpectValue:
+                return regressor->FindArgMax();
+            case CurrentBestSelectionStrategy::LastSelection:
+                return x_chosen;
+        }
+    }();
+
+    // Determine the search box; the whole search space is used unless the trust-region mode is enabled
+    VectorXd lower;
+    VectorXd upper;
+    if (trust_region != nullptr)
+    {
+        // The user's choice is regarded as an improvement if it is not (almost) the previous current-best point
+        const double slider_length = (x_prev_ei - x_prev_max).norm();
+        const bool   is_improved   = (x_chosen - x_prev_max).norm() > 0.05 * slider_length;
+
+        trust_region->Update(is_improved);
+
+        const VectorXd& kernel_hyperparams = regressor->GetKernelHyperparams();
+        const VectorXd  length_scales      = kernel_hyperparams.segment(1, kernel_hyperparams.size() - 1);
+
+        std::tie(lower, upper) = trust_region->CalcBounds(x_plus, length_scales);
+    }
+
+    const auto x_acquisition = acquisition_func::FindNextPoint(*regressor,
+                                                               num_global_search_iters,
+                                                               num_local_search_iters,
+                                                               m_acquisition_func_type,
+                                                               m_gaussian_process_upper_confidence_bound_hyperparam,
+                                                               warm_start_state,
+                                                               lower,
+                                                               upper,
+                                                               m_executor.get(),
+                                                               cancellation_token);
+
+    if (IsCancelled(cancellation_token))
+    {
+        return Snapshot();
+    }
+
+    return Snapshot{data, regressor, std::make_shared<Slider>(x_plus, x_acquisition, m_use_slider_enlargement)};
+}
+
+const sequential_line_search::SequentialLineSearchOptimizer::Speculation*
+sequential_line_search::SequentialLineSearchOptimizer::FindSpeculation(const double slider_position,
+                                                                       const int    num_map_estimation_iters,
+                                                                       const int    num_global_search_iters,
+                                                                       const int    num_local_search_iters) const
+{
+    const Speculation* speculation = nullptr;
+    for (const Speculation& candidate : m_speculations)
+    {
+        const double distance   = std::abs(candidate.slider_position - slider_position);
+        const bool   is_matched = distance <= m_speculation_tolerance &&
+                                candidate.num_map_estimation_iters == num_map_estimation_iters &&
+                                candidate.num_global_search_iters == num_global_search_iters &&
+                                candidate.num_local_search_iters == num_local_search_iters;
+
+        if (is_matched &&
+            (speculation == nullptr || distance < std::abs(speculation->slider_position - slider_position)))
+        {
+            speculation = &candidate;
+        }
+    }
+
+    return speculation;
+}
+
+sequential_line_search::SequentialLineSearchOptimizer::Snapshot
+sequential_line_search::SequentialLineSearchOptimizer::ResolveNextSnapshot(
+    const std::shared_ptr<PreferenceDataManager>& data,
+    const Slider&                                 slider,
+    const double                                  slider_position,
+    const int                                     num_map_estimation_iters,
+    const int                                     num_global_search_iters,
+    const int                                     num_local_search_iters,
+    const Speculation*                            speculation)
+{
+    if (speculation == nullptr)
+    {
+        CancelSpeculations();
+
+        return CalcNextSnapshot(data,
+                                slider,
+                                slider_position,
+                                num_map_estimation_iters,
+                                num_global_search_iters,
+                                num_local_search_iters,
+                                m_warm_start_state.get(),
+                                m_trust_region.get());
+    }
+
+    // Wait for the speculation (or run it here if no worker has started it), and adopt the states it has updated as
+    // well
+    const Snapshot snapshot = speculation->result.Get();
+
+    m_warm_start_state = speculation->warm_start_state;
+    m_trust_region     = speculation->trust_region;
+
+    CancelSpeculations();
+
+    return snapshot;
+}
+
+const sequential_line_search::Slider&
+sequential_line_search::SequentialLineSearchOptimizer::GetBatchSlider(const int slider_index) const
+{
+    // A negative index becomes too large when converted to the unsigned size type
+    if (static_cast<std::size_t>(slider_index) >= m_batch_sliders.size())
+    {
+        throw std::out_of_range("Invalid batch slider index: " + std::to_string(slider_index) + ".");
+    }
+    return *m_batch_sliders[slider_index];
+}
+
+void sequential_line_search::SequentialLineSearchOptimizer::AppendToJournal(const Slider& slider,
+                                                                            const double  slider_position)
+{
+    if (m_journal == nullptr)
+    {
+        return;
+    }
+
+    m_journal->Append(slider.GetValue(slider_position), {slider.original_end_0, slider.original_end_1});
+}
+
+std::vector<double> sequential_line_search::SequentialLineSearchOptimizer::CalcSpeculatedSliderPositions() const
+{
+    constexpr int num_samples = 101;
+
+    VectorXd mu;
+    SampleSlider(num_samples, &mu);
+
+    const VectorXd ts = VectorXd::LinSpaced(num_samples, 0.0, 1.0);
+
+    std::vector<double> slider_positions;
+
+    const auto add_slider_position = [&](const double slider_position)
+    {
+        for (const double existing_slider_position : slider_positions)
+        {
+            if (std::abs(existing_slider_position - slider_position) <= m_speculation_tolerance)
+            {
+                return;
+            }
+        }
+        slider_positions.push_back(slider_position);
+    };
+
+    // The maximizer of the predicted mean along the slider
+    int          max_index;
+    const double max_mu = mu.maxCoeff(&max_index);
+
+    add_slider_position(ts(max_index));
+
+    // Quantiles of the probability of each position being chosen under the BTL model
+    const VectorXd probs = ((mu.array() - max_mu) / m_btl_scale).exp().matrix();
+
+    VectorXd cumulative_probs(num_samples);
+    std::partial_sum(probs.data(), probs.data() + num_samples, cumulative_probs.data());
+
+    for (int k = 1; k < m_num_speculations; ++k)
+    {
+        const double level = cumulative_probs(num_samples - 1) * static_cast<double>(k) / m_num_speculations;
+        const int    index = std::lower_bound(cumulative_probs.data(), cumulative_probs.data() + num_samples, level) -
+                          cumulative_probs.data();
+
+        add_slider_position(ts(std::min(index, num_samples - 1)));
+    }
+
+    return slider_positions;
+}
+
+void sequential_line_search::SequentialLineSearchOptimizer::LaunchSpeculations()
+{
+    if (m_num_speculations <= 0)
+    {
+        return;
+    }
+
+    int num_map_estimation_iters = 0;
+    int num_global_search_iters  = 0;
+    int num_local_search_iters   = 0;
+
+    SetDefaultComputationalEfforts(&num_map_estimation_iters, &num_global_search_iters, &num_local_search_iters);
+
+    const auto snapshot = LoadSnapshot();
+
+    for (const double slider_position : CalcSpeculatedSliderPositions())
+    {
+        // Each speculation works on its own copies of the data and the states carried between iterations
+        const auto data             = std::make_shared<PreferenceDataManager>(*snapshot->data);
+        const auto slider           = snapshot->slider;
+        const auto warm_start_state = (m_warm_start_state == nullptr)
+                                          ? nullptr
+                                          : std::make_shared<acquisition_func::WarmStartState>(*m_warm_start_state);
+        const auto trust_region =
+            (m_trust_region == nullptr) ? nullptr : std::make_shared<TrustRegion>(*m_trust_region);
+        const auto cancellation_token = std::make_shared<CancellationToken>(false);
+
+        const auto task = [this,
+                           data,
+                           slider,
+                           slider_position,
+                           num_map_estimation_iters,
+                           num_global_search_iters,
+                           num_local_search_iters,
+                           warm_start_state,
+                           trust_region,
+                           cancellation_token]()
+        {
+            return CalcNextSnapshot(data,
+                                    *slider,
+                                    slider_position,
+                                    num_map_estimation_iters,
+                                    num_global_search_iters,
+                                    num_local_search_iters,
+                                    warm_start_state.get(),
+                                    trust_region.get(),
+                                    cancellation_token.get());
+        };
+
+        m_speculations.push_back(Speculation{slider_position,
+                                             num_map_estimation_iters,
+                                             num_global_search_iters,
+                                             num_local_search_iters,
+                                             warm_start_state,
+                                             trust_region,
+                                             cancellation_token,
+                                             ExecutorTask<Snapshot>(*m_executor, task)});
+    }
+}
+
+void sequential_line_search::SequentialLineSearchOptimizer::CancelSpeculations()
+{
+    for (const Speculation& speculation : m_speculations)
+    {
+        // A speculation that has not been started is dropped; a running one stops within one objective evaluation
+        *speculation.cancellation_token = true;
+        speculation.result.Cancel();
+        m_cancelled_speculations.push_back(speculation.result);
+    }
+    m_speculations.clear();
+
+    // Forget the cancelled speculations that have already finished
+    const auto is_finished = [](const ExecutorTask<Snapshot>& result) { return result.IsFinished(); };
+
+    m_cancelled_speculations.erase(
+        std::remove_if(m_cancelled_speculations.begin(), m_cancelled_speculations.end(), is_finished),
+        m_cancelled_speculations.end());
+}
+
+void sequential_line_search::SequentialLineSearchOptimizer::StopSpeculations()
+{
+    CancelSpeculations();
+
+    for (const auto& result : m_cancelled_speculations)
+    {
+        result.Wait();
+    }
+    m_cancelled_speculations.clear();
+}
+
+std::shared_ptr<const sequential_line_search::PreferenceRegressor>
+sequential_line_search::SequentialLineSearchOptimizer::FitRegressor(
+    const PreferenceDataManager& data,
+    const int                    num_map_estimation_iters,
+    const CancellationToken*     cancellation_token) const
+{
+    return std::make_shared<PreferenceRegressor>(data.GetX(),
+                                                 data.GetD(),
+                                                 m_use_map_hyperparams,
+                                                 m_kernel_signal_var,
+                                                 m_kernel_length_scale,
+                                                 m_noise_level,
+                                                 m_kernel_hyperparams_prior_var,
+                                                 m_btl_scale,
+                                                 num_map_estimation_iters,
+                                                 m_kernel_type,
+                                                 m_executor,
+                                                 cancellation_token);
+}
+
+void sequential_line_search::SequentialLineSearchOptimizer::PerformMapEstimation(
+    const std::shared_ptr<const PreferenceDataManager>& data, const int num_map_estimation_iters)
+{
+    const auto regressor = FitRegressor(*data, num_map_estimation_iters);
+
+    PublishSnapshot(Snapshot{data, regressor, LoadSnapshot()->slider});
+
+    // The published surrogate model is now fit to the published data
+    m_has_pending_batch_feedback = false;
+}
+
+std::shared_ptr<sequential_line_search::PreferenceDataManager>
+sequential_line_search::SequentialLineSearchOptimizer::CopyData() const
+{
+    const auto snapshot = LoadSnapshot();
+    const auto data     = std::make_shared<PreferenceDataManager>(*snapshot->data);
+
+    // The retention policy keeps the points around the current-best end-point
+    data->SetRetentionCenter(snapshot->slider->original_end_0);
+
+    return data;
+}
+
+void sequential_line_search::SequentialLineSearchOptimizer::UpdateModelAndSlider(
+    const std::shared_ptr<const PreferenceDataManager>& data,
+    int                                                 num_map_estimation_iters,
+    int                                                 num_global_search_iters,
+    int                                                 num_local_search_iters)
+{
+    if (data->GetD().empty())
+    {
+        const auto snapshot = LoadSnapshot();
+        PublishSnapshot(Snapshot{data, snapshot->regressor, snapshot->slider});
+
+        LaunchSpeculations();
         return;
     }
 
-    m_regressor->DampData(directory_path);
+    SetDefaultComputationalEfforts(&num_map_estimation_iters, &num_global_search_iters, &num_local_search_iters);
+
+    // Readers keep seeing the previous snapshot until the new slider is published below
+    const Snapshot snapshot{data, FitRegressor(*data, num_map_estimation_iters), LoadSnapshot()->slider};
+
+    const VectorXd x_plus = FindCurrentBestPoint(snapshot);
+
+    // The trust region is used as it is, since there is no response to the current slider to update it with
+    VectorXd lower;
+    VectorXd upper;
+    if (m_trust_region != nullptr)
+    {
+        const VectorXd& kernel_hyperparams = snapshot.regressor->GetKernelHyperparams();
+        const VectorXd  length_scales      = kernel_hyperparams.segment(1, kernel_hyperparams.size() - 1);
+
+        std::tie(lower, upper) = m_trust_region->CalcBounds(x_plus, length_scales);
+    }
+
+    const auto x_acquisition = acquisition_func::FindNextPoint(*snapshot.regressor,
+                                                               num_global_search_iters,
+                                                               num_local_search_iters,
+                                                               m_acquisition_func_type,
+                                                               m_gaussian_process_upper_confidence_bound_hyperparam,
+                                                               m_warm_start_state.get(),
+                                                               lower,
+                                                               upper,
+                                                               m_executor.get());
+
+    PublishSnapshot(Snapshot{
+        data, snapshot.regressor, std::make_shared<Slider>(x_plus, x_acquisition, m_use_slider_enlargement)});
+
+    m_has_pending_batch_feedback = false;
+
+    LaunchSpeculations();
+}
+
+VectorXd sequential_line_search::SequentialLineSearchOptimizer::FindCurrentBestPoint(const Snapshot& snapshot) const
+{
+    switch (m_current_best_selection_strategy)
+    {
+        case CurrentBestSelectionStrategy::LargestExpectValue:
+            return snapshot.regressor->FindArgMax();
+        case CurrentBestSelectionStrategy::LastSelection:
+            return snapshot.data->GetLastSelectedDataPoint();
+    }
 }
@@ -0,0 +1,564 @@
+#include <algorithm>
+#include <cstdio>
+#include <exception>
+#include <sequential-line-search/sequential-line-search.hpp>
+#include <sequential-line-search/session-manager.hpp>
+#include <stdexcept>
+#include <utility>
+
+sequential_line_search::SessionManager::SessionManager(const int          num_threads,
+                                                       const std::size_t  max_in_flight_memory,
+                                                       const int          max_num_resident_sessions,
+                                                       const std::string& eviction_directory_path)
+    : m_max_in_flight_memory(max_in_flight_memory),
+      m_max_num_resident_sessions(max_num_resident_sessions),
+      m_eviction_directory_path(eviction_directory_path),
+      m_next_session_id(0),
+      m_next_job_sequence(0),
+      m_num_in_flight_jobs(0),
+      m_in_flight_memory(0),
+      m_num_queued_jobs(0),
+      m_num_transfers(0),
+      m_thread_pool(num_threads),
+      m_executor(std::shared_ptr<Executor>(), &m_thread_pool)
+{
+}
+
+sequential_line_search::SessionManager::~SessionManager()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    // The evictions triggered by the last jobs may still be writing snapshot files
+    m_jobs_done_condition.wait(lock, [&]() { return m_num_queued_jobs == 0 && m_num_transfers == 0; });
+
+    // The optimizers may outlive this instance if they are still referenced elsewhere
+    for (auto& entry : m_sessions)
+    {
+        if (entry.second.optimizer != nullptr)
+        {
+            entry.second.optimizer->SetExecutor(nullptr);
+        }
+    }
+}
+
+sequential_line_search::SessionId
+sequential_line_search::SessionManager::AddSession(const std::shared_ptr<SequentialLineSearchOptimizer>& optimizer,
+                                                   const int                                             priority)
+{
+    optimizer->SetExecutor(m_executor);
+
+    const int num_dims        = optimizer->GetNumDims();
+    const int num_data_points = optimizer->GetNumDataPoints();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    const SessionId session_id = m_next_session_id++;
+
+    m_sessions[session_id] =
+        Session{optimizer, priority, {}, false, false, false, Clock::now(), num_dims, num_data_points};
+
+    EnforceResidentLimit(lock, session_id);
+
+    return session_id;
+}
+
+void sequential_line_search::SessionManager::RemoveSession(const SessionId session_id)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Session& session = FindSession(session_id);
+
+    // The session is erased by the last job or by the end of the transfer if any is pending
+    if (session.is_running || !session.jobs.empty() || session.is_transferring)
+    {
+        session.is_removed = true;
+        return;
+    }
+
+    EraseSession(session_id);
+}
+
+void sequential_line_search::SessionManager::SetSessionPriority(const SessionId session_id, const int priority)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Session& session = FindSession(session_id);
+
+    // The entry of a ready session is ordered by the priority
+    if (IsReady(session))
+    {
+        m_ready_sessions.erase(MakeReadySession(session_id, session));
+        session.priority = priority;
+        m_ready_sessions.insert(MakeReadySession(session_id, session));
+    }
+    else
+    {
+        session.priority = priority;
+    }
+}
+
+std::shared_future<void>
+sequential_line_search::SessionManager::SubmitFeedbackData(
+    const SessionId                                              session_id,
+    const double                                                 slider_position,
+    const Clock::time_point                                      deadline,
+    const std::function<void(const std::shared_future<void>&)>& on_completed)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    Session& session = MakeResident(lock, session_id);
+
+    session.last_access_time = Clock::now();
+
+    const auto promise = std::make_shared<std::promise<void>>();
+    const auto future  = promise->get_future().share();
+
+    session.jobs.push_back(
+        Job{session_id, slider_position, deadline, m_next_job_sequence++, future, promise, on_completed});
+    ++m_num_queued_jobs;
+
+    if (!session.is_running && session.jobs.size() == 1)
+    {
+        m_ready_sessions.insert(MakeReadySession(session_id, session));
+    }
+
+    DispatchJobs();
+    EnforceResidentLimit(lock, session_id);
+
+    return future;
+}
+
+std::shared_ptr<sequential_line_search::SequentialLineSearchOptimizer>
+sequential_line_search::SessionManager::GetOptimizer(const SessionId session_id)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    Session& session = MakeResident(lock, session_id);
+
+    session.last_access_time = Clock::now();
+
+    const auto optimizer = session.optimizer;
+
+    EnforceResidentLimit(lock, session_id);
+
+    return optimizer;
+}
+
+void sequential_line_search::SessionManager::SaveSession(const SessionId session_id, const std::string& file_path)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    m_jobs_done_condition.wait(lock,
+                               [&]()
+                               {
+                                   const Session& session = FindSession(session_id);
+                                   return !session.is_running && session.jobs.empty();
+                               });
+
+    // No job of the session can be submitted while it is being transferred
+    Session& session = MakeResident(lock, session_id);
+
+    session.last_access_time = Clock::now();
+
+    const auto optimizer = session.optimizer;
+
+    BeginTransfer(session);
+    lock.unlock();
+
+    std::exception_ptr exception;
+    try
+    {
+        optimizer->Save(file_path);
+    }
+    catch (...)
+    {
+        exception = std::current_exception();
+    }
+
+    lock.lock();
+    EndTransfer(session_id);
+
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+}
+
+int sequential_line_search::SessionManager::EvictIdleSessions(const Clock::duration idle_duration)
+{
+    if (m_eviction_directory_path.empty())
+    {
+        return 0;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    const Clock::time_point now = Clock::now();
+
+    std::vector<SessionId> session_ids;
+    for (const auto& entry : m_sessions)
+    {
+        const Session& session = entry.second;
+
+        const bool is_idle = !session.is_running && session.jobs.empty() && !session.is_transferring;
+
+        if (session.optimizer != nullptr && is_idle && now - session.last_access_time >= idle_duration)
+        {
+            session_ids.push_back(entry.first);
+        }
+    }
+
+    return Evict(lock, session_ids);
+}
+
+void sequential_line_search::SessionManager::WaitForAllJobs()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    m_jobs_done_condition.wait(lock, [&]() { return m_num_queued_jobs == 0; });
+}
+
+int sequential_line_search::SessionManager::GetNumSessions() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_sessions.size();
+}
+
+int sequential_line_search::SessionManager::GetNumResidentSessions() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    int num_resident_sessions = 0;
+    for (const auto& entry : m_sessions)
+    {
+        if (entry.second.optimizer != nullptr)
+        {
+            ++num_resident_sessions;
+        }
+    }
+    return num_resident_sessions;
+}
+
+void sequential_line_search::SessionManager::DispatchJobs()
+{
+    while (m_num_in_flight_jobs < m_thread_pool.GetNumThreads() && !m_ready_sessions.empty())
+    {
+        // The most urgent job among the next jobs of the sessions that are not running
+        Session& next_session = m_sessions.at(m_ready_sessions.begin()->session_id);
+
+        // Hold the job back if it would exceed the memory cap; it is dispatched when other jobs finish
+        const std::size_t memory = EstimateJobMemory(next_session.num_dims, next_session.num_data_points);
+        if (m_max_in_flight_memory != 0 && m_num_in_flight_jobs != 0 &&
+            m_in_flight_memory + memory > m_max_in_flight_memory)
+        {
+            return;
+        }
+
+        m_ready_sessions.erase(m_ready_sessions.begin());
+
+        const Job  job       = next_session.jobs.front();
+        const auto optimizer = next_session.optimizer;
+
+        next_session.jobs.pop_front();
+        next_session.is_running = true;
+
+        ++m_num_in_flight_jobs;
+        m_in_flight_memory += memory;
+
+        const auto task = [this, job, optimizer, memory]()
+        {
+            RunJob(job, optimizer);
+
+            // Tasks of the pool must not throw
+            if (job.on_completed)
+            {
+                try
+                {
+                    job.on_completed(job.future);
+                }
+                catch (...)
+                {
+                }
+            }
+
+            // The snapshot of the optimizer is read without the lock
+            const int num_data_points = optimizer->GetNumDataPoints();
+
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+
+                --m_num_in_flight_jobs;
+                m_in_flight_memory -= memory;
+                --m_num_queued_jobs;
+
+                Session& session = m_sessions.at(job.session_id);
+
+                session.is_running       = false;
+                session.last_access_time = Clock::now();
+                session.num_data_points  = num_data_points;
+
+                if (!session.jobs.empty())
+                {
+                    m_ready_sessions.insert(MakeReadySession(job.session_id, session));
+                }
+
+                if (session.is_removed && session.jobs.empty())
+                {
+                    EraseSession(job.session_id);
+                }
+
+                DispatchJobs();
+
+                // Sessions that could not be evicted while they had jobs may be evictable now
+                EnforceResidentLimit(lock, job.session_id);
+            }
+            m_jobs_done_condition.notify_all();
+        };
+
+        m_thread_pool.Submit(task);
+    }
+}
+
+void sequential_line_search::SessionManager::RunJob(const Job&                                            job,
+                                                    const std::shared_ptr<SequentialLineSearchOptimizer>& optimizer)
+{
+    try
+    {
+        optimizer->SubmitFeedbackData(job.slider_position);
+        job.promise->set_value();
+    }
+    catch (...)
+    {
+        job.promise->set_exception(std::current_exception());
+    }
+}
+
+sequential_line_search::SessionManager::Session&
+sequential_line_search::SessionManager::FindSession(const SessionId session_id)
+{
+    const auto iter = m_sessions.find(session_id);
+    if (iter == m_sessions.end() || iter->second.is_removed)
+    {
+        throw std::runtime_error("Unknown session: " + std::to_string(session_id) + ".");
+    }
+    return iter->second;
+}
+
+sequential_line_search::SessionManager::ReadySession
+sequential_line_search::SessionManager::MakeReadySession(const SessionId session_id, const Session& session)
+{
+    const Job& job = session.jobs.front();
+
+    return ReadySession{job.deadline, session.priority, job.sequence, session_id};
+}
+
+sequential_line_search::SessionManager::Session&
+sequential_line_search::SessionManager::MakeResident(std::unique_lock<std::mutex>& lock, const SessionId session_id)
+{
+    m_jobs_done_condition.wait(lock, [&]() { return !FindSession(session_id).is_transferring; });
+
+    Session& session = FindSession(session_id);
+
+    if (session.optimizer != nullptr)
+    {
+        return session;
+    }
+
+    const std::string snapshot_path = GetSnapshotPath(session_id);
+
+    BeginTransfer(session);
+    lock.unlock();
+
+    std::shared_ptr<SequentialLineSearchOptimizer> optimizer;
+    std::exception_ptr                             exception;
+    try
+    {
+        optimizer = SequentialLineSearchOptimizer::Load(snapshot_path);
+        optimizer->SetExecutor(m_executor);
+    }
+    catch (...)
+    {
+        exception = std::current_exception();
+    }
+
+    lock.lock();
+
+    // The session may have been removed meanwhile, in which case it is reported as unknown
+    if (!EndTransfer(session_id))
+    {
+        if (optimizer != nullptr)
+        {
+            optimizer->SetExecutor(nullptr);
+        }
+        throw std::runtime_error("Unknown session: " + std::to_string(session_id) + ".");
+    }
+
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+
+    session.optimizer = optimizer;
+
+    std::remove(snapshot_path.c_str());
+
+    return session;
+}
+
+int sequential_line_search::SessionManager::Evict(std::unique_lock<std::mutex>& lock,
+                                                  const std::vector<SessionId>& session_ids)
+{
+    if (session_ids.empty())
+    {
+        return 0;
+    }
+
+    std::vector<std::shared_ptr<SequentialLineSearchOptimizer>> optimizers;
+    for (const SessionId session_id : session_ids)
+    {
+        Session& session = m_sessions.at(session_id);
+
+        optimizers.push_back(session.optimizer);
+        BeginTransfer(session);
+    }
+
+    lock.unlock();
+
+    // Save throws when the file cannot be written completely (e.g., on a full disk); such a session stays resident
+    std::vector<bool> is_saved(session_ids.size(), false);
+    for (std::size_t i = 0; i < session_ids.size(); ++i)
+    {
+        const std::string snapshot_path = GetSnapshotPath(session_ids[i]);
+        try
+        {
+            optimizers[i]->Save(snapshot_path);
+            is_saved[i] = true;
+        }
+        catch (const std::exception&)
+        {
+            std::remove(snapshot_path.c_str());
+        }
+    }
+
+    lock.lock();
+
+    int num_evicted_sessions = 0;
+    for (std::size_t i = 0; i < session_ids.size(); ++i)
+    {
+        if (!EndTransfer(session_ids[i]) || !is_saved[i])
+        {
+            continue;
+        }
+
+        // No job can have been submitted during the transfer, so the session is still idle
+        Session& session = m_sessions.at(session_ids[i]);
+
+        session.optimizer->SetExecutor(nullptr);
+        session.optimizer = nullptr;
+
+        ++num_evicted_sessions;
+    }
+
+    return num_evicted_sessions;
+}
+
+void sequential_line_search::SessionManager::EnforceResidentLimit(std::unique_lock<std::mutex>& lock,
+                                                                  const SessionId               protected_session_id)
+{
+    if (m_max_num_resident_sessions <= 0 || m_eviction_directory_path.empty())
+    {
+        return;
+    }
+
+    // Sessions being transferred are not counted; those being loaded are counted when they are accessed next
+    int                                                  num_resident_sessions = 0;
+    std::vector<std::pair<Clock::time_point, SessionId>> candidates;
+    for (const auto& entry : m_sessions)
+    {
+        const Session& session = entry.second;
+
+        if (session.optimizer == nullptr || session.is_transferring)
+        {
+            continue;
+        }
+
+        ++num_resident_sessions;
+
+        if (!session.is_running && session.jobs.empty() && entry.first != protected_session_id)
+        {
+            candidates.push_back({session.last_access_time, entry.first});
+        }
+    }
+
+    if (num_resident_sessions <= m_max_num_resident_sessions)
+    {
+        return;
+    }
+
+    // Evict the least recently used ones
+    const std::size_t num_victims =
+        std::min(candidates.size(), static_cast<std::size_t>(num_resident_sessions - m_max_num_resident_sessions));
+
+    std::partial_sort(candidates.begin(), candidates.begin() + num_victims, candidates.end());
+
+    std::vector<SessionId> session_ids;
+    for (std::size_t i = 0; i < num_victims; ++i)
+    {
+        session_ids.push_back(candidates[i].second);
+    }
+
+    Evict(lock, session_ids);
+}
+
+void sequential_line_search::SessionManager::BeginTransfer(Session& session)
+{
+    session.is_transferring = true;
+    ++m_num_transfers;
+}
+
+bool sequential_line_search::SessionManager::EndTransfer(const SessionId session_id)
+{
+    Session& session = m_sessions.at(session_id);
+
+    session.is_transferring = false;
+    --m_num_transfers;
+
+    m_jobs_done_condition.notify_all();
+
+    if (session.is_removed)
+    {
+        EraseSession(session_id);
+        return false;
+    }
+    return true;
+}
+
+void sequential_line_search::SessionManager::EraseSession(const SessionId session_id)
+{
+    Session& session = m_sessions.at(session_id);
+
+    // The snapshot file exists if the session has been evicted or was being evicted
+    std::remove(GetSnapshotPath(session_id).c_str());
+
+    if (session.optimizer != nullptr)
+    {
+        session.optimizer->SetExecutor(nullptr);
+    }
+    m_sessions.erase(session_id);
+}
+
+std::string sequential_line_search::SessionManager::GetSnapshotPath(const SessionId session_id) const
+{
+    return m_eviction_directory_path + "/session-" + std::to_string(session_id) + ".bin";
+}
+
+std::size_t sequential_line_search::SessionManager::EstimateJobMemory(const int num_dims, const int num_data_points)
+{
+    // The data grows by the three points of the new feedback. The dominant parts are the kernel matrix, its
+    // factorization, and its derivatives with respect to the kernel hyperparameters (one per dimension plus one).
+    const std::size_t D = num_dims;
+    const std::size_t N = num_data_points + 3;
+
+    return sizeof(double) * (N * N * (D + 3) + 4 * N * D);
+}
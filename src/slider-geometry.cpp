@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sequential-line-search/slider-geometry.hpp>
+
+using Eigen::VectorXd;
+using std::pair;
+
+namespace
+{
+    inline VectorXd GetLowerOrDefault(const VectorXd& lower, const int num_dims)
+    {
+        return (lower.size() == 0) ? VectorXd::Zero(num_dims) : lower;
+    }
+
+    inline VectorXd GetUpperOrDefault(const VectorXd& upper, const int num_dims)
+    {
+        return (upper.size() == 0) ? VectorXd::Ones(num_dims) : upper;
+    }
+} // namespace
+
+pair<double, double> sequential_line_search::slider_geometry::CalcLineBoxIntersection(const VectorXd& origin,
+                                                                                      const VectorXd& direction,
+                                                                                      const VectorXd& lower,
+                                                                                      const VectorXd& upper)
+{
+    const int      num_dims = origin.size();
+    const VectorXd l        = GetLowerOrDefault(lower, num_dims);
+    const VectorXd u        = GetUpperOrDefault(upper, num_dims);
+
+    double t_min = -std::numeric_limits<double>::infinity();
+    double t_max = +std::numeric_limits<double>::infinity();
+
+    for (int i = 0; i < num_dims; ++i)
+    {
+        if (direction(i) == 0.0)
+        {
+            // The line is parallel to this slab
+            if (origin(i) < l(i) || origin(i) > u(i))
+            {
+                return {+std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity()};
+            }
+            continue;
+        }
+
+        const double t_l = (l(i) - origin(i)) / direction(i);
+        const double t_u = (u(i) - origin(i)) / direction(i);
+
+        t_min = std::max(t_min, std::min(t_l, t_u));
+        t_max = std::min(t_max, std::max(t_l, t_u));
+    }
+
+    return {t_min, t_max};
+}
+
+pair<VectorXd, VectorXd> sequential_line_search::slider_geometry::EnlargeSliderEnds(const VectorXd& end_0,
+                                                                                    const VectorXd& end_1,
+                                                                                    const double    scale,
+                                                                                    const double    minimum_length,
+                                                                                    const VectorXd& lower,
+                                                                                    const VectorXd& upper)
+{
+    const int      num_dims = end_0.size();
+    const VectorXd l        = GetLowerOrDefault(lower, num_dims);
+    const VectorXd u        = GetUpperOrDefault(upper, num_dims);
+
+    const VectorXd x_0 = end_0.cwiseMax(l).cwiseMin(u);
+    const VectorXd x_1 = end_1.cwiseMax(l).cwiseMin(u);
+
+    // The slider is parameterized as c + t * r, where t = +1 and t = -1 correspond to the two end-points
+    const VectorXd c = 0.5 * (x_0 + x_1);
+    const VectorXd r = x_0 - c;
+
+    const double r_norm = r.norm();
+    if (r_norm == 0.0)
+    {
+        return {x_0, x_1};
+    }
+
+    // Since the end-points are in the box, t_lower <= -1 and t_upper >= +1 hold
+    const auto   range   = CalcLineBoxIntersection(c, r, l, u);
+    const double t_0_max = std::max(range.second, 1.0);
+    const double t_1_max = std::max(-range.first, 1.0);
+
+    double t_0 = std::min(scale, t_0_max);
+    double t_1 = std::min(scale, t_1_max);
+
+    // Extend the slider to the minimum length, evenly in both directions as much as possible
+    const double deficit = minimum_length / r_norm - (t_0 + t_1);
+    if (deficit > 0.0)
+    {
+        const double extension_0 = std::min(0.5 * deficit, t_0_max - t_0);
+        const double extension_1 = std::min(deficit - extension_0, t_1_max - t_1);
+
+        t_0 += std::min(deficit - extension_1, t_0_max - t_0);
+        t_1 += extension_1;
+    }
+
+    // Crop the end-points to remove numerical errors
+    return {(c + t_0 * r).cwiseMax(l).cwiseMin(u), (c - t_1 * r).cwiseMax(l).cwiseMin(u)};
+}
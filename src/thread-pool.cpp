@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <sequential-line-search/thread-pool.hpp>
+
+namespace
+{
+    /// \brief The pool that the current thread works for (if any) and the index of the worker.
+    thread_local const sequential_line_search::ThreadPool* current_pool         = nullptr;
+    thread_local int                                       current_worker_index = -1;
+} // namespace
+
+sequential_line_search::ThreadPool::ThreadPool(const int num_threads)
+    : m_num_pending_tasks(0), m_is_stopping(false), m_next_queue_index(0)
+{
+    const int num_workers =
+        (num_threads > 0) ? num_threads : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    for (int i = 0; i < num_workers; ++i)
+    {
+        m_queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+    }
+    for (int i = 0; i < num_workers; ++i)
+    {
+        m_threads.push_back(std::thread(&ThreadPool::RunWorker, this, i));
+    }
+}
+
+sequential_line_search::ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_is_stopping = true;
+    }
+    m_condition.notify_all();
+
+    for (std::thread& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+void sequential_line_search::ThreadPool::Submit(std::function<void()> task)
+{
+    const int queue_index =
+        (current_pool == this) ? current_worker_index : (m_next_queue_index++ % static_cast<unsigned>(m_queues.size()));
+
+    // The counter is incremented first so that it never falls below the number of queued tasks
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        ++m_num_pending_tasks;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_queues[queue_index]->mutex);
+
+        m_queues[queue_index]->tasks.push_back(std::move(task));
+    }
+    m_condition.notify_one();
+}
+
+void sequential_line_search::ThreadPool::RunWorker(const int worker_index)
+{
+    current_pool         = this;
+    current_worker_index = worker_index;
+
+    while (true)
+    {
+        std::function<void()> task;
+        if (PopTask(worker_index, &task))
+        {
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        m_condition.wait(lock, [&]() { return m_num_pending_tasks > 0 || m_is_stopping; });
+
+        // The pending tasks are run to completion before stopping
+        if (m_is_stopping && m_num_pending_tasks == 0)
+        {
+            return;
+        }
+    }
+}
+
+bool sequential_line_search::ThreadPool::PopTask(const int worker_index, std::function<void()>* task)
+{
+    const int num_queues = m_queues.size();
+
+    bool is_found = false;
+
+    // The own queue is used as a stack, and the others are stolen from in FIFO order
+    {
+        WorkerQueue&                own_queue = *m_queues[worker_index];
+        std::lock_guard<std::mutex> lock(own_queue.mutex);
+
+        if (!own_queue.tasks.empty())
+        {
+            *task = std::move(own_queue.tasks.back());
+            own_queue.tasks.pop_back();
+            is_found = true;
+        }
+    }
+    for (int offset = 1; offset < num_queues && !is_found; ++offset)
+    {
+        WorkerQueue&                victim_queue = *m_queues[(worker_index + offset) % num_queues];
+        std::lock_guard<std::mutex> lock(victim_queue.mutex);
+
+        if (!victim_queue.tasks.empty())
+        {
+            *task = std::move(victim_queue.tasks.front());
+            victim_queue.tasks.pop_front();
+            is_found = true;
+        }
+    }
+
+    if (is_found)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        --m_num_pending_tasks;
+    }
+
+    return is_found;
+}
@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <cmath>
+#include <sequential-line-search/binary-io.hpp>
+#include <sequential-line-search/trust-region.hpp>
+
+using Eigen::VectorXd;
+
+sequential_line_search::TrustRegion::TrustRegion(const int    num_dims,
+                                                 const double initial_length,
+                                                 const double min_length,
+                                                 const double max_length,
+                                                 const int    success_tolerance,
+                                                 const int    failure_tolerance)
+    : m_initial_length(initial_length),
+      m_min_length(min_length),
+      m_max_length(max_length),
+      m_success_tolerance(success_tolerance),
+      m_failure_tolerance(failure_tolerance > 0 ? failure_tolerance : std::max(4, num_dims)),
+      m_length(initial_length),
+      m_success_count(0),
+      m_failure_count(0)
+{
+}
+
+void sequential_line_search::TrustRegion::Update(const bool is_improved)
+{
+    if (is_improved)
+    {
+        ++m_success_count;
+        m_failure_count = 0;
+    }
+    else
+    {
+        ++m_failure_count;
+        m_success_count = 0;
+    }
+
+    if (m_success_count >= m_success_tolerance)
+    {
+        m_length        = std::min(2.0 * m_length, m_max_length);
+        m_success_count = 0;
+    }
+    else if (m_failure_count >= m_failure_tolerance)
+    {
+        m_length        = 0.5 * m_length;
+        m_failure_count = 0;
+    }
+
+    // Restart with a large region when the region has collapsed
+    if (m_length < m_min_length)
+    {
+        m_length = m_initial_length;
+    }
+}
+
+std::pair<VectorXd, VectorXd> sequential_line_search::TrustRegion::CalcBounds(const VectorXd& center,
+                                                                              const VectorXd& length_scales) const
+{
+    const int num_dims = center.size();
+
+    // Normalize the length scales so that their geometric mean is one (i.e., the volume of the box is kept)
+    const VectorXd weights = [&]() -> VectorXd
+    {
+        if (length_scales.size() == 0)
+        {
+            return VectorXd::Ones(num_dims);
+        }
+        const VectorXd log_length_scales = length_scales.array().log().matrix();
+        return (log_length_scales.array() - log_length_scales.mean()).exp().matrix();
+    }();
+
+    const VectorXd half_lengths = 0.5 * m_length * weights;
+
+    const VectorXd lower = (center - half_lengths).cwiseMax(VectorXd::Zero(num_dims));
+    const VectorXd upper = (center + half_lengths).cwiseMin(VectorXd::Ones(num_dims));
+
+    return {lower, upper};
+}
+
+void sequential_line_search::TrustRegion::Save(std::ostream& stream) const
+{
+    binary_io::WriteDouble(stream, m_initial_length);
+    binary_io::WriteDouble(stream, m_min_length);
+    binary_io::WriteDouble(stream, m_max_length);
+    binary_io::WriteInt32(stream, m_success_tolerance);
+    binary_io::WriteInt32(stream, m_failure_tolerance);
+
+    binary_io::WriteDouble(stream, m_length);
+    binary_io::WriteInt32(stream, m_success_count);
+    binary_io::WriteInt32(stream, m_failure_count);
+}
+
+std::shared_ptr<sequential_line_search::TrustRegion> sequential_line_search::TrustRegion::Load(std::istream& stream)
+{
+    const double initial_length    = binary_io::ReadDouble(stream);
+    const double min_length        = binary_io::ReadDouble(stream);
+    const double max_length        = binary_io::ReadDouble(stream);
+    const int    success_tolerance = binary_io::ReadInt32(stream);
+    const int    failure_tolerance = binary_io::ReadInt32(stream);
+
+    // The failure tolerance is stored after being resolved, so the number of dimensions is not needed here
+    const auto trust_region = std::make_shared<TrustRegion>(
+        0, initial_length, min_length, max_length, success_tolerance, failure_tolerance);
+
+    trust_region->m_length        = binary_io::ReadDouble(stream);
+    trust_region->m_success_count = binary_io::ReadInt32(stream);
+    trust_region->m_failure_count = binary_io::ReadInt32(stream);
+
+    return trust_region;
+}
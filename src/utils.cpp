@@ -1,6 +1,9 @@
 #include <Eigen/Core>
+#include <cstdlib>
 #include <fstream>
 #include <sequential-line-search/utils.hpp>
+#include <stdexcept>
+#include <vector>
 
 using Eigen::MatrixXd;
 using Eigen::VectorXd;
@@ -13,6 +16,64 @@ Eigen::VectorXd sequential_line_search::utils::GenerateRandomVector(unsigned n)
 void sequential_line_search::utils::ExportMatrixToCsv(const std::string& file_path, const Eigen::MatrixXd& X)
 {
     std::ofstream   file(file_path);
-    Eigen::IOFormat format(Eigen::StreamPrecision, Eigen::DontAlignCols, ",");
+    Eigen::IOFormat format(Eigen::FullPrecision, Eigen::DontAlignCols, ",");
     file << X.format(format);
 }
+
+Eigen::MatrixXd sequential_line_search::utils::ImportMatrixFromCsv(const std::string& file_path)
+{
+    std::ifstream file(file_path);
+    if (!file)
+    {
+        throw std::runtime_error("Failed to open " + file_path + ".");
+    }
+
+    // The elements are accumulated in row-major order, since the number of rows is not known in advance
+    std::vector<double> elements;
+    int                 num_rows = 0;
+    int                 num_cols = -1;
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty())
+        {
+            continue;
+        }
+
+        int         num_row_elements = 0;
+        const char* begin            = line.c_str();
+        while (true)
+        {
+            char*        end   = nullptr;
+            const double value = std::strtod(begin, &end);
+            if (end == begin)
+            {
+                throw std::runtime_error("Invalid number in " + file_path + ".");
+            }
+            elements.push_back(value);
+            ++num_row_elements;
+
+            if (*end != ',')
+            {
+                break;
+            }
+            begin = end + 1;
+        }
+
+        if (num_cols >= 0 && num_row_elements != num_cols)
+        {
+            throw std::runtime_error("Inconsistent number of columns in " + file_path + ".");
+        }
+        num_cols = num_row_elements;
+        ++num_rows;
+    }
+
+    if (num_rows == 0)
+    {
+        return Eigen::MatrixXd();
+    }
+
+    return Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>(
+        elements.data(), num_rows, num_cols);
+}
@@ -0,0 +1,134 @@
+#include "../test-util.hpp"
+#include <cstdio>
+#include <iostream>
+#include <sequential-line-search/preference-data-manager.hpp>
+#include <sequential-line-search/preferential-bayesian-optimizer.hpp>
+#include <sequential-line-search/sequential-line-search.hpp>
+#include <stdexcept>
+#include <string>
+
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+using sequential_line_search::Preference;
+using sequential_line_search::PreferenceDataManager;
+using sequential_line_search::PreferentialBayesianOptimizer;
+using sequential_line_search::RetentionPolicy;
+using sequential_line_search::SequentialLineSearchOptimizer;
+using test_util::Check;
+using test_util::Throws;
+
+namespace
+{
+    constexpr int num_dims       = 3;
+    constexpr int num_iterations = 3;
+
+    // The CSV files (X.csv and D.csv) are written to the working directory
+    const std::string directory_path = ".";
+
+    void TestDataManager()
+    {
+        PreferenceDataManager data;
+        data.AddData(MatrixXd::Random(2, 3), {Preference(0, 1), Preference(2, 1)});
+
+        Check(Throws([&]() { data.AddData(MatrixXd::Random(3, 2), {Preference(0, 1)}); }), "inconsistent dimensions");
+        Check(Throws([&]() { data.AddData(MatrixXd::Random(2, 2), {Preference(0, 2)}); }), "index out of range");
+        Check(data.GetNumDataPoints() == 3, "data after rejected additions");
+
+        data.AddData(MatrixXd::Random(2, 2), {Preference(0, 1)});
+        Check(data.GetNumDataPoints() == 5, "data after a valid addition");
+
+        // The merging threshold is the cell size of the hash grid, so it must be positive
+        const auto add_data   = [&]() { data.AddData(MatrixXd::Random(2, 2), {Preference(0, 1)}, true, 0.0); };
+        const auto add_points = [&]() { data.AddNewPoints(VectorXd::Random(2), {VectorXd::Random(2)}, true, -1.0); };
+        Check(Throws<std::invalid_argument>(add_data), "non-positive threshold");
+        Check(Throws<std::invalid_argument>(add_points), "negative threshold");
+        Check(data.GetNumDataPoints() == 5, "data after rejected thresholds");
+    }
+
+    void TestRetention()
+    {
+        // Three observations, the last of which is protected; the points 1 and 3 are never preferred
+        MatrixXd X(2, 6);
+        X << 0.5, 1.0, 0.4, 0.0, 0.0, 0.6, 0.5, 1.0, 0.6, 0.0, 0.1, 0.4;
+
+        PreferenceDataManager data;
+        data.AddData(X, {Preference(0, 1), Preference(2, 3), Preference(4, 5)}, false);
+
+        // The point farthest from the current maximizer (1, 1) is dropped, rather than the one farthest from the last
+        // selected point (0, 0.1)
+        data.SetRetentionCenter(X.col(1));
+        data.SetRetentionPolicy(RetentionPolicy::DropDominatedFar, 5);
+
+        bool has_far_point  = false;
+        bool has_near_point = false;
+        for (int i = 0; i < data.GetNumDataPoints(); ++i)
+        {
+            has_far_point  = has_far_point || data.GetX().col(i) == X.col(3);
+            has_near_point = has_near_point || data.GetX().col(i) == X.col(1);
+        }
+        Check(!has_far_point && has_near_point, "point dropped by the distance from the maximizer");
+
+        Check(Throws<std::invalid_argument>([&]() { data.SetRetentionPolicy(RetentionPolicy::SlidingWindow, 0); }),
+              "non-positive number of data points");
+    }
+
+    void TestCsvImport()
+    {
+        SequentialLineSearchOptimizer optimizer(num_dims);
+        for (int i = 0; i < num_iterations; ++i)
+        {
+            optimizer.SubmitFeedbackData(0.2 * i + 0.3);
+        }
+        optimizer.DampData(directory_path);
+
+        const int num_data_points = optimizer.GetRawDataPoints().cols();
+
+        // The data can be imported by optimizers with the same number of dimensions
+        SequentialLineSearchOptimizer imported_optimizer(num_dims);
+        imported_optimizer.ImportData(directory_path);
+        Check(imported_optimizer.GetRawDataPoints().cols() == num_data_points, "imported data");
+
+        PreferentialBayesianOptimizer imported_preferential_optimizer(num_dims);
+        imported_preferential_optimizer.ImportData(directory_path);
+        Check(imported_preferential_optimizer.GetRawDataPoints().cols() == num_data_points, "imported data (PBO)");
+
+        // The data is rejected by optimizers with a different number of dimensions, which are left unchanged
+        SequentialLineSearchOptimizer mismatched_optimizer(num_dims - 1);
+        mismatched_optimizer.SubmitFeedbackData(0.5);
+        const auto slider_ends = mismatched_optimizer.GetSliderEnds();
+        Check(Throws([&]() { mismatched_optimizer.ImportData(directory_path); }), "mismatched import");
+        Check(mismatched_optimizer.GetRawDataPoints().cols() == 3, "data after a mismatched import");
+        Check(mismatched_optimizer.GetSliderEnds() == slider_ends, "slider after a mismatched import");
+
+        SequentialLineSearchOptimizer empty_mismatched_optimizer(num_dims + 1);
+        Check(Throws([&]() { empty_mismatched_optimizer.ImportData(directory_path); }), "mismatched import (empty)");
+        Check(empty_mismatched_optimizer.GetRawDataPoints().cols() == 0, "data after a mismatched import (empty)");
+
+        PreferentialBayesianOptimizer mismatched_preferential_optimizer(num_dims - 1);
+        Check(Throws([&]() { mismatched_preferential_optimizer.ImportData(directory_path); }),
+              "mismatched import (PBO)");
+        Check(Throws([&]() { mismatched_preferential_optimizer.ImportData(optimizer.GetRawDataPoints(), {}); }),
+              "mismatched matrix import (PBO)");
+
+        // Missing files are reported
+        Check(Throws([&]() { imported_optimizer.ImportData("nonexistent-directory"); }), "missing files");
+
+        std::remove((directory_path + "/X.csv").c_str());
+        std::remove((directory_path + "/D.csv").c_str());
+    }
+} // namespace
+
+int main()
+{
+    TestDataManager();
+    TestRetention();
+    TestCsvImport();
+
+    if (test_util::GetNumFailures() != 0)
+    {
+        return 1;
+    }
+
+    std::cout << "All data import tests passed." << std::endl;
+    return 0;
+}
@@ -0,0 +1,166 @@
+#include "../test-util.hpp"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <sequential-line-search/executor.hpp>
+#include <sequential-line-search/thread-pool.hpp>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using sequential_line_search::Executor;
+using sequential_line_search::ExecutorTask;
+using sequential_line_search::ParallelFor;
+using sequential_line_search::ThreadPool;
+using test_util::Check;
+using test_util::Throws;
+
+namespace
+{
+    constexpr int num_tasks = 1000;
+
+    void TestThreadPool()
+    {
+        std::atomic<int> num_runs(0);
+        {
+            ThreadPool thread_pool(4);
+            Check(thread_pool.GetNumThreads() == 4, "number of threads");
+
+            // Half of the tasks are submitted from within tasks, which exercises the per-worker queues and stealing
+            for (int i = 0; i < num_tasks / 2; ++i)
+            {
+                thread_pool.Submit(
+                    [&]()
+                    {
+                        ++num_runs;
+                        thread_pool.Submit([&]() { ++num_runs; });
+                    });
+            }
+        }
+
+        // The destructor runs all the submitted tasks to completion
+        Check(num_runs == num_tasks, "tasks run by the pool");
+    }
+
+    void TestParallelFor(Executor* executor, const std::string& name)
+    {
+        // Each index is visited exactly once
+        std::vector<std::atomic<int>> counts(num_tasks);
+        for (auto& count : counts)
+        {
+            count = 0;
+        }
+        ParallelFor(executor, num_tasks, [&](const int i) { ++counts[i]; });
+
+        bool is_visited_once = true;
+        for (const auto& count : counts)
+        {
+            is_visited_once = is_visited_once && count == 1;
+        }
+        Check(is_visited_once, "indices visited by ParallelFor (" + name + ")");
+
+        // The first exception is rethrown after all the calls finish
+        std::atomic<int> num_calls(0);
+        const bool       is_thrown = Throws(
+            [&]()
+            {
+                ParallelFor(executor,
+                            num_tasks,
+                            [&](const int i)
+                            {
+                                ++num_calls;
+                                if (i % 100 == 0)
+                                {
+                                    throw std::runtime_error("An error in an iteration.");
+                                }
+                            });
+            });
+        Check(is_thrown && num_calls == num_tasks, "exception from ParallelFor (" + name + ")");
+    }
+
+    void TestNestedParallelFor()
+    {
+        // Nested calls from within a task of a single worker must not deadlock, since the callers take iterations
+        ThreadPool thread_pool(1);
+
+        std::atomic<int> sum(0);
+
+        const auto add_row = [&](const int i)
+        { ParallelFor(&thread_pool, 10, [&](const int j) { sum += 10 * i + j; }); };
+
+        const ExecutorTask<int> task(thread_pool,
+                                     [&]()
+                                     {
+                                         ParallelFor(&thread_pool, 10, add_row);
+                                         return 1;
+                                     });
+
+        Check(task.Get() == 1 && sum == 4950, "nested ParallelFor");
+    }
+
+    void TestExecutorTask()
+    {
+        ThreadPool thread_pool(1);
+
+        // Block the only worker so that the following tasks are not started by it
+        std::atomic<bool> is_blocking(true);
+        thread_pool.Submit(
+            [&]()
+            {
+                while (is_blocking)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            });
+
+        // A waiting thread runs a task that no worker has started
+        const ExecutorTask<int> task(thread_pool, []() { return 42; });
+        Check(task.Get() == 42, "task run by the waiting thread");
+
+        // A cancelled task is not run and returns a default-constructed result
+        std::atomic<bool>       is_run(false);
+        const ExecutorTask<int> cancelled_task(thread_pool,
+                                               [&]()
+                                               {
+                                                   is_run = true;
+                                                   return 7;
+                                               });
+        cancelled_task.Cancel();
+        Check(cancelled_task.IsFinished() && cancelled_task.Get() == 0, "cancelled task");
+
+        // An exception is rethrown by Get
+        const ExecutorTask<int> throwing_task(thread_pool,
+                                              []() -> int { throw std::runtime_error("An error in a task."); });
+        Check(Throws([&]() { throwing_task.Get(); }), "exception from a task");
+
+        is_blocking = false;
+
+        // A task run by a worker
+        const auto future = sequential_line_search::ExecuteAsync(thread_pool, []() { return 3; });
+        Check(future.get() == 3, "asynchronous execution");
+        Check(!is_run, "cancelled task not run");
+    }
+} // namespace
+
+int main()
+{
+    TestThreadPool();
+
+    ThreadPool thread_pool(4);
+    TestParallelFor(&thread_pool, "pool");
+    TestParallelFor(nullptr, "sequential");
+    TestParallelFor(sequential_line_search::GetDefaultExecutor().get(), "default");
+
+    TestNestedParallelFor();
+    TestExecutorTask();
+
+    if (test_util::GetNumFailures() != 0)
+    {
+        return 1;
+    }
+
+    std::cout << "All executor tests passed." << std::endl;
+    return 0;
+}
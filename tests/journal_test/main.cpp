@@ -0,0 +1,126 @@
+#include "../test-util.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sequential-line-search/feedback-journal.hpp>
+#include <sequential-line-search/sequential-line-search.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using Eigen::VectorXd;
+using sequential_line_search::FeedbackJournal;
+using sequential_line_search::FeedbackRecord;
+using sequential_line_search::SequentialLineSearchOptimizer;
+using test_util::Check;
+using test_util::Throws;
+
+namespace
+{
+    constexpr int num_dims    = 3;
+    constexpr int num_records = 4;
+
+    const std::string journal_path = "journal_test.bin";
+
+    std::string ReadBytes(const std::string& file_path)
+    {
+        std::ifstream stream(file_path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+
+    void WriteBytes(const std::string& file_path, const std::string& bytes)
+    {
+        std::ofstream stream(file_path, std::ios::binary | std::ios::trunc);
+        stream.write(bytes.data(), bytes.size());
+    }
+
+    void TestRecords()
+    {
+        std::remove(journal_path.c_str());
+
+        std::vector<FeedbackRecord> records;
+        {
+            FeedbackJournal journal(journal_path);
+            for (int i = 0; i < num_records; ++i)
+            {
+                const FeedbackRecord record{VectorXd::Random(num_dims), {VectorXd::Random(num_dims)}};
+                journal.Append(record.x_preferable, record.xs_other);
+                records.push_back(record);
+            }
+        }
+
+        const auto read_records = FeedbackJournal::Read(journal_path);
+        Check(read_records.size() == num_records, "number of records");
+        for (std::size_t i = 0; i < read_records.size(); ++i)
+        {
+            Check(read_records[i].x_preferable == records[i].x_preferable, "preferable point of a record");
+            Check(read_records[i].xs_other == records[i].xs_other, "other points of a record");
+        }
+
+        // A corrupted byte in the last record is detected by the checksum, and the record is ignored
+        std::string bytes = ReadBytes(journal_path);
+        bytes[bytes.size() - 10] ^= 0x01;
+        WriteBytes(journal_path, bytes);
+        Check(FeedbackJournal::Read(journal_path).size() == num_records - 1, "corrupted record");
+
+        // A torn record is ignored as well
+        WriteBytes(journal_path, bytes.substr(0, bytes.size() - 5));
+        Check(FeedbackJournal::Read(journal_path).size() == num_records - 1, "torn record");
+
+        // Reopening the journal discards the torn record, so that the new records remain readable
+        {
+            FeedbackJournal journal(journal_path);
+            journal.Append(records[0].x_preferable, records[0].xs_other);
+        }
+        const auto reopened_records = FeedbackJournal::Read(journal_path);
+        Check(reopened_records.size() == num_records, "records after reopening");
+        Check(reopened_records.back().x_preferable == records[0].x_preferable, "record appended after reopening");
+
+        // Files other than journals are rejected
+        WriteBytes(journal_path, "not a journal");
+        Check(Throws([&]() { FeedbackJournal::Read(journal_path); }), "non-journal file");
+
+        std::remove(journal_path.c_str());
+    }
+
+    void TestReplay()
+    {
+        std::remove(journal_path.c_str());
+
+        SequentialLineSearchOptimizer optimizer(num_dims);
+        optimizer.EnableFeedbackJournal(journal_path);
+        for (int i = 0; i < num_records - 1; ++i)
+        {
+            optimizer.SubmitFeedbackData(0.2 * i + 0.1);
+        }
+
+        // An asynchronous feedback is durable once the call returns, before the update finishes
+        const auto future = optimizer.SubmitFeedbackDataAsync(0.5);
+        Check(FeedbackJournal::Read(journal_path).size() == num_records, "asynchronous feedback in the journal");
+        future.get();
+
+        optimizer.DisableFeedbackJournal();
+
+        // Replaying the journal reproduces the data
+        SequentialLineSearchOptimizer replayed_optimizer(num_dims);
+        Check(replayed_optimizer.ReplayFeedbackJournal(journal_path) == num_records, "number of replayed records");
+        Check(replayed_optimizer.GetRawDataPoints() == optimizer.GetRawDataPoints(), "replayed data");
+
+        std::remove(journal_path.c_str());
+    }
+} // namespace
+
+int main()
+{
+    TestRecords();
+    TestReplay();
+
+    if (test_util::GetNumFailures() != 0)
+    {
+        return 1;
+    }
+
+    std::cout << "All journal tests passed." << std::endl;
+    return 0;
+}
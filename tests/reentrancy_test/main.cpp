@@ -0,0 +1,165 @@
+#include "../test-util.hpp"
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <sequential-line-search/preferential-bayesian-optimizer.hpp>
+#include <sequential-line-search/sequential-line-search.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+using sequential_line_search::PreferentialBayesianOptimizer;
+using sequential_line_search::RetentionPolicy;
+using sequential_line_search::SequentialLineSearchOptimizer;
+using test_util::Check;
+
+namespace
+{
+    constexpr int num_dims       = 3;
+    constexpr int num_readers    = 6;
+    constexpr int num_iterations = 8;
+    constexpr int num_samples    = 11;
+
+    /// \brief Run the reader threads while the writer runs on the calling thread.
+    ///
+    /// \details The readers count the reads whose results are malformed (e.g., of a wrong size or not finite), which
+    /// would indicate that they saw a partially updated state.
+    template <typename Read, typename Write> void RunReadersAndWriter(const std::string& name, Read read, Write write)
+    {
+        std::atomic<bool> is_done(false);
+        std::atomic<int>  num_reads(0);
+        std::atomic<int>  num_malformed_reads(0);
+
+        std::vector<std::thread> readers;
+        for (int i = 0; i < num_readers; ++i)
+        {
+            readers.push_back(std::thread(
+                [&]()
+                {
+                    while (!is_done)
+                    {
+                        if (!read())
+                        {
+                            ++num_malformed_reads;
+                        }
+                        ++num_reads;
+                    }
+                }));
+        }
+
+        write();
+
+        is_done = true;
+        for (auto& reader : readers)
+        {
+            reader.join();
+        }
+
+        Check(num_reads > 0, "reads during updates (" + name + ")");
+        Check(num_malformed_reads == 0, "consistency of reads (" + name + ")");
+    }
+
+    void TestSequentialLineSearch()
+    {
+        SequentialLineSearchOptimizer optimizer(num_dims);
+        optimizer.SetSpeculativeSliderComputation(true, 2);
+
+        const auto read = [&]()
+        {
+            const auto ends = optimizer.GetSliderEnds();
+
+            const double value = optimizer.GetPreferenceValueMean(ends.first) +
+                                 optimizer.GetPreferenceValueStdev(ends.second) +
+                                 optimizer.GetAcquisitionFuncValue(ends.second);
+
+            VectorXd       mu;
+            VectorXd       sigma;
+            const MatrixXd samples = optimizer.SampleSlider(num_samples, &mu, &sigma);
+
+            const MatrixXd X = optimizer.GetRawDataPoints();
+
+            return ends.first.size() == num_dims && ends.second.size() == num_dims && std::isfinite(value) &&
+                   samples.rows() == num_dims && samples.cols() == num_samples && mu.size() == num_samples &&
+                   sigma.size() == num_samples && (X.cols() == 0 || X.rows() == num_dims) &&
+                   optimizer.GetMaximizer().size() == num_dims;
+        };
+
+        const auto write = [&]()
+        {
+            // Synchronous updates (some of which adopt speculations) and asynchronous ones
+            for (int i = 0; i < num_iterations; ++i)
+            {
+                if (i % 2 == 0)
+                {
+                    optimizer.SubmitFeedbackData(0.7);
+                }
+                else
+                {
+                    optimizer.SubmitFeedbackDataAsync(0.3).wait();
+                }
+            }
+
+            // Updates of the data alone and batch updates
+            optimizer.SetDataRetentionPolicy(RetentionPolicy::SlidingWindow, 10);
+            optimizer.GenerateSliderBatch(2);
+            optimizer.SubmitBatchFeedbackData(0, 0.5);
+            optimizer.SubmitBatchFeedbackData(1, 0.5);
+            optimizer.GenerateSliderBatch(2);
+        };
+
+        RunReadersAndWriter("sequential line search", read, write);
+    }
+
+    void TestPreferentialBayesianOptimizer()
+    {
+        PreferentialBayesianOptimizer optimizer(num_dims);
+
+        const auto read = [&]()
+        {
+            const auto options = optimizer.GetCurrentOptions();
+
+            const double value = optimizer.GetPreferenceValueMean(options[0]) +
+                                 optimizer.GetPreferenceValueStdev(options[1]) +
+                                 optimizer.GetAcquisitionFuncValue(options[1]);
+
+            return options.size() == 2 && options[0].size() == num_dims && std::isfinite(value) &&
+                   optimizer.GetMaximizer().size() == num_dims;
+        };
+
+        const auto write = [&]()
+        {
+            for (int i = 0; i < num_iterations; ++i)
+            {
+                if (i % 2 == 0)
+                {
+                    optimizer.SubmitFeedbackData(1);
+                    optimizer.DetermineNextQuery();
+                }
+                else
+                {
+                    optimizer.SubmitFeedbackDataAsync(0).wait();
+                }
+            }
+
+            optimizer.SetDataRetentionPolicy(RetentionPolicy::SlidingWindow, 10);
+        };
+
+        RunReadersAndWriter("preferential Bayesian optimization", read, write);
+    }
+} // namespace
+
+int main()
+{
+    TestSequentialLineSearch();
+    TestPreferentialBayesianOptimizer();
+
+    if (test_util::GetNumFailures() != 0)
+    {
+        return 1;
+    }
+
+    std::cout << "All reentrancy tests passed." << std::endl;
+    return 0;
+}
@@ -0,0 +1,240 @@
+#include "../test-util.hpp"
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sequential-line-search/sequential-line-search.hpp>
+#include <sequential-line-search/session-manager.hpp>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using Eigen::VectorXd;
+using sequential_line_search::SequentialLineSearchOptimizer;
+using sequential_line_search::SessionId;
+using sequential_line_search::SessionManager;
+using test_util::Check;
+using test_util::Throws;
+
+namespace
+{
+    constexpr int num_dims     = 2;
+    constexpr int num_sessions = 5;
+
+    // The snapshot files of the evicted sessions are written to the working directory
+    const std::string eviction_directory_path = ".";
+
+    bool Exists(const std::string& file_path) { return std::ifstream(file_path).good(); }
+
+    std::shared_ptr<SequentialLineSearchOptimizer> CreateOptimizer()
+    {
+        return std::make_shared<SequentialLineSearchOptimizer>(num_dims);
+    }
+
+    std::string GetSnapshotPath(const SessionId session_id)
+    {
+        return eviction_directory_path + "/session-" + std::to_string(session_id) + ".bin";
+    }
+
+    void TestEvictionAndRestoration()
+    {
+        SessionManager session_manager(2, 0, 2, eviction_directory_path);
+
+        std::vector<SessionId> session_ids;
+        for (int i = 0; i < num_sessions; ++i)
+        {
+            session_ids.push_back(session_manager.AddSession(CreateOptimizer()));
+        }
+        Check(session_manager.GetNumResidentSessions() == 2, "resident limit after adding");
+
+        std::vector<std::shared_future<void>> futures;
+        for (int k = 0; k < 2; ++k)
+        {
+            for (const SessionId session_id : session_ids)
+            {
+                futures.push_back(session_manager.SubmitFeedbackData(session_id, 0.2 + 0.3 * k));
+            }
+        }
+        session_manager.WaitForAllJobs();
+        for (const auto& future : futures)
+        {
+            future.get();
+        }
+        Check(session_manager.GetNumResidentSessions() <= 2, "resident limit after jobs");
+
+        // Each access restores the session (and evicts another one)
+        std::vector<std::pair<VectorXd, VectorXd>> slider_ends;
+        for (const SessionId session_id : session_ids)
+        {
+            const auto optimizer = session_manager.GetOptimizer(session_id);
+            Check(optimizer->GetRawDataPoints().cols() == 5, "data of a restored session");
+            slider_ends.push_back(optimizer->GetSliderEnds());
+        }
+
+        const int num_resident_sessions = session_manager.GetNumResidentSessions();
+        Check(session_manager.EvictIdleSessions(std::chrono::seconds(0)) == num_resident_sessions, "idle eviction");
+        Check(session_manager.GetNumResidentSessions() == 0, "no resident session");
+        for (const SessionId session_id : session_ids)
+        {
+            Check(Exists(GetSnapshotPath(session_id)), "snapshot file of an evicted session");
+        }
+
+        for (int i = 0; i < num_sessions; ++i)
+        {
+            const auto optimizer = session_manager.GetOptimizer(session_ids[i]);
+            Check(optimizer->GetSliderEnds() == slider_ends[i], "slider of a restored session");
+        }
+
+        // Removing a session deletes its snapshot file
+        session_manager.EvictIdleSessions(std::chrono::seconds(0));
+        session_manager.RemoveSession(session_ids[0]);
+        Check(!Exists(GetSnapshotPath(session_ids[0])), "snapshot file of a removed session");
+        Check(session_manager.GetNumSessions() == num_sessions - 1, "number of sessions after removal");
+
+        Check(Throws([&]() { session_manager.GetOptimizer(session_ids[0]); }), "access to a removed session");
+
+        for (std::size_t i = 1; i < session_ids.size(); ++i)
+        {
+            session_manager.RemoveSession(session_ids[i]);
+            Check(!Exists(GetSnapshotPath(session_ids[i])), "snapshot file of a removed session");
+        }
+    }
+
+    void TestFailedEviction()
+    {
+        // The snapshot files cannot be written, so the sessions should stay resident without being lost
+        SessionManager session_manager(2, 0, 1, "nonexistent-directory");
+
+        const SessionId session_id_0 = session_manager.AddSession(CreateOptimizer());
+        const SessionId session_id_1 = session_manager.AddSession(CreateOptimizer());
+        Check(session_manager.GetNumResidentSessions() == 2, "sessions kept resident");
+
+        session_manager.SubmitFeedbackData(session_id_0, 0.5).get();
+        session_manager.SubmitFeedbackData(session_id_1, 0.5).get();
+        session_manager.WaitForAllJobs();
+
+        Check(session_manager.EvictIdleSessions(std::chrono::seconds(0)) == 0, "failed eviction");
+        Check(session_manager.GetOptimizer(session_id_0)->GetRawDataPoints().cols() == 3, "data of a kept session");
+        Check(session_manager.GetOptimizer(session_id_1)->GetRawDataPoints().cols() == 3, "data of a kept session");
+    }
+
+    void TestThrowingCallback()
+    {
+        // An exception thrown by the callback should not terminate the worker
+        SessionManager session_manager(1);
+
+        const SessionId session_id = session_manager.AddSession(CreateOptimizer());
+
+        session_manager.SubmitFeedbackData(
+            session_id,
+            0.5,
+            SessionManager::Clock::time_point::max(),
+            [](const std::shared_future<void>&) { throw std::runtime_error("An error in the callback."); });
+        session_manager.SubmitFeedbackData(session_id, 0.5).get();
+
+        Check(session_manager.GetOptimizer(session_id)->GetRawDataPoints().cols() == 5, "jobs after a callback");
+    }
+
+    void TestConcurrentAccess()
+    {
+        // Sessions are evicted and restored continually while several threads submit feedbacks
+        constexpr int num_threads    = 4;
+        constexpr int num_iterations = 3;
+
+        SessionManager session_manager(2, 0, 1, eviction_directory_path);
+
+        std::vector<SessionId> session_ids;
+        for (int i = 0; i < num_threads; ++i)
+        {
+            session_ids.push_back(session_manager.AddSession(CreateOptimizer()));
+        }
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < num_threads; ++i)
+        {
+            threads.push_back(std::thread(
+                [&, i]()
+                {
+                    for (int k = 0; k < num_iterations; ++k)
+                    {
+                        session_manager.SubmitFeedbackData(session_ids[i], 0.5).get();
+                        session_manager.GetOptimizer(session_ids[(i + 1) % num_threads])->GetSliderEnds();
+                        session_manager.EvictIdleSessions(std::chrono::seconds(0));
+                    }
+                }));
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        for (const SessionId session_id : session_ids)
+        {
+            const int num_data_points = session_manager.GetOptimizer(session_id)->GetRawDataPoints().cols();
+            Check(num_data_points == 2 * num_iterations + 1, "data after concurrent access");
+            session_manager.RemoveSession(session_id);
+        }
+    }
+
+    void TestDispatchOrder()
+    {
+        // With a single worker, the jobs queued while the first one runs are dispatched one by one
+        SessionManager session_manager(1);
+
+        std::vector<SessionId> session_ids;
+        for (int i = 0; i < num_sessions; ++i)
+        {
+            session_ids.push_back(session_manager.AddSession(CreateOptimizer()));
+        }
+
+        std::mutex             order_mutex;
+        std::vector<SessionId> order;
+        const auto             record = [&](const SessionId session_id)
+        {
+            return [&, session_id](const std::shared_future<void>&)
+            {
+                std::lock_guard<std::mutex> lock(order_mutex);
+                order.push_back(session_id);
+            };
+        };
+
+        const auto now = SessionManager::Clock::now();
+        const auto far = SessionManager::Clock::time_point::max();
+
+        session_manager.SubmitFeedbackData(session_ids[0], 0.5, far, record(session_ids[0]));
+        session_manager.SubmitFeedbackData(session_ids[1], 0.5, far, record(session_ids[1]));
+        session_manager.SubmitFeedbackData(session_ids[2], 0.5, far, record(session_ids[2]));
+        session_manager.SubmitFeedbackData(session_ids[3], 0.5, now, record(session_ids[3]));
+        session_manager.SubmitFeedbackData(session_ids[4], 0.5, far, record(session_ids[4]));
+
+        // A ready session is reordered when its priority changes
+        session_manager.SetSessionPriority(session_ids[4], 2);
+        session_manager.SetSessionPriority(session_ids[2], 1);
+
+        session_manager.WaitForAllJobs();
+
+        const std::vector<SessionId> expected_order = {
+            session_ids[0], session_ids[3], session_ids[4], session_ids[2], session_ids[1]};
+        Check(order == expected_order, "order of dispatched jobs");
+    }
+} // namespace
+
+int main()
+{
+    TestEvictionAndRestoration();
+    TestFailedEviction();
+    TestThrowingCallback();
+    TestConcurrentAccess();
+    TestDispatchOrder();
+
+    if (test_util::GetNumFailures() != 0)
+    {
+        return 1;
+    }
+
+    std::cout << "All session manager tests passed." << std::endl;
+    return 0;
+}
@@ -0,0 +1,160 @@
+#include "../test-util.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <sequential-line-search/binary-io.hpp>
+#include <sequential-line-search/preferential-bayesian-optimizer.hpp>
+#include <sequential-line-search/sequential-line-search.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using Eigen::VectorXd;
+using sequential_line_search::PreferentialBayesianOptimizer;
+using sequential_line_search::SequentialLineSearchOptimizer;
+using test_util::Check;
+using test_util::Throws;
+
+namespace
+{
+    constexpr int num_dims       = 3;
+    constexpr int num_iterations = 4;
+
+    /// \brief Load a snapshot whose bytes are modified by the given function.
+    bool IsRejected(const std::string& bytes, const std::function<void(std::string&)>& corrupt)
+    {
+        std::string corrupted_bytes = bytes;
+        corrupt(corrupted_bytes);
+
+        std::istringstream stream(corrupted_bytes);
+        return Throws([&]() { SequentialLineSearchOptimizer::Load(stream); });
+    }
+
+    void TestSequentialLineSearchRoundTrip()
+    {
+        SequentialLineSearchOptimizer optimizer(num_dims);
+        optimizer.SetTrustRegionAcquisitionSearch(true);
+        optimizer.SetWarmStartAcquisitionSearch(true);
+        for (int i = 0; i < num_iterations; ++i)
+        {
+            optimizer.SubmitFeedbackData(0.2 * i + 0.1, 10, 5, 5);
+        }
+
+        std::stringstream stream;
+        optimizer.Save(stream);
+        const auto loaded_optimizer = SequentialLineSearchOptimizer::Load(stream);
+
+        // The values are stored as their raw bits, so they should be restored exactly
+        const VectorXd x = VectorXd::Constant(num_dims, 0.3);
+        Check(optimizer.GetPreferenceValueMean(x) == loaded_optimizer->GetPreferenceValueMean(x), "mean");
+        Check(optimizer.GetPreferenceValueStdev(x) == loaded_optimizer->GetPreferenceValueStdev(x), "stdev");
+        Check(optimizer.GetSliderEnds() == loaded_optimizer->GetSliderEnds(), "slider ends");
+        Check(optimizer.GetMaximizer() == loaded_optimizer->GetMaximizer(), "maximizer");
+        Check(optimizer.GetRawDataPoints() == loaded_optimizer->GetRawDataPoints(), "data points");
+
+        // The loaded optimizer should continue the optimization in the same way as the original one
+        std::srand(0);
+        optimizer.SubmitFeedbackData(0.5, 10, 5, 5);
+        std::srand(0);
+        loaded_optimizer->SubmitFeedbackData(0.5, 10, 5, 5);
+        Check(optimizer.GetSliderEnds() == loaded_optimizer->GetSliderEnds(), "continued optimization");
+
+        // Round trip through a file
+        const std::string file_path = "snapshot_test.bin";
+        optimizer.Save(file_path);
+        const auto file_optimizer = SequentialLineSearchOptimizer::Load(file_path);
+        Check(optimizer.GetSliderEnds() == file_optimizer->GetSliderEnds(), "slider ends (file)");
+        std::remove(file_path.c_str());
+    }
+
+    void TestPreferentialBayesianOptimizerRoundTrip()
+    {
+        PreferentialBayesianOptimizer optimizer(num_dims);
+        for (int i = 0; i < num_iterations; ++i)
+        {
+            optimizer.SubmitFeedbackData(i % 2, 10);
+            optimizer.DetermineNextQuery(5, 5);
+        }
+
+        std::stringstream stream;
+        optimizer.Save(stream);
+        const auto loaded_optimizer = PreferentialBayesianOptimizer::Load(stream);
+
+        const VectorXd x = VectorXd::Constant(num_dims, 0.3);
+        Check(optimizer.GetPreferenceValueMean(x) == loaded_optimizer->GetPreferenceValueMean(x), "PBO mean");
+        Check(optimizer.GetCurrentOptions() == loaded_optimizer->GetCurrentOptions(), "PBO options");
+        Check(optimizer.GetRawDataPoints() == loaded_optimizer->GetRawDataPoints(), "PBO data points");
+    }
+
+    void TestCorruptedSnapshots()
+    {
+        SequentialLineSearchOptimizer optimizer(num_dims);
+        optimizer.SubmitFeedbackData(0.5, 10, 5, 5);
+
+        std::stringstream stream;
+        optimizer.Save(stream);
+        const std::string bytes = stream.str();
+
+        // Layout: magic (4), version (4), num_dims (4), two bools (2), current best selection strategy (4), ...
+        Check(IsRejected(bytes, [](std::string& b) { b[0] = 'X'; }), "wrong magic");
+        Check(IsRejected(bytes, [](std::string& b) { b.resize(b.size() / 2); }), "truncated snapshot");
+        Check(IsRejected(bytes, [](std::string& b) { b[8] = b[9] = b[10] = b[11] = 0; }), "zero dimensions");
+        Check(IsRejected(bytes, [](std::string& b) { b[14] = 0x7f; }), "enum out of range");
+    }
+
+    void TestHugeSizes()
+    {
+        namespace binary_io = sequential_line_search::binary_io;
+
+        // A matrix of (2^31 - 1) x (2^31 - 1) would be allocated before reading the elements if it were not checked
+        std::stringstream matrix_stream;
+        binary_io::WriteUInt64(matrix_stream, 0x7fffffff);
+        binary_io::WriteUInt64(matrix_stream, 0x7fffffff);
+        binary_io::WriteDouble(matrix_stream, 0.0);
+        Check(Throws([&]() { binary_io::ReadMatrix(matrix_stream); }), "huge matrix");
+
+        std::stringstream vector_stream;
+        binary_io::WriteUInt64(vector_stream, 1000);
+        binary_io::WriteDouble(vector_stream, 0.0);
+        Check(Throws([&]() { binary_io::ReadVector(vector_stream); }), "vector longer than the stream");
+
+        std::stringstream preferences_stream;
+        binary_io::WriteUInt64(preferences_stream, 0x7fffffff);
+        Check(Throws([&]() { binary_io::ReadPreferences(preferences_stream); }), "huge preferences");
+
+        // A size that fits in the stream is accepted
+        const Eigen::MatrixXd matrix = Eigen::MatrixXd::Random(3, 4);
+        std::stringstream     valid_stream;
+        binary_io::WriteMatrix(valid_stream, matrix);
+        Check(binary_io::ReadMatrix(valid_stream) == matrix, "matrix round trip");
+    }
+
+    void TestFailedWrite()
+    {
+        SequentialLineSearchOptimizer optimizer(num_dims);
+
+        Check(Throws([&]() { optimizer.Save("nonexistent-directory/snapshot.bin"); }), "unopenable file");
+#ifdef __linux__
+        // Writing to /dev/full always fails with ENOSPC
+        Check(Throws([&]() { optimizer.Save("/dev/full"); }), "failed write");
+#endif
+    }
+} // namespace
+
+int main()
+{
+    TestSequentialLineSearchRoundTrip();
+    TestPreferentialBayesianOptimizerRoundTrip();
+    TestCorruptedSnapshots();
+    TestHugeSizes();
+    TestFailedWrite();
+
+    if (test_util::GetNumFailures() != 0)
+    {
+        return 1;
+    }
+
+    std::cout << "All snapshot tests passed." << std::endl;
+    return 0;
+}
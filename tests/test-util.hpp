@@ -0,0 +1,49 @@
+#ifndef SEQUENTIAL_LINE_SEARCH_TEST_UTIL_HPP
+#define SEQUENTIAL_LINE_SEARCH_TEST_UTIL_HPP
+
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+/// \brief Minimal checking utilities shared by the tests.
+///
+/// \details A failed check is reported to the standard error and counted instead of aborting the test, so that all the
+/// failures of a run are reported. The main function of a test returns non-zero if `GetNumFailures` is non-zero.
+namespace test_util
+{
+    inline std::atomic<int>& GetNumFailuresCounter()
+    {
+        static std::atomic<int> num_failures(0);
+        return num_failures;
+    }
+
+    /// \brief Get the number of failed checks so far.
+    inline int GetNumFailures() { return GetNumFailuresCounter(); }
+
+    /// \brief Report and count a failure if the condition does not hold. Can be called from multiple threads.
+    inline void Check(const bool condition, const std::string& message)
+    {
+        if (!condition)
+        {
+            std::cerr << "FAILED: " << message << std::endl;
+            ++GetNumFailuresCounter();
+        }
+    }
+
+    /// \brief Return whether the function throws an exception of the given type.
+    template <typename Exception = std::runtime_error, typename Function> bool Throws(Function function)
+    {
+        try
+        {
+            function();
+        }
+        catch (const Exception&)
+        {
+            return true;
+        }
+        return false;
+    }
+} // namespace test_util
+
+#endif // SEQUENTIAL_LINE_SEARCH_TEST_UTIL_HPP
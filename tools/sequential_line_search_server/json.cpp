@@ -0,0 +1,537 @@
+#include "json.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace
+{
+    class Parser
+    {
+    public:
+        explicit Parser(const std::string& text) : m_text(text), m_position(0), m_depth(0) {}
+
+        json::Value ParseDocument()
+        {
+            const json::Value value = ParseValue();
+
+            SkipWhitespace();
+            if (m_position != m_text.size())
+            {
+                Fail("unexpected trailing characters");
+            }
+            return value;
+        }
+
+    private:
+        /// \brief The limit of nesting, which bounds the recursion for untrusted input.
+        static constexpr int max_depth = 64;
+
+        const std::string& m_text;
+        std::size_t        m_position;
+        int                m_depth;
+
+        [[noreturn]] void Fail(const std::string& message) const
+        {
+            throw std::runtime_error("Invalid JSON (" + message + " at " + std::to_string(m_position) + ").");
+        }
+
+        void SkipWhitespace()
+        {
+            while (m_position < m_text.size() && (m_text[m_position] == ' ' || m_text[m_position] == '\t' ||
+                                                  m_text[m_position] == '\n' || m_text[m_position] == '\r'))
+            {
+                ++m_position;
+            }
+        }
+
+        char Peek()
+        {
+            SkipWhitespace();
+            if (m_position >= m_text.size())
+            {
+                Fail("unexpected end");
+            }
+            return m_text[m_position];
+        }
+
+        void Expect(const char character)
+        {
+            if (Peek() != character)
+            {
+                Fail(std::string("expected '") + character + "'");
+            }
+            ++m_position;
+        }
+
+        void ExpectLiteral(const std::string& literal)
+        {
+            if (m_text.compare(m_position, literal.size(), literal) != 0)
+            {
+                Fail("invalid literal");
+            }
+            m_position += literal.size();
+        }
+
+        json::Value ParseValue()
+        {
+            switch (Peek())
+            {
+                case '{':
+                    return ParseObject();
+                case '[':
+                    return ParseArray();
+                case '"':
+                    return json::Value(ParseString());
+                case 't':
+                    ExpectLiteral("true");
+                    return json::Value(true);
+                case 'f':
+                    ExpectLiteral("false");
+                    return json::Value(false);
+                case 'n':
+                    ExpectLiteral("null");
+                    return json::Value();
+                default:
+                    return json::Value(ParseNumber());
+            }
+        }
+
+        json::Value ParseObject()
+        {
+            json::Value object = json::Value::MakeObject();
+
+            Expect('{');
+            if (Peek() == '}')
+            {
+                ++m_position;
+                return object;
+            }
+            if (++m_depth > max_depth)
+            {
+                Fail("too deep nesting");
+            }
+            while (true)
+            {
+                if (Peek() != '"')
+                {
+                    Fail("expected a key");
+                }
+                const std::string key = ParseString();
+
+                Expect(':');
+                object.SetMember(key, ParseValue());
+
+                if (Peek() == ',')
+                {
+                    ++m_position;
+                    continue;
+                }
+                Expect('}');
+                --m_depth;
+                return object;
+            }
+        }
+
+        json::Value ParseArray()
+        {
+            json::Value array = json::Value::MakeArray();
+
+            Expect('[');
+            if (Peek() == ']')
+            {
+                ++m_position;
+                return array;
+            }
+            if (++m_depth > max_depth)
+            {
+                Fail("too deep nesting");
+            }
+            while (true)
+            {
+                array.PushBack(ParseValue());
+
+                if (Peek() == ',')
+                {
+                    ++m_position;
+                    continue;
+                }
+                Expect(']');
+                --m_depth;
+                return array;
+            }
+        }
+
+        double ParseNumber()
+        {
+            const char* begin = m_text.c_str() + m_position;
+            char*       end   = nullptr;
+
+            const double value = std::strtod(begin, &end);
+            if (end == begin)
+            {
+                Fail("invalid value");
+            }
+            m_position += end - begin;
+            return value;
+        }
+
+        unsigned ParseHex4()
+        {
+            if (m_position + 4 > m_text.size())
+            {
+                Fail("invalid escape");
+            }
+
+            unsigned code = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                const char c = m_text[m_position++];
+                code <<= 4;
+                if (c >= '0' && c <= '9')
+                {
+                    code |= c - '0';
+                }
+                else if (c >= 'a' && c <= 'f')
+                {
+                    code |= c - 'a' + 10;
+                }
+                else if (c >= 'A' && c <= 'F')
+                {
+                    code |= c - 'A' + 10;
+                }
+                else
+                {
+                    Fail("invalid escape");
+                }
+            }
+            return code;
+        }
+
+        void AppendUtf8(const unsigned code, std::string* output)
+        {
+            if (code < 0x80)
+            {
+                output->push_back(static_cast<char>(code));
+            }
+            else if (code < 0x800)
+            {
+                output->push_back(static_cast<char>(0xc0 | (code >> 6)));
+                output->push_back(static_cast<char>(0x80 | (code & 0x3f)));
+            }
+            else if (code < 0x10000)
+            {
+                output->push_back(static_cast<char>(0xe0 | (code >> 12)));
+                output->push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+                output->push_back(static_cast<char>(0x80 | (code & 0x3f)));
+            }
+            else
+            {
+                output->push_back(static_cast<char>(0xf0 | (code >> 18)));
+                output->push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3f)));
+                output->push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+                output->push_back(static_cast<char>(0x80 | (code & 0x3f)));
+            }
+        }
+
+        std::string ParseString()
+        {
+            Expect('"');
+
+            std::string output;
+            while (true)
+            {
+                if (m_position >= m_text.size())
+                {
+                    Fail("unterminated string");
+                }
+
+                const char c = m_text[m_position++];
+                if (c == '"')
+                {
+                    return output;
+                }
+                if (c != '\\')
+                {
+                    output.push_back(c);
+                    continue;
+                }
+
+                if (m_position >= m_text.size())
+                {
+                    Fail("unterminated string");
+                }
+                switch (m_text[m_position++])
+                {
+                    case '"':
+                        output.push_back('"');
+                        break;
+                    case '\\':
+                        output.push_back('\\');
+                        break;
+                    case '/':
+                        output.push_back('/');
+                        break;
+                    case 'b':
+                        output.push_back('\b');
+                        break;
+                    case 'f':
+                        output.push_back('\f');
+                        break;
+                    case 'n':
+                        output.push_back('\n');
+                        break;
+                    case 'r':
+                        output.push_back('\r');
+                        break;
+                    case 't':
+                        output.push_back('\t');
+                        break;
+                    case 'u':
+                    {
+                        unsigned code = ParseHex4();
+
+                        // Combine a surrogate pair
+                        if (code >= 0xd800 && code < 0xdc00 && m_text.compare(m_position, 2, "\\u") == 0)
+                        {
+                            m_position += 2;
+
+                            const unsigned low = ParseHex4();
+                            code               = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                        }
+                        AppendUtf8(code, &output);
+                        break;
+                    }
+                    default:
+                        Fail("invalid escape");
+                }
+            }
+        }
+    };
+
+    void SerializeString(const std::string& value, std::string* output)
+    {
+        output->push_back('"');
+        for (const char c : value)
+        {
+            switch (c)
+            {
+                case '"':
+                    output->append("\\\"");
+                    break;
+                case '\\':
+                    output->append("\\\\");
+                    break;
+                case '\n':
+                    output->append("\\n");
+                    break;
+                case '\r':
+                    output->append("\\r");
+                    break;
+                case '\t':
+                    output->append("\\t");
+                    break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20)
+                    {
+                        char buffer[8];
+                        std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>(c));
+                        output->append(buffer);
+                    }
+                    else
+                    {
+                        output->push_back(c);
+                    }
+            }
+        }
+        output->push_back('"');
+    }
+} // namespace
+
+json::Value json::Value::MakeArray()
+{
+    Value value;
+    value.m_type = Type::Array;
+    return value;
+}
+
+json::Value json::Value::MakeObject()
+{
+    Value value;
+    value.m_type = Type::Object;
+    return value;
+}
+
+json::Value json::Value::MakeArray(const Eigen::VectorXd& vector)
+{
+    Value value = MakeArray();
+    for (int i = 0; i < vector.size(); ++i)
+    {
+        value.PushBack(vector(i));
+    }
+    return value;
+}
+
+bool json::Value::GetBool() const
+{
+    if (m_type != Type::Bool)
+    {
+        throw std::runtime_error("A boolean is expected.");
+    }
+    return m_bool;
+}
+
+double json::Value::GetNumber() const
+{
+    if (m_type != Type::Number)
+    {
+        throw std::runtime_error("A number is expected.");
+    }
+    return m_number;
+}
+
+const std::string& json::Value::GetString() const
+{
+    if (m_type != Type::String)
+    {
+        throw std::runtime_error("A string is expected.");
+    }
+    return m_string;
+}
+
+const std::vector<json::Value>& json::Value::GetArray() const
+{
+    if (m_type != Type::Array)
+    {
+        throw std::runtime_error("An array is expected.");
+    }
+    return m_array;
+}
+
+Eigen::VectorXd json::Value::GetVector() const
+{
+    const std::vector<Value>& array = GetArray();
+
+    Eigen::VectorXd vector(array.size());
+    for (std::size_t i = 0; i < array.size(); ++i)
+    {
+        vector(i) = array[i].GetNumber();
+    }
+    return vector;
+}
+
+bool json::Value::HasMember(const std::string& key) const
+{
+    for (const auto& member : m_object)
+    {
+        if (member.first == key)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+const json::Value& json::Value::GetMember(const std::string& key) const
+{
+    if (m_type != Type::Object)
+    {
+        throw std::runtime_error("An object is expected.");
+    }
+    for (const auto& member : m_object)
+    {
+        if (member.first == key)
+        {
+            return member.second;
+        }
+    }
+    throw std::runtime_error("Missing member: " + key + ".");
+}
+
+void json::Value::SetMember(const std::string& key, const Value& value)
+{
+    for (auto& member : m_object)
+    {
+        if (member.first == key)
+        {
+            member.second = value;
+            return;
+        }
+    }
+    m_object.push_back(std::make_pair(key, value));
+}
+
+void json::Value::PushBack(const Value& value) { m_array.push_back(value); }
+
+std::string json::Value::Serialize() const
+{
+    std::string output;
+    Serialize(&output);
+    return output;
+}
+
+void json::Value::Serialize(std::string* output) const
+{
+    switch (m_type)
+    {
+        case Type::Null:
+            output->append("null");
+            break;
+        case Type::Bool:
+            output->append(m_bool ? "true" : "false");
+            break;
+        case Type::Number:
+        {
+            // JSON has no representation of non-finite numbers
+            if (!std::isfinite(m_number))
+            {
+                output->append("null");
+                break;
+            }
+
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%.17g", m_number);
+            output->append(buffer);
+            break;
+        }
+        case Type::String:
+            SerializeString(m_string, output);
+            break;
+        case Type::Array:
+        {
+            output->push_back('[');
+            for (std::size_t i = 0; i < m_array.size(); ++i)
+            {
+                if (i != 0)
+                {
+                    output->push_back(',');
+                }
+                m_array[i].Serialize(output);
+            }
+            output->push_back(']');
+            break;
+        }
+        case Type::Object:
+        {
+            output->push_back('{');
+            for (std::size_t i = 0; i < m_object.size(); ++i)
+            {
+                if (i != 0)
+                {
+                    output->push_back(',');
+                }
+                SerializeString(m_object[i].first, output);
+                output->push_back(':');
+                m_object[i].second.Serialize(output);
+            }
+            output->push_back('}');
+            break;
+        }
+    }
+}
+
+json::Value json::Value::Parse(const std::string& text)
+{
+    Parser parser(text);
+    return parser.ParseDocument();
+}
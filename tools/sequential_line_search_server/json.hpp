@@ -0,0 +1,82 @@
+#ifndef JSON_HPP
+#define JSON_HPP
+
+#include <Eigen/Core>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace json
+{
+    /// \brief A minimal JSON value, sufficient for the line-delimited protocol of the server.
+    ///
+    /// \details Object members are kept in the insertion order. Numbers are stored as doubles and serialized with 17
+    /// significant digits, so that doubles survive a round trip exactly.
+    class Value
+    {
+    public:
+        enum class Type
+        {
+            Null,
+            Bool,
+            Number,
+            String,
+            Array,
+            Object,
+        };
+
+        Value() : m_type(Type::Null), m_bool(false), m_number(0.0) {}
+        Value(const bool value) : m_type(Type::Bool), m_bool(value), m_number(0.0) {}
+        Value(const double value) : m_type(Type::Number), m_bool(false), m_number(value) {}
+        Value(const int value) : m_type(Type::Number), m_bool(false), m_number(value) {}
+        Value(const std::string& value) : m_type(Type::String), m_bool(false), m_number(0.0), m_string(value) {}
+        Value(const char* value) : m_type(Type::String), m_bool(false), m_number(0.0), m_string(value) {}
+
+        static Value MakeArray();
+        static Value MakeObject();
+
+        /// \brief Make an array of numbers.
+        static Value MakeArray(const Eigen::VectorXd& vector);
+
+        Type GetType() const { return m_type; }
+
+        /// \brief Throw `std::runtime_error` if the value is not of the expected type.
+        bool                      GetBool() const;
+        double                    GetNumber() const;
+        const std::string&        GetString() const;
+        const std::vector<Value>& GetArray() const;
+
+        /// \brief Get an array of numbers as a vector.
+        Eigen::VectorXd GetVector() const;
+
+        bool HasMember(const std::string& key) const;
+
+        /// \brief Get a member of an object. Throws `std::runtime_error` if it does not exist.
+        const Value& GetMember(const std::string& key) const;
+
+        /// \brief Add (or overwrite) a member of an object.
+        void SetMember(const std::string& key, const Value& value);
+
+        /// \brief Append an element to an array.
+        void PushBack(const Value& value);
+
+        /// \brief Serialize the value into a single line.
+        std::string Serialize() const;
+
+        /// \brief Parse a JSON text. Throws `std::runtime_error` if it is malformed.
+        static Value Parse(const std::string& text);
+
+    private:
+        Type m_type;
+
+        bool                                       m_bool;
+        double                                     m_number;
+        std::string                                m_string;
+        std::vector<Value>                         m_array;
+        std::vector<std::pair<std::string, Value>> m_object;
+
+        void Serialize(std::string* output) const;
+    };
+} // namespace json
+
+#endif // JSON_HPP
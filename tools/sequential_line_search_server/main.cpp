@@ -0,0 +1,227 @@
+#include "json.hpp"
+#include "request-handler.hpp"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sequential-line-search/session-manager.hpp>
+#include <sequential-line-search/thread-pool.hpp>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+using sequential_line_search::SessionManager;
+using sequential_line_search::ThreadPool;
+
+namespace
+{
+    /// \brief The maximum number of connections served at the same time; further clients are refused.
+    constexpr int max_num_connections = 64;
+
+    /// \brief The maximum length of a request line in bytes; a client exceeding it is disconnected.
+    constexpr std::size_t max_line_length = 1 << 20;
+
+    /// \brief The path of the socket file, which is removed when the server is terminated by a signal.
+    char socket_path_to_remove[sizeof(sockaddr_un::sun_path)];
+
+    void HandleTerminationSignal(const int signal)
+    {
+        // Only async-signal-safe functions can be called here
+        unlink(socket_path_to_remove);
+        _exit(128 + signal);
+    }
+
+    /// \brief A client connection. The socket is closed when the last reference (held by the reader thread or by
+    /// pending responses) is released.
+    struct Connection
+    {
+        int        fd;
+        std::mutex write_mutex;
+
+        explicit Connection(const int fd) : fd(fd) {}
+        ~Connection() { close(fd); }
+    };
+
+    void WriteLine(Connection& connection, const std::string& line)
+    {
+        const std::string message = line + '\n';
+
+        // Responses of pipelined requests are written from different threads, so lines must not interleave
+        std::lock_guard<std::mutex> lock(connection.write_mutex);
+
+        std::size_t num_sent_bytes = 0;
+        while (num_sent_bytes < message.size())
+        {
+            const ssize_t result =
+                send(connection.fd, message.data() + num_sent_bytes, message.size() - num_sent_bytes, MSG_NOSIGNAL);
+            if (result <= 0)
+            {
+                // The client has gone; the response is dropped
+                return;
+            }
+            num_sent_bytes += static_cast<std::size_t>(result);
+        }
+    }
+
+    /// \brief Write an error response that does not belong to any request.
+    void WriteError(Connection& connection, const std::string& message)
+    {
+        json::Value response = json::Value::MakeObject();
+        response.SetMember("id", json::Value());
+        response.SetMember("error", message);
+        WriteLine(connection, response.Serialize());
+    }
+
+    void ServeConnection(const std::shared_ptr<Connection>& connection, RequestHandler& handler)
+    {
+        const auto reply = [connection](const std::string& line) { WriteLine(*connection, line); };
+
+        std::string buffer;
+        char        chunk[4096];
+        while (true)
+        {
+            const ssize_t num_read_bytes = recv(connection->fd, chunk, sizeof(chunk), 0);
+            if (num_read_bytes <= 0)
+            {
+                return;
+            }
+            buffer.append(chunk, static_cast<std::size_t>(num_read_bytes));
+
+            // Requests are dispatched without waiting for the previous responses (i.e., pipelining)
+            std::size_t line_begin = 0;
+            std::size_t line_end;
+            while ((line_end = buffer.find('\n', line_begin)) != std::string::npos)
+            {
+                const std::string line = buffer.substr(line_begin, line_end - line_begin);
+                line_begin             = line_end + 1;
+
+                if (line.find_first_not_of(" \t\r") == std::string::npos)
+                {
+                    continue;
+                }
+
+                handler.Handle(line, reply);
+            }
+            buffer.erase(0, line_begin);
+
+            // The rest is an incomplete line, which should not grow without bound
+            if (buffer.size() > max_line_length)
+            {
+                WriteError(*connection, "The request line is too long.");
+                return;
+            }
+        }
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " <socket_path> [num_threads] [eviction_directory_path] [max_num_resident_sessions]"
+                  << " [snapshot_directory_path]" << std::endl;
+        return 1;
+    }
+
+    const std::string socket_path               = argv[1];
+    const int         num_threads               = argc > 2 ? std::atoi(argv[2]) : 0;
+    const std::string eviction_directory_path   = argc > 3 ? argv[3] : "";
+    const int         max_num_resident_sessions = argc > 4 ? std::atoi(argv[4]) : 0;
+    const std::string snapshot_directory_path   = argc > 5 ? argv[5] : "";
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path))
+    {
+        std::cerr << "The socket path is too long." << std::endl;
+        return 1;
+    }
+    socket_path.copy(address.sun_path, socket_path.size());
+    socket_path.copy(socket_path_to_remove, socket_path.size());
+
+    const int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0)
+    {
+        std::cerr << "Failed to create a socket." << std::endl;
+        return 1;
+    }
+
+    // Remove the socket file left by a previous run
+    unlink(socket_path.c_str());
+
+    if (bind(listen_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listen_fd, SOMAXCONN) != 0)
+    {
+        std::cerr << "Failed to listen on " << socket_path << "." << std::endl;
+        close(listen_fd);
+        return 1;
+    }
+
+    // Writing to a disconnected client should not terminate the server
+    std::signal(SIGPIPE, SIG_IGN);
+
+    // The socket file would prevent the next run from binding if it were left
+    std::signal(SIGINT, HandleTerminationSignal);
+    std::signal(SIGTERM, HandleTerminationSignal);
+
+    SessionManager session_manager(num_threads, 0, max_num_resident_sessions, eviction_directory_path);
+
+    // Requests other than feedback are light, but they are kept off the session workers so that reading the sliders
+    // is never blocked by the updates
+    ThreadPool request_thread_pool(num_threads);
+
+    RequestHandler handler(session_manager, request_thread_pool, snapshot_directory_path);
+
+    std::cout << "Listening on " << socket_path << "." << std::endl;
+
+    std::atomic<int> num_connections(0);
+
+    while (true)
+    {
+        const int fd = accept(listen_fd, nullptr, nullptr);
+        if (fd < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM)
+            {
+                // Out of descriptors or memory; wait for some connections to be closed instead of spinning
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                continue;
+            }
+
+            // The detached connection threads still refer to the handler, so the locals are not destroyed
+            std::cerr << "Failed to accept a connection: " << std::strerror(errno) << std::endl;
+            unlink(socket_path.c_str());
+            std::exit(1);
+        }
+
+        const auto connection = std::make_shared<Connection>(fd);
+
+        // Each connection occupies a thread, so their number is capped
+        if (num_connections >= max_num_connections)
+        {
+            WriteError(*connection, "Too many connections.");
+            continue;
+        }
+        ++num_connections;
+
+        std::thread(
+            [connection, &handler, &num_connections]()
+            {
+                ServeConnection(connection, handler);
+                --num_connections;
+            })
+            .detach();
+    }
+}
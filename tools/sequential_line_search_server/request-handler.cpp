@@ -0,0 +1,263 @@
+#include "request-handler.hpp"
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <sequential-line-search/sequential-line-search.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using sequential_line_search::SequentialLineSearchOptimizer;
+using sequential_line_search::SessionId;
+using sequential_line_search::SessionManager;
+
+namespace
+{
+    /// \brief The maximum number of dimensions of a session, which bounds the memory that a request can allocate.
+    constexpr int max_num_dims = 1000;
+
+    bool GetBoolOr(const json::Value& params, const std::string& key, const bool default_value)
+    {
+        return params.HasMember(key) ? params.GetMember(key).GetBool() : default_value;
+    }
+
+    /// \brief Get an integer in [min_value, max_value]. The number is checked before the cast, since casting a
+    /// non-finite or out-of-range number is undefined.
+    int GetInt(const json::Value& params,
+               const std::string& key,
+               const int          min_value = std::numeric_limits<int>::min(),
+               const int          max_value = std::numeric_limits<int>::max())
+    {
+        const double value = params.GetMember(key).GetNumber();
+        if (!(value >= min_value && value <= max_value) || value != std::floor(value))
+        {
+            throw std::runtime_error(key + " must be an integer in [" + std::to_string(min_value) + ", " +
+                                     std::to_string(max_value) + "].");
+        }
+        return static_cast<int>(value);
+    }
+
+    int GetIntOr(const json::Value& params, const std::string& key, const int default_value)
+    {
+        return params.HasMember(key) ? GetInt(params, key) : default_value;
+    }
+
+    SessionId GetSessionId(const json::Value& params)
+    {
+        // The IDs are sent as JSON numbers, which represent the integers up to 2^53 exactly
+        constexpr double max_session_id = 9007199254740992.0;
+
+        const double value = params.GetMember("session").GetNumber();
+        if (!(value >= 0.0 && value <= max_session_id) || value != std::floor(value))
+        {
+            throw std::runtime_error("session must be a non-negative integer.");
+        }
+        return static_cast<SessionId>(value);
+    }
+
+    json::Value MakeSliderResult(const SequentialLineSearchOptimizer& optimizer)
+    {
+        const auto slider_ends = optimizer.GetSliderEnds();
+
+        json::Value result = json::Value::MakeObject();
+        result.SetMember("end_0", json::Value::MakeArray(slider_ends.first));
+        result.SetMember("end_1", json::Value::MakeArray(slider_ends.second));
+        return result;
+    }
+
+    std::string MakeResponse(const json::Value& id, const json::Value& result)
+    {
+        json::Value response = json::Value::MakeObject();
+        response.SetMember("id", id);
+        response.SetMember("result", result);
+        return response.Serialize();
+    }
+
+    std::string MakeErrorResponse(const json::Value& id, const std::string& message)
+    {
+        json::Value response = json::Value::MakeObject();
+        response.SetMember("id", id);
+        response.SetMember("error", message);
+        return response.Serialize();
+    }
+} // namespace
+
+void RequestHandler::Handle(const std::string& line, const std::function<void(const std::string&)>& reply)
+{
+    json::Value id;
+    try
+    {
+        const json::Value request = json::Value::Parse(line);
+
+        id = request.HasMember("id") ? request.GetMember("id") : json::Value();
+
+        const std::string method = request.GetMember("method").GetString();
+        const json::Value params =
+            request.HasMember("params") ? request.GetMember("params") : json::Value::MakeObject();
+
+        if (method != "submit_feedback")
+        {
+            const auto task = [this, id, method, params, reply]()
+            {
+                try
+                {
+                    reply(MakeResponse(id, HandleImmediately(method, params)));
+                }
+                catch (const std::exception& exception)
+                {
+                    reply(MakeErrorResponse(id, exception.what()));
+                }
+            };
+
+            m_request_thread_pool.Submit(task);
+            return;
+        }
+
+        // The response is sent by the worker when the update finishes, so that no thread is occupied for waiting
+        const SessionId session_id      = GetSessionId(params);
+        const double    slider_position = params.GetMember("slider_position").GetNumber();
+
+        const auto deadline = params.HasMember("deadline_ms")
+                                  ? SessionManager::Clock::now() +
+                                        std::chrono::milliseconds(GetIntOr(params, "deadline_ms", 0))
+                                  : SessionManager::Clock::time_point::max();
+
+        // The session cannot be evicted until the callback returns, as it still has the running job
+        SessionManager& session_manager = m_session_manager;
+
+        const auto on_completed = [id, session_id, reply, &session_manager](const std::shared_future<void>& future)
+        {
+            try
+            {
+                future.get();
+
+                reply(MakeResponse(id, MakeSliderResult(*session_manager.GetOptimizer(session_id))));
+            }
+            catch (const std::exception& exception)
+            {
+                reply(MakeErrorResponse(id, exception.what()));
+            }
+        };
+
+        m_session_manager.SubmitFeedbackData(session_id, slider_position, deadline, on_completed);
+    }
+    catch (const std::exception& exception)
+    {
+        reply(MakeErrorResponse(id, exception.what()));
+    }
+}
+
+json::Value RequestHandler::HandleImmediately(const std::string& method, const json::Value& params)
+{
+    json::Value result = json::Value::MakeObject();
+
+    if (method == "create")
+    {
+        const int num_dims = GetInt(params, "num_dims", 1, max_num_dims);
+
+        const auto optimizer =
+            std::make_shared<SequentialLineSearchOptimizer>(num_dims,
+                                                            GetBoolOr(params, "use_slider_enlargement", true),
+                                                            GetBoolOr(params, "use_map_hyperparams", true));
+
+        const SessionId session_id = m_session_manager.AddSession(optimizer, GetIntOr(params, "priority", 0));
+
+        result.SetMember("session", static_cast<double>(session_id));
+    }
+    else if (method == "restore")
+    {
+        const auto optimizer = SequentialLineSearchOptimizer::Load(GetSnapshotPath(params));
+
+        const SessionId session_id = m_session_manager.AddSession(optimizer, GetIntOr(params, "priority", 0));
+
+        result.SetMember("session", static_cast<double>(session_id));
+    }
+    else if (method == "close")
+    {
+        m_session_manager.RemoveSession(GetSessionId(params));
+    }
+    else if (method == "get_slider")
+    {
+        result = MakeSliderResult(*m_session_manager.GetOptimizer(GetSessionId(params)));
+    }
+    else if (method == "predict_batch")
+    {
+        const auto optimizer = m_session_manager.GetOptimizer(GetSessionId(params));
+        const int  num_dims  = static_cast<int>(optimizer->GetMaximizer().size());
+
+        const std::vector<json::Value>& points = params.GetMember("points").GetArray();
+
+        Eigen::MatrixXd X(num_dims, points.size());
+        for (std::size_t i = 0; i < points.size(); ++i)
+        {
+            const Eigen::VectorXd x = points[i].GetVector();
+            if (x.size() != num_dims)
+            {
+                throw std::runtime_error("Each point must have " + std::to_string(num_dims) + " elements.");
+            }
+            X.col(i) = x;
+        }
+
+        // The points are predicted at once, which shares the work that does not depend on the points
+        Eigen::VectorXd mu;
+        Eigen::VectorXd sigma;
+        if (!points.empty())
+        {
+            optimizer->PredictPreferenceValues(X, &mu, &sigma);
+        }
+
+        json::Value means  = json::Value::MakeArray();
+        json::Value stdevs = json::Value::MakeArray();
+        for (std::size_t i = 0; i < points.size(); ++i)
+        {
+            means.PushBack(mu(i));
+            stdevs.PushBack(sigma(i));
+        }
+
+        result.SetMember("mean", means);
+        result.SetMember("stdev", stdevs);
+    }
+    else if (method == "get_maximizer")
+    {
+        const auto optimizer = m_session_manager.GetOptimizer(GetSessionId(params));
+
+        result.SetMember("maximizer", json::Value::MakeArray(optimizer->GetMaximizer()));
+    }
+    else if (method == "snapshot")
+    {
+        m_session_manager.SaveSession(GetSessionId(params), GetSnapshotPath(params));
+    }
+    else
+    {
+        throw std::runtime_error("Unknown method: " + method + ".");
+    }
+
+    return result;
+}
+
+std::string RequestHandler::GetSnapshotPath(const json::Value& params) const
+{
+    if (m_snapshot_directory_path.empty())
+    {
+        throw std::runtime_error("Snapshots are disabled since no snapshot directory is given.");
+    }
+
+    const std::string file_path = params.GetMember("file_path").GetString();
+    if (file_path.empty() || file_path.front() == '/' || file_path.find('\0') != std::string::npos)
+    {
+        throw std::runtime_error("file_path must be a non-empty path relative to the snapshot directory.");
+    }
+
+    std::istringstream stream(file_path);
+    std::string        component;
+    while (std::getline(stream, component, '/'))
+    {
+        if (component == "..")
+        {
+            throw std::runtime_error("file_path must not contain \"..\".");
+        }
+    }
+
+    return m_snapshot_directory_path + "/" + file_path;
+}
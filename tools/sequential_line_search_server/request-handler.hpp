@@ -0,0 +1,65 @@
+#ifndef REQUEST_HANDLER_HPP
+#define REQUEST_HANDLER_HPP
+
+#include "json.hpp"
+#include <functional>
+#include <sequential-line-search/session-manager.hpp>
+#include <sequential-line-search/thread-pool.hpp>
+#include <string>
+
+/// \brief Handler of the requests of the line-delimited JSON protocol.
+///
+/// \details A request is a single-line JSON object with the members "id" (any value, echoed back in the response),
+/// "method", and "params" (an object; can be omitted if the method takes no parameters). A response is a single-line
+/// JSON object with "id" and either "result" or "error" (a message). The methods are:
+///
+/// - "create" {num_dims, use_slider_enlargement?, use_map_hyperparams?, priority?} -> {session}
+/// - "restore" {file_path, priority?} -> {session}
+/// - "close" {session} -> {}
+/// - "get_slider" {session} -> {end_0, end_1}
+/// - "submit_feedback" {session, slider_position, deadline_ms?} -> {end_0, end_1} (the next slider; the response is
+///   sent when the update finishes)
+/// - "predict_batch" {session, points} -> {mean, stdev}
+/// - "get_maximizer" {session} -> {maximizer}
+/// - "snapshot" {session, file_path} -> {}
+///
+/// The `file_path` of "restore" and "snapshot" is relative to the snapshot directory of the handler; absolute paths and
+/// paths containing ".." are rejected, and both methods are disabled if no snapshot directory is given. The integer
+/// parameters (e.g., `session` and `num_dims`, which is at most 1000) are rejected unless they are integers in range.
+class RequestHandler
+{
+public:
+    /// \param request_thread_pool The pool on which the requests other than "submit_feedback" are handled.
+    /// \param snapshot_directory_path The directory that the snapshot files are read from and written to. If empty,
+    /// "restore" and "snapshot" are disabled.
+    RequestHandler(sequential_line_search::SessionManager& session_manager,
+                   sequential_line_search::ThreadPool&     request_thread_pool,
+                   const std::string&                      snapshot_directory_path = "")
+        : m_session_manager(session_manager),
+          m_request_thread_pool(request_thread_pool),
+          m_snapshot_directory_path(snapshot_directory_path)
+    {
+    }
+
+    /// \brief Handle a request line and send the response line by `reply`.
+    ///
+    /// \details This does not block; the response is sent by `reply` on another thread (a worker of either the
+    /// session manager or the request pool), possibly after this returns. Feedback is queued to the session before
+    /// this returns, so the feedback of a session is applied in the order of the calls. This never throws; errors are
+    /// reported as responses.
+    void Handle(const std::string& line, const std::function<void(const std::string&)>& reply);
+
+private:
+    sequential_line_search::SessionManager& m_session_manager;
+    sequential_line_search::ThreadPool&     m_request_thread_pool;
+    const std::string                       m_snapshot_directory_path;
+
+    /// \brief Handle a request whose response is available immediately.
+    json::Value HandleImmediately(const std::string& method, const json::Value& params);
+
+    /// \brief Resolve the `file_path` of a request in the snapshot directory. Throws `std::runtime_error` if the path
+    /// could point outside the directory.
+    std::string GetSnapshotPath(const json::Value& params) const;
+};
+
+#endif // REQUEST_HANDLER_HPP